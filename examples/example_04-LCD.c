@@ -83,7 +83,7 @@ int main(void) {
     // 1. testovaci sekvence znaku - ZACATEK
     for (int x = 0; x < 2; x++) {
       for (int i = 0; i < LCD_ROWS; i++) {
-        LCD_set(i ? LCD_LINE2 : LCD_LINE1);
+        LCD_goto(0, i + 1);
 
         for (int j = 0; j < LCD_COLS; j++) {
             LCD_symbol((i%2)^x ? '0' : 'H'); // Otoc a invertuj znaky na lince
@@ -98,7 +98,7 @@ int main(void) {
 
     // 2. testovaci sekvence znaku - ZACATEK
     for (int i = 0; i < LCD_ROWS; i++) {
-      LCD_set(i ? LCD_LINE2 : LCD_LINE1);
+      LCD_goto(0, i + 1);
 
       for (int j = 0; j < LCD_COLS; j++) {
         LCD_symbol('#');
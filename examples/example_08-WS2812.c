@@ -0,0 +1,82 @@
+/**
+  ******************************************************************************
+  * @file     STM32_00_HelloWorld_08-WS2812.c
+  * @author   SPSE Havirov
+  * @version  1.0
+  * @date     19-October-2026
+  * @brief    Duha na pasku 300 LED WS2812 (vystup PB6) a mereni snimkove frekvence.
+  *             Na LCD se zobrazuje namereny pocet snimku za sekundu a teoreticke
+  *             maximum dane dobou prenosu (WS2812_frame_us()).
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Netestovano: F407, F401, F411, G071
+  *
+  * Pasek napajet samostatne, datovy vodic pres rezistor 330R, spolecna zem.
+  *
+  ******************************************************************************
+*/
+#define WS2812_LEDS  300                      // Pred stm32_kit.h (prepise vychozi hodnotu z config.h)
+
+#include "stm32_kit.h"                        // Pripojeni globalniho konfiguracniho souboru pro praci s pripravkem.
+#include "stm32_kit/lcd.h"
+#include "stm32_kit/ws2812.h"
+
+#define TICKS_PER_S 10000                     // SysTick 0.1 ms
+
+static int strip_ready;                       // WS2812_setup() ziskal kanal DMA
+
+BOARD_SETUP void setup(void) {
+  SystemCoreClockUpdate();                    // Do SystemCoreClock se nahraje frekvence jadra.
+  SysTick_Config(SystemCoreClock / TICKS_PER_S);
+  LCD_setup();
+  strip_ready = WS2812_setup();
+}
+
+/**
+ * @brief  Barva na kruhu duhy (0 - 255), jas omezen na 1/4 kvuli odberu.
+ *
+ */
+static void wheel(uint16_t index, uint8_t pos) {
+  const uint8_t third = pos % 85;
+  const uint8_t up = third * 3 / 4, down = (84 - third) * 3 / 4;
+
+  if (pos < 85)       WS2812_set(index, down, up, 0);
+  else if (pos < 170) WS2812_set(index, 0, down, up);
+  else                WS2812_set(index, up, 0, down);
+}
+
+int main(void) {
+  uint8_t shift = 0;
+  uint32_t frames = 0;
+  uint32_t start = Ticks;
+
+  if (!strip_ready) {                         // Stream DMA obsazen jinym ovladacem
+    LCD_set(LCD_LINE1);
+    LCD_print("DMA obsazeno");
+    while (1) {}
+  }
+
+  LCD_set(LCD_LINE1);
+  LCD_print("max ");
+  LCD_print_int(1000000 / WS2812_frame_us(), 4);
+
+  while (1) {
+    while (WS2812_busy()) {}                  // Predchozi snimek se koduje z bufferu barev
+    for (uint16_t i = 0; i < WS2812_LEDS; i++) {
+      wheel(i, (uint8_t)(i + shift));
+    }
+    WS2812_show();
+    shift++;
+    frames++;
+
+    if (Ticks - start >= TICKS_PER_S) {
+      LCD_set(LCD_LINE2);
+      LCD_print("fps ");
+      LCD_print_int(frames, 4);
+      frames = 0;
+      start += TICKS_PER_S;
+    }
+  }
+}
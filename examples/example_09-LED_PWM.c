@@ -0,0 +1,48 @@
+/**
+  ******************************************************************************
+  * @file     STM32_00_HelloWorld_09-LED_PWM.c
+  * @author   SPSE Havirov
+  * @version  1.0
+  * @date     19-October-2026
+  * @brief    Jas a efekty LED bez blokujicich smycek v main (led_pwm.h).
+  *             Vestavene LED: staly jas, dychani, blikani a prechod,
+  *             tlacitko prepina jas externich LED.
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Netestovano: F407, F401, F411, G071
+  *
+  ******************************************************************************
+*/
+#include "stm32_kit.h"                        // Pripojeni globalniho konfiguracniho souboru pro praci s pripravkem.
+#include "stm32_kit/button.h"
+#include "stm32_kit/led_pwm.h"
+
+BOARD_SETUP void setup(void) {
+  SystemCoreClockUpdate();                    // Do SystemCoreClock se nahraje frekvence jadra.
+  SysTick_Config(SystemCoreClock / 10000);    // Konfigurace SysTick timeru.
+  BTN_setup();
+  LED_pwm_setup();
+}
+
+int main(void) {
+  uint8_t level = 0;
+  const int idle = io_read(USER_BUTTON);      // Klidovy stav (F407 log. 0, Nucleo log. 1)
+
+  LED_pwm(LED_PWM_IN_0, 32);                  // Slaby staly svit
+  LED_breathe(LED_PWM_IN_1, 3000, 255);
+  LED_blink(LED_PWM_IN_2, 50, 950, 255);      // Kratky zablesk jednou za sekundu
+  LED_fade(LED_PWM_IN_3, 255, 2000);
+
+  while (1) {
+    if (io_read(USER_BUTTON) != idle) {
+      level += 64;
+      for (int i = LED_PWM_EX_0; i <= LED_PWM_EX_3; i++) {
+        LED_fade((enum led_pwm)i, level, 300);
+      }
+      while (io_read(USER_BUTTON) != idle) {}
+      delay_ms(20);                           // Zakmity tlacitka
+    }
+  }
+}
@@ -0,0 +1,70 @@
+/**
+  ******************************************************************************
+  * @file     STM32_00_HelloWorld_10-SPI.c
+  * @author   SPSE Havirov
+  * @version  1.0
+  * @date     19-October-2026
+  * @brief    Mereni propustnosti SPI (DMA, fronta transakci) se smyckou MOSI -> MISO.
+  *             Dva buffery po BLOCK bajtech se stridave posilaji plnym duplexem,
+  *             prijata data se porovnavaji s odeslanymi. Na LCD se zobrazuje
+  *             namereny pocet kB za sekundu a pocet chyb.
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Netestovano: F407, F401, F411, G071
+  *
+  * Propojit PB5 (MOSI) a PB4 (MISO). Na PB3 (SCK) lze merit osciloskopem.
+  *
+  ******************************************************************************
+*/
+#include "stm32_kit.h"                        // Pripojeni globalniho konfiguracniho souboru pro praci s pripravkem.
+#include "stm32_kit/lcd.h"
+#include "stm32_kit/spi.h"
+
+#define TICKS_PER_S 10000                     // SysTick 0.1 ms
+#define BLOCK       1024                      // Velikost jedne transakce
+
+static uint8_t tx[2][BLOCK], rx[2][BLOCK];
+static spi_xfer_t xfer[2];
+static uint32_t errors;
+
+BOARD_SETUP void setup(void) {
+  SystemCoreClockUpdate();                    // Do SystemCoreClock se nahraje frekvence jadra.
+  SysTick_Config(SystemCoreClock / TICKS_PER_S);
+  LCD_setup();
+  SPI_setup(SystemCoreClock / 2, SPI_MODE0);  // Nejvyssi mozna rychlost
+}
+
+/**
+ * @brief  Kontrola prijatych dat a okamzite zarazeni dalsiho prenosu (z preruseni DMA).
+ *
+ */
+static void done(spi_xfer_t *x) {
+  if (x->status != SPI_DONE || memcmp(x->tx, x->rx, x->len)) errors++;
+  SPI_submit(x);
+}
+
+int main(void) {
+  uint32_t start = Ticks, bytes = SPI_bytes();
+
+  for (int b = 0; b < 2; b++) {
+    for (int i = 0; i < BLOCK; i++) tx[b][i] = (uint8_t)(i * 7 + b);
+    xfer[b] = (spi_xfer_t){ .cs = NC, .tx = tx[b], .rx = rx[b], .len = BLOCK, .done = done };
+    SPI_submit(&xfer[b]);                     // Dve transakce ve fronte: DMA nema prestavku
+  }
+
+  while (1) {
+    if (Ticks - start >= TICKS_PER_S) {
+      const uint32_t now = SPI_bytes();
+      LCD_set(LCD_LINE1);
+      LCD_print_int((now - bytes) / 1000, 5);
+      LCD_print("kB");
+      LCD_set(LCD_LINE2);
+      LCD_print("err ");
+      LCD_print_int(errors, 4);
+      bytes = now;
+      start += TICKS_PER_S;
+    }
+  }
+}
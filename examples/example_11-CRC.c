@@ -0,0 +1,92 @@
+/**
+  ******************************************************************************
+  * @file     STM32_00_HelloWorld_11-CRC.c
+  * @author   SPSE Havirov
+  * @version  1.0
+  * @date     19-October-2026
+  * @brief    Mereni rychlosti vypoctu CRC-32 v bajtech na takt jadra.
+  *             Postupne se meri softwarovy vypocet (slicing-by-4), jednotka CRC
+  *             plnena CPU a (G0) jednotka CRC plnena DMA. Na LCD se kazdou sekundu
+  *             zobrazi dalsi cesta: nazev a pocet bajtu na takt. Pri neshode
+  *             vysledku cest se zobrazi "ERR".
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Netestovano: F407, F401, F411, G071
+  *
+  ******************************************************************************
+*/
+#include "stm32_kit.h"                        // Pripojeni globalniho konfiguracniho souboru pro praci s pripravkem.
+#include "stm32_kit/lcd.h"
+#include "stm32_kit/crc.h"
+
+#define TICKS_PER_S 10000                     // SysTick 0.1 ms
+#define BLOCK       4096                      // Velikost dat pro jeden vypocet
+#define MEASURE     1000                      // Doba mereni jedne cesty v tickach (0.1 s)
+
+static uint8_t data[BLOCK];
+
+BOARD_SETUP void setup(void) {
+  SystemCoreClockUpdate();                    // Do SystemCoreClock se nahraje frekvence jadra.
+  SysTick_Config(SystemCoreClock / TICKS_PER_S);
+  LCD_setup();
+  crc32_setup();
+}
+
+/**
+ * @brief  Opakovany vypocet po dobu MEASURE.
+ *
+ * @param  path 0 = software, 1 = jednotka CRC (CPU), 2 = jednotka CRC (DMA).
+ * @param  crc  Vysledek jednoho vypoctu (pro porovnani cest).
+ *
+ * @return Bajty na takt jadra x 1000.
+ */
+static uint32_t measure(int path, uint32_t *crc) {
+  uint32_t bytes = 0;
+  const uint32_t start = Ticks;
+
+  while (Ticks - start < MEASURE) {
+    if (path == 0) {
+      *crc = crc32_sw(0, data, BLOCK);
+    } else if (path == 1) {
+      *crc = crc32(0, data, BLOCK);
+#if CRC_DMA
+    } else {
+      crc32_start(0, data, BLOCK);
+      crc32_wait(crc);
+#endif
+    }
+    bytes += BLOCK;
+  }
+
+  const uint64_t cycles = (uint64_t)(Ticks - start) * (SystemCoreClock / TICKS_PER_S);
+  return (uint32_t)((uint64_t)bytes * 1000 / cycles);
+}
+
+int main(void) {
+  static const char *const names[] = { "SW", "HW", "DMA" };
+#if CRC_DMA
+  const int paths = 3;
+#elif CRC_HW
+  const int paths = 2;
+#else
+  const int paths = 1;
+#endif
+  uint32_t reference = 0;
+
+  for (int i = 0; i < BLOCK; i++) data[i] = (uint8_t)(i * 131 + 7);
+
+  for (int path = 0; ; path = (path + 1) % paths) {
+    uint32_t crc = 0;
+    const uint32_t rate = measure(path, &crc);
+    if (path == 0) reference = crc;
+
+    LCD_set(LCD_CLR);
+    LCD_print(names[path]);
+    if (crc != reference) LCD_print(" ERR");
+    LCD_set(LCD_LINE2);
+    LCD_print_fixed(rate, 3, 0);              // Bajty na takt
+    delay_ms(900);                            // Kazda cesta 1 s na displeji
+  }
+}
@@ -0,0 +1,78 @@
+/**
+  ******************************************************************************
+  * @file     STM32_00_HelloWorld_12-packet.c
+  * @author   SPSE Havirov
+  * @version  1.0
+  * @date     19-October-2026
+  * @brief    Binarni telemetrie pres UART (packet.h).
+  *             Kazde 2 ms se odesle paket se vzorkem (cas, citac, hodnota),
+  *             prijate pakety se posilaji zpet (ping z PC). Na LCD je pocet
+  *             prijatych paketu a chyb.
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Netestovano: F407
+  *
+  * UART2: PA2 (TX), PA3 (RX), 115200 Bd. Prijem na PC (pyserial, cobs):
+  *   raw = port.read_until(b"\0"); frame = cobs.decode(raw[:-1])
+  *   tick, counter, value = struct.unpack("<IIh", frame[:-4])
+  *
+  ******************************************************************************
+*/
+#ifndef UART_BAUD
+# define UART_BAUD 115200
+#endif
+#define UART_DMA 1                            // Kruhove buffery s DMA (packet.h)
+
+#include "stm32_kit.h"                        // Pripojeni globalniho konfiguracniho souboru pro praci s pripravkem.
+#include "stm32_kit/lcd.h"
+#include "stm32_kit/packet.h"
+
+#define PERIOD       20                       // Perioda vzorku v tickach SysTick (2 ms, 8 kB/s z 11.5 kB/s)
+
+/**
+ * @brief Vzorek telemetrie (10 bajtu + 6 bajtu ramce, textem "1234567 12345 -1234\r\n" 21 bajtu).
+ */
+typedef struct __attribute__((packed)) {
+  uint32_t tick;
+  uint32_t counter;
+  int16_t  value;
+} sample_t;
+
+BOARD_SETUP void setup(void) {
+  SystemCoreClockUpdate();                    // Do SystemCoreClock se nahraje frekvence jadra.
+  SysTick_Config(SystemCoreClock / 10000);    // Konfigurace SysTick timeru.
+  LCD_setup();
+  UART_setup();
+  UART_dma_setup();
+}
+
+int main(void) {
+  sample_t sample = { 0, 0, 0 };
+  uint32_t last = Ticks, shown = 0;
+
+  while (1) {
+    if (Ticks - last >= PERIOD) {
+      last += PERIOD;
+      sample.tick = Ticks;
+      sample.counter++;
+      sample.value = (int16_t)((sample.counter * 37) % 2001 - 1000);
+      PKT_send(&sample, sizeof(sample));
+    }
+
+    uint16_t len;
+    const uint8_t *data = PKT_receive(&len);
+    if (data) {
+      PKT_send(data, len);                    // Ping: stejna data zpet
+    }
+
+    if (Ticks - shown >= 5000) {              // Kazdych 0.5 s
+      shown = Ticks;
+      LCD_set(LCD_LINE1);
+      LCD_print_int(PKT_stats.frames, 8);
+      LCD_set(LCD_LINE2);
+      LCD_print_int(PKT_stats.crc + PKT_stats.format + PKT_stats.overrun, 8);
+    }
+  }
+}
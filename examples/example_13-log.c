@@ -0,0 +1,112 @@
+/**
+  ******************************************************************************
+  * @file     STM32_00_HelloWorld_13-log.c
+  * @author   SPSE Havirov
+  * @version  1.0
+  * @date     19-October-2026
+  * @brief    Binarni log s odlozenym formatovanim (log.h).
+  *             Preruseni TIM7 (F401/F411: TIM5) zapisuje kazdou 1 ms zaznam s merenim,
+  *             hlavni smycka zaznamenava stisky tlacitka a kazdou sekundu souhrn. Zaznamy odesila
+  *             LOG_drain() pres UART, text sestavi az PC. Na LCD je pocet zaznamu
+  *             a doba jednoho LOG() v taktech jadra.
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Netestovano: F407
+  *
+  * UART2: PA2 (TX), PA3 (RX), 115200 Bd. Vypis na PC (soubor .axf z adresare Objects):
+  *   python3 tools/log_decode.py STM32_00_HelloWorld.axf --port COM3
+  *
+  ******************************************************************************
+*/
+#ifndef UART_BAUD
+# define UART_BAUD 115200
+#endif
+#define UART_DMA 1                            // Kruhove buffery s DMA (packet.h)
+
+#include "stm32_kit.h"                        // Pripojeni globalniho konfiguracniho souboru pro praci s pripravkem.
+#include "stm32_kit/lcd.h"
+#include "stm32_kit/button.h"
+#include "stm32_kit/timers.h"
+#include "stm32_kit/log.h"
+
+#define TICKS_PER_S 10000                     // SysTick 0.1 ms
+#define BURST       32                        // Pocet LOG() pri mereni doby zapisu
+
+static volatile uint32_t samples;
+
+/**
+ * @brief  Periodicke preruseni 1 kHz - zaznam primo z preruseni.
+ *
+ */
+void TIM7_IRQ_HANDLER(void) {
+  TIM7_TIM->SR &= ~(TIM_SR_UIF);
+  samples++;
+  if ((samples % 100) == 0) {                 // 10 zaznamu/s, 12 B na zaznam
+    LOG("vzorek %u, hodnota %d", samples, (int)(samples * 37 % 2001) - 1000);
+  }
+}
+
+BOARD_SETUP void setup(void) {
+  SystemCoreClockUpdate();                    // Do SystemCoreClock se nahraje frekvence jadra.
+  SysTick_Config(SystemCoreClock / TICKS_PER_S);
+  LCD_setup();
+  BTN_setup();
+  UART_setup();
+  UART_dma_setup();
+  TIM7_setup(1000);
+  TIM7_TIM->CR1 |= TIM_CR1_CEN;
+}
+
+/**
+ * @brief  Doba jednoho LOG() v taktech jadra (odecet SysTick->VAL v ramci jednoho ticku).
+ *
+ */
+static uint32_t measure(void) {
+  uint32_t start, end, tick;
+
+  do {                                        // Mereni nesmi prejit pres preteceni SysTick
+    LOG_drain();
+    tick = Ticks;
+    start = SysTick->VAL;
+    for (int i = 0; i < BURST; i++) {
+      LOG("mereni %d", i);
+    }
+    end = SysTick->VAL;
+  } while (Ticks != tick || end > start);
+
+  return (start - end) / BURST;
+}
+
+int main(void) {
+  uint32_t last = Ticks, pressed = 0, loops = 0;
+
+  LOG("start, jadro %u Hz, buffer %u slov", SystemCoreClock, LOG_RING);
+  const uint32_t cycles = measure();
+  LOG("LOG() s 1 argumentem: %u taktu", cycles);
+
+  while (1) {
+    loops++;
+
+    const uint32_t button = io_read(USER_BUTTON);
+    if (button && !pressed) {
+      LOG("tlacitko stisknuto v case %u ms", Ticks / 10);
+    }
+    pressed = button;
+
+    if (Ticks - last >= TICKS_PER_S) {
+      last += TICKS_PER_S;
+      LOG("souhrn: %u smycek/s (%.3f us), zahozeno %u", loops, 1e6f / loops, LOG_dropped);
+      loops = 0;
+
+      LCD_set(LCD_CLR);
+      LCD_print_int(samples / 100, 8);
+      LCD_set(LCD_LINE2);
+      LCD_print_int(cycles, 4);
+      LCD_print(" tak/LOG");
+    }
+
+    LOG_drain();                              // Odeslani na pozadi (DMA), neblokuje
+  }
+}
@@ -0,0 +1,48 @@
+/**
+  ******************************************************************************
+  * @file     sim_01-LCD.c
+  * @author   SPSE Havirov
+  * @version  1.0
+  * @date     19-October-2026
+  * @brief    Simulace LCD (HD44780) na PC - kontrola casovani ovladace lcd.h.
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Preklad a spusteni na PC (z korene repozitare):
+  *   gcc -std=gnu11 -Istm32/sim -Istm32/include -Istm32/config -Istm32/boards \
+  *       examples/sim_01-LCD.c -o sim_lcd && ./sim_lcd
+  *
+  * Pro asynchronni vystup pridat -DLCD_ASYNC=1, pro jiny displej
+  * -DLCD_COLS=16 -DLCD_ROWS=2 apod.
+  *
+  * Program vraci 1, pokud model zaznamenal poruseni casovani.
+  *
+  ******************************************************************************
+*/
+#include "stm32_kit.h"                        // Pripojeni globalniho konfiguracniho souboru pro praci s pripravkem.
+#include "stm32_kit/lcd.h"                    // Pripojeni konfiguracniho souboru pro praci s LCD.
+
+#include "hd44780.h"                          // Model radice LCD (pouze simulace).
+
+static hd44780_t display;
+
+int main(void) {
+  hd44780_attach(&display, LCD_RS, LCD_RW, LCD_EN, LCD_DB4, LCD_DB5, LCD_DB6, LCD_DB7, LCD_COLS, LCD_ROWS);
+  display.verbose = 1;                        // Kazde poruseni casovani vypsat hned
+
+  SystemCoreClockUpdate();                    // Do SystemCoreClock se nahraje frekvence jadra.
+  SysTick_Config(SystemCoreClock / 10000);    // Konfigurace SysTick timeru.
+  LCD_setup();                                // Pocatecni inicializace LCD.
+
+  LCD_print("Hello...");
+  LCD_goto(0, 2);
+  LCD_print_int(-1234, 0);
+
+#if LCD_ASYNC
+  LCD_flush();                                // Pockat na odeslani fronty
+#endif
+
+  hd44780_print(&display, stdout);
+  return hd44780_report(&display, stdout) != 0;
+}
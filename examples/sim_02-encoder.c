@@ -0,0 +1,97 @@
+/**
+  ******************************************************************************
+  * @file     sim_02-encoder.c
+  * @author   SPSE Havirov
+  * @version  1.0
+  * @date     19-October-2026
+  * @brief    Simulace kvadraturniho enkoderu na PC - kontrola ovladace encoder.h
+  *             (zmeny smeru, preteceni a podteceni 16bit citace, rychlost).
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Preklad a spusteni na PC (z korene repozitare):
+  *   gcc -std=gnu11 -Istm32/sim -Istm32/include -Istm32/config -Istm32/boards \
+  *       examples/sim_02-encoder.c -o sim_encoder && ./sim_encoder
+  *
+  * Pro rezim x2 pridat -DENC_MODE=1, pro obraceny smer -DENC_INVERT=1.
+  *
+  * Program vraci 1, pokud nektera kontrola selhala.
+  *
+  ******************************************************************************
+*/
+#include "stm32_kit.h"                        // Pripojeni globalniho konfiguracniho souboru pro praci s pripravkem.
+#include "stm32_kit/encoder.h"
+
+#include "quadrature.h"                       // Model enkoderu (pouze simulace).
+
+#ifndef ENC_TIM_IRQ_HANDLER
+# define ENC_TIM_IRQ_HANDLER 0                // 32bit TIM2 bez preruseni
+#endif
+
+#if ENC_MODE == 3
+# define SCALE 1                              // x4: kazda hrana
+#else
+# define SCALE 2                              // x2: jen hrany jednoho kanalu
+#endif
+#if ENC_INVERT
+# define SIGN (-1)
+#else
+# define SIGN 1
+#endif
+
+static sim_quadrature_t enc;
+static int failures;
+static int32_t expected;
+
+/**
+ * @brief  Pohyb enkoderu a kontrola polohy.
+ *
+ */
+static void move(const char *name, int32_t edges, uint64_t edge_ns) {
+  sim_quadrature_step(&enc, edges, edge_ns);
+  expected += edges;
+
+  const int32_t want = SIGN * expected / SCALE;
+  const int32_t got = ENC_position();
+  const int ok = (got - want <= 1) && (want - got <= 1); // x2: zaokrouhleni na hranu kanalu
+
+  printf("%-28s %+8ld -> %11ld (ocekavano %11ld) %s\n", name, (long)edges, (long)got, (long)want, ok ? "OK" : "CHYBA");
+  if (!ok) failures++;
+}
+
+int main(void) {
+  sim_quadrature_attach(&enc, TIM_get(ENC_TIM)->tim, ENC_TIM_IRQ_HANDLER, ENC_PIN_A, ENC_PIN_B);
+  ENC_setup();
+
+  move("vpred", 100, 1000);
+  move("vzad", -250, 1000);
+  for (int i = 0; i < 500; i++) {             // Kmitani hridele kolem jedne polohy
+    sim_quadrature_step(&enc, 3, 500);
+    sim_quadrature_step(&enc, -3, 500);
+  }
+  move("kmitani", 0, 0);
+  move("preteceni nahoru", 70000, 100);
+  move("podteceni 2x", -200000, 100);
+  move("zpet nad nulu", 140000, 100);
+
+  const uint32_t cnt = ENC_tim->tim->CNT;     // Kmitani presne na hranici 16bit citace (CNT = 0xFFFF)
+  move("k hranici rozsahu", SIGN * SCALE * (int32_t)(SIGN > 0 ? 0xFFFF - cnt : cnt + 1), 100);
+  for (int i = 0; i < 200; i++) {            // Kazda zmena smeru pretece nebo podtece citac
+    sim_quadrature_step(&enc, (i & 1) ? -2 : 2, 20000);
+    expected += (i & 1) ? -2 : 2;
+  }
+  move("kmitani na hranici", 0, 0);
+
+  ENC_velocity(0);                            // Pocatek mereni rychlosti
+  sim_quadrature_step(&enc, 1000, 10000);     // 1000 hran za 10 ms
+  expected += 1000;
+  const int32_t velocity = ENC_velocity(10000);
+  const int32_t want = SIGN * 100000 / SCALE;
+  printf("%-28s %11ld (ocekavano %11ld) %s\n", "rychlost [hran/s]", (long)velocity, (long)want,
+         velocity == want ? "OK" : "CHYBA");
+  if (velocity != want) failures++;
+
+  printf("%d chyb, %lu hran\n", failures, (unsigned long)enc.edges);
+  return failures != 0;
+}
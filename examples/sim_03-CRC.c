@@ -0,0 +1,100 @@
+/**
+  ******************************************************************************
+  * @file     sim_03-CRC.c
+  * @author   SPSE Havirov
+  * @version  1.0
+  * @date     19-October-2026
+  * @brief    Kontrola softwaroveho CRC-32 (crc.h) na PC a mereni jeho rychlosti.
+  *             Slicing-by-4 se porovnava s vypoctem po bitech (kontrolni hodnota
+  *             "123456789", nezarovnana data, navazovani po castech).
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Preklad a spusteni na PC (z korene repozitare):
+  *   gcc -std=gnu11 -O2 -Istm32/sim -Istm32/include -Istm32/config -Istm32/boards \
+  *       examples/sim_03-CRC.c -o sim_crc && ./sim_crc
+  *
+  * Pro CRC-32C pridat -DCRC_POLY=0x1EDC6F41UL.
+  *
+  * Program vraci 1, pokud nektera kontrola selhala.
+  *
+  ******************************************************************************
+*/
+#include "stm32_kit.h"                        // Pripojeni globalniho konfiguracniho souboru pro praci s pripravkem.
+#include "stm32_kit/crc.h"
+
+#include <time.h>
+
+#define BLOCK  65536
+
+static uint8_t data[BLOCK + 8];
+static int failures;
+
+/**
+ * @brief  Referencni vypocet po bitech.
+ *
+ */
+static uint32_t crc_bitwise(uint32_t crc, const uint8_t *p, uint32_t len) {
+  const uint32_t poly = CRC_reflect(CRC_POLY);
+
+  crc = ~crc;
+  while (len--) {
+    crc ^= *p++;
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc & 1) ? (crc >> 1) ^ poly : crc >> 1;
+    }
+  }
+  return ~crc;
+}
+
+static void check(const char *name, uint32_t got, uint32_t want) {
+  const int ok = got == want;
+
+  printf("%-32s %08lX (ocekavano %08lX) %s\n", name, (unsigned long)got, (unsigned long)want, ok ? "OK" : "CHYBA");
+  if (!ok) failures++;
+}
+
+static double now_s(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(void) {
+  for (int i = 0; i < BLOCK + 8; i++) data[i] = (uint8_t)(i * 131 + 7);
+
+  const uint32_t check_value = crc_bitwise(0, (const uint8_t *)"123456789", 9);
+#if CRC_POLY == 0x04C11DB7UL
+  check("kontrolni hodnota CRC-32", check_value, 0xCBF43926UL);
+#elif CRC_POLY == 0x1EDC6F41UL
+  check("kontrolni hodnota CRC-32C", check_value, 0xE3069283UL);
+#endif
+  check("crc32(\"123456789\")", crc32(0, "123456789", 9), check_value);
+
+  for (int offset = 0; offset < 4; offset++) {  // Zacatek mimo zarovnani i delky mimo nasobek 4
+    for (uint32_t len = 0; len < 40; len++) {
+      if (crc32(0, data + offset, len) != crc_bitwise(0, data + offset, len)) {
+        printf("offset %d, delka %lu: CHYBA\n", offset, (unsigned long)len);
+        failures++;
+      }
+    }
+  }
+
+  uint32_t crc = 0;
+  for (uint32_t pos = 0, step = 1; pos < BLOCK; pos += step, step = step * 3 % 1001 + 1) {
+    crc = crc32(crc, data + pos, (pos + step > BLOCK) ? BLOCK - pos : step);
+  }
+  check("navazovani po castech", crc, crc_bitwise(0, data, BLOCK));
+
+  const int rounds = 2000;
+  const double start = now_s();
+  for (int i = 0; i < rounds; i++) {
+    crc = crc32_sw(crc, data, BLOCK);
+  }
+  const double elapsed = now_s() - start;
+  printf("slicing-by-4: %.0f MB/s, %.2f ns/B (CRC %08lX)\n",
+         rounds * (double)BLOCK / elapsed / 1e6, elapsed * 1e9 / (rounds * (double)BLOCK), (unsigned long)crc);
+
+  return failures != 0;
+}
@@ -0,0 +1,240 @@
+/**
+  ******************************************************************************
+  * @file     sim_04-log.c
+  * @author   SPSE Havirov
+  * @version  1.0
+  * @date     19-October-2026
+  * @brief    Kontrola binarniho logu (log.h) na PC a mereni doby jednoho LOG().
+  *             Zaznamy se ctou zpet pres LOG_read() a porovnavaji s argumenty
+  *             (cela cisla, float, ukazatele, retezce, 0 az 8 argumentu, preteceni
+  *             bufferu). Nakonec se ulozene ramce dekoduji zpet a kontroluje se
+  *             cas zaznamu, ktery nejde po sobe (zahozeni, preruseni uvnitr LOG(),
+  *             preteceni 28bit casu) - rozdil se bere se znamenkem jako v
+  *             tools/log_decode.py.
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Preklad a spusteni na PC (z korene repozitare, -no-pie: adresy retezcu
+  * musi byt 32bit a stejne jako v ELF):
+  *   gcc -std=gnu11 -O2 -no-pie -Istm32/sim -Istm32/include -Istm32/config -Istm32/boards \
+  *       examples/sim_04-log.c -o sim_log && ./sim_log log.bin
+  *
+  * Zaznamy se ulozi do log.bin (bez parametru do docasneho souboru) ve stejnych
+  * ramcich, jako je posila LOG_drain(), dekodovani stejne jako z MCU:
+  *   python3 tools/log_decode.py sim_log log.bin
+  *
+  * Program vraci 1, pokud nektera kontrola selhala.
+  *
+  ******************************************************************************
+*/
+#include "stm32_kit.h"                        // Pripojeni globalniho konfiguracniho souboru pro praci s pripravkem.
+#include "stm32_kit/crc.h"
+#include "stm32_kit/log.h"
+
+#include <string.h>
+#include <time.h>
+
+#define FRAME_WORDS  (256 / 4)              // Jako LOG_drain() s vychozim PKT_MAX
+#define MAX_STEP     10000                  // Nejvetsi rozdil casu sousednich zaznamu v testu (1 s)
+
+static uint32_t words[2 * LOG_RING];
+static int failures;
+static FILE *out;
+
+/**
+ * @brief  Odeslani slov jako ramec packet.h (COBS + CRC-32) do souboru.
+ *
+ */
+static void save_frame(const uint32_t *data, uint32_t n) {
+  uint8_t raw[FRAME_WORDS * 4 + 4], frame[sizeof(raw) + sizeof(raw) / 254 + 2];
+  const uint32_t len = n * 4;
+
+  memcpy(raw, data, len);
+  const uint32_t crc = crc32(0, raw, len);
+  for (int i = 0; i < 4; i++) raw[len + i] = (uint8_t)(crc >> (8 * i));
+
+  uint32_t pos = 1, code_pos = 0;
+  uint8_t code = 1;
+  for (uint32_t i = 0; i < len + 4; i++) {
+    if (raw[i]) {
+      frame[pos++] = raw[i];
+      if (++code < 0xFF) continue;
+    }
+    frame[code_pos] = code;
+    code_pos = pos++;
+    code = 1;
+  }
+  frame[code_pos] = code;
+  frame[pos++] = 0;
+  fwrite(frame, 1, pos, out);
+}
+
+/**
+ * @brief  Vyzvednuti vsech zaznamu (a ulozeni, pokud se uklada).
+ *
+ * @return Pocet slov.
+ */
+static uint32_t read_all(void) {
+  uint32_t total = 0, n;
+
+  while ((n = LOG_read(words + total, FRAME_WORDS)) != 0) {
+    save_frame(words + total, n);
+    total += n;
+  }
+  return total;
+}
+
+/**
+ * @brief  Dekodovani ulozenych ramcu (COBS, CRC) a kontrola casu zaznamu.
+ *
+ * @param  records Pocet dekodovanych zaznamu.
+ *
+ * @return Pocet chyb (chybny ramec, skok casu vetsi nez MAX_STEP).
+ */
+static int check_capture(uint32_t *records) {
+  static uint8_t raw[1 << 20];
+  uint8_t data[FRAME_WORDS * 4 + 4];
+  uint32_t start = 0, last = 0, have_last = 0;
+  int errors = 0;
+
+  fflush(out);
+  rewind(out);
+  const size_t size = fread(raw, 1, sizeof(raw), out);
+  *records = 0;
+
+  for (size_t end = 0; end < size; end++) {
+    if (raw[end]) continue;
+
+    uint32_t len = 0, in = start;             // COBS
+    while (in < end && len <= sizeof(data)) {
+      const uint8_t code = raw[in++];
+      for (uint8_t k = 1; k < code && in < end && len < sizeof(data); k++) data[len++] = raw[in++];
+      if (code < 0xFF && in < end && len < sizeof(data)) data[len++] = 0;
+    }
+    start = end + 1;
+
+    const uint32_t crc = data[len - 4] | ((uint32_t)data[len - 3] << 8) | ((uint32_t)data[len - 2] << 16) | ((uint32_t)data[len - 1] << 24);
+    if (len < 12 || len % 4 || crc32(0, data, len - 4) != crc) {
+      errors++;
+      continue;
+    }
+
+    for (uint32_t pos = 0; pos + 8 <= len - 4; (*records)++) {
+      uint32_t meta;
+      memcpy(&meta, &data[pos + 4], 4);
+      const uint32_t time = meta & LOG_TIME_MASK;
+      if (have_last) {
+        int32_t step = (int32_t)((time - last) & LOG_TIME_MASK);
+        if (step >= (int32_t)(1UL << 27)) step -= (int32_t)(1UL << 28); // Rozdil se znamenkem
+        if (step > MAX_STEP || step < -MAX_STEP) errors++;
+      }
+      last = time;
+      have_last = 1;
+      pos += 8 + 4 * (meta >> 28);
+    }
+  }
+  return errors;
+}
+
+static void check(const char *name, int ok) {
+  printf("%-40s %s\n", name, ok ? "OK" : "CHYBA");
+  if (!ok) failures++;
+}
+
+/**
+ * @brief  Kontrola zaznamu: format, pocet argumentu a argumenty.
+ *
+ */
+static int record_is(const uint32_t *rec, const char *fmt, uint32_t nargs, const uint32_t *args) {
+  if (strcmp((const char *)(uintptr_t)rec[0], fmt) != 0) return 0;
+  if ((rec[1] >> 28) != nargs) return 0;
+  return memcmp(&rec[2], args, nargs * 4) == 0;
+}
+
+static double now_s(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv) {
+  static const char name[] = "sim";
+  float f = 2.5f;
+
+  out = (argc > 1) ? fopen(argv[1], "w+b") : tmpfile();
+  if (!out) {
+    perror(argc > 1 ? argv[1] : "tmpfile");
+    return 1;
+  }
+  SysTick_Config(SystemCoreClock / 10000);    // Ticks po 0.1 ms (cas v zaznamech)
+  Ticks = LOG_TIME_MASK - 40;                 // 28bit cas v zaznamech pretece behem testu
+
+  LOG("bez argumentu");
+  delay_ms(3);
+  LOG("int %d, unsigned %u, hex 0x%08X", -42, 4000000000U, 0xC0FFEEU);
+  LOG("float %.3f, double %g, znak %c", f, 0.125, 'A');
+  LOG("retezec %s, cas %u ms", name, 3);
+  LOG("osm %d %d %d %d %d %d %d %d", 1, 2, 3, 4, 5, 6, 7, 8);
+
+  uint32_t n = read_all();
+  const uint32_t a1[] = { (uint32_t)-42, 4000000000U, 0xC0FFEEU };
+  const uint32_t a2[] = { 0x40200000U, 0x3E000000U, 'A' };
+  const uint32_t a3[] = { (uint32_t)(uintptr_t)name, 3 };
+  const uint32_t a4[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+  check("delka zaznamu", n == 2 + 5 + 5 + 4 + 10);
+  check("bez argumentu", record_is(&words[0], "bez argumentu", 0, 0));
+  check("cas v zaznamu", (words[2 + 1] & LOG_TIME_MASK) - (words[1] & LOG_TIME_MASK) == 30);
+  check("cela cisla", record_is(&words[2], "int %d, unsigned %u, hex 0x%08X", 3, a1));
+  check("float a double jako float", record_is(&words[7], "float %.3f, double %g, znak %c", 3, a2));
+  check("retezec podle adresy", record_is(&words[12], "retezec %s, cas %u ms", 2, a3));
+  check("8 argumentu", record_is(&words[16], "osm %d %d %d %d %d %d %d %d", 8, a4));
+
+  const uint32_t kept = LOG_RING / 3, lost = LOG_RING - kept;
+  const uint32_t filled = Ticks;
+  for (uint32_t i = 0; i < LOG_RING; i++) {   // Preteceni: 3 slova na zaznam
+    if (i == kept) delay_ms(2);               // Zahazuje se pozdeji, nez se zapsaly ulozene zaznamy
+    LOG("plny buffer %d", i);
+  }
+  delay_ms(1);
+  n = read_all();
+  check("zahozene zaznamy oznameny", record_is(&words[0], LOG_fmt_dropped, 1, &lost));
+  check("cas prvniho zahozeni", (words[1] & LOG_TIME_MASK) == ((filled + 20) & LOG_TIME_MASK));
+  check("ulozene zaznamy zachovany", n == 3 + kept * 3 && words[3 + (kept - 1) * 3 + 2] == kept - 1);
+  check("prazdny buffer", LOG_pending() == 0 && read_all() == 0);
+
+  int value = 7;
+  uint8_t bytes[4];
+  LOG("ukazatele %p %p %p", &value, bytes, (const uint16_t *)0);
+  const uint32_t a5[] = { (uint32_t)(uintptr_t)&value, (uint32_t)(uintptr_t)bytes, 0 };
+  read_all();
+  check("libovolne ukazatele", record_is(&words[0], "ukazatele %p %p %p", 3, a5));
+
+  static const char preempted[] LOG_SECTION = "prerusene LOG(), cas pred prerusenim";
+  uint32_t rec[2] = { LOG_ptr(preempted), Ticks & LOG_TIME_MASK };
+  delay_ms(1);
+  LOG("zaznam z preruseni");                  // Preruseni mezi ctenim Ticks a LOG_write()
+  LOG_write(rec, 2);
+  read_all();
+
+  const int rounds = 10000000;
+  const double start = now_s();
+  for (int i = 0; i < rounds; i++) {
+    LOG("mereni %d %d", i, i >> 3);
+    if ((i & 63) == 63) LOG_tail = LOG_head;  // Vyprazdneni bez kopirovani
+  }
+  const double elapsed = now_s() - start;
+  LOG_tail = LOG_head;
+  printf("LOG() se 2 argumenty: %.1f ns\n", elapsed * 1e9 / rounds);
+
+  LOG("konec, chyb %d", failures);
+  read_all();
+
+  uint32_t records;
+  const int errors = check_capture(&records);
+  printf("ulozene ramce: %lu zaznamu, %d chyb\n", (unsigned long)records, errors);
+  check("zpetne dekodovani, cas se znamenkem", errors == 0 && records == 5 + 1 + kept + 1 + 2 + 1);
+  fclose(out);
+
+  return failures != 0;
+}
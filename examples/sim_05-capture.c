@@ -0,0 +1,84 @@
+/**
+  ******************************************************************************
+  * @file     sim_05-capture.c
+  * @author   SPSE Havirov
+  * @version  1.0
+  * @date     19-October-2026
+  * @brief    Simulace mereni frekvence na PC - kontrola ovladace capture.h
+  *             (frekvence, perioda, strida, signal bez hran, ustaly signal
+  *             i po preteceni 32bit citace, rozsireni casove znacky).
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Preklad a spusteni na PC (z korene repozitare, -no-pie: DMA zapisuje na 32bit
+  * adresu bufferu):
+  *   gcc -std=gnu11 -O2 -no-pie -Istm32/sim -Istm32/include -Istm32/config -Istm32/boards \
+  *       examples/sim_05-capture.c -o sim_capture && ./sim_capture
+  *
+  * Program vraci 1, pokud nektera kontrola selhala.
+  *
+  ******************************************************************************
+*/
+#include "stm32_kit.h"                        // Pripojeni globalniho konfiguracniho souboru pro praci s pripravkem.
+#include "stm32_kit/capture.h"
+
+#include "square_wave.h"                      // Model vstupniho signalu (pouze simulace).
+
+#define TICKS_PER_S 10000                     // SysTick 0.1 ms
+
+static sim_square_t wave;
+static int failures;
+
+/**
+ * @brief  Porovnani namerene hodnoty s ocekavanou.
+ *
+ */
+static void check(const char *name, uint64_t got, uint64_t want) {
+  const int ok = got == want;
+
+  printf("%-36s %12llu (ocekavano %12llu) %s\n", name, (unsigned long long)got, (unsigned long long)want,
+         ok ? "OK" : "CHYBA");
+  if (!ok) failures++;
+}
+
+int main(void) {
+  SysTick_Config(SystemCoreClock / TICKS_PER_S);
+  const uint32_t tick_ns = CAP_setup(100);    // 16 MHz, delicka 2 -> 125 ns
+  check("rozliseni [ns]", tick_ns, 125);
+
+  sim_square_attach(&wave, CAP_tim->tim, CAP_TIM_IRQ_HANDLER, CAP_PIN);
+  CAP_start();
+  check("bez signalu [Hz]", CAP_frequency_hz(), 0);
+
+  sim_square_run(&wave, 1000000, 250000, 1);  // Jedina nabezna hrana - zadna perioda
+  check("jedna hrana [mHz]", CAP_frequency_mhz(), 0);
+
+  sim_square_run(&wave, 1000000, 250000, 20); // 1 kHz, strida 25 %
+  check("1 kHz [Hz]", CAP_frequency_hz(), 1000);
+  check("1 kHz [mHz]", CAP_frequency_mhz(), 1000000);
+  check("1 kHz perioda [ns]", CAP_period_ns(), 1000000);
+  check("1 kHz strida [promile]", CAP_duty_permille(), 250);
+  check("cas posledni hrany [tiky]", CAP_last_edge(), wave.rise_ticks);
+
+  sim_square_wait(&wave, 5000000);            // Bez hran 5 ms (5 period)
+  check("ustaly signal po 5 ms [Hz]", CAP_frequency_hz(), 0);
+
+  // Bez hran presne jednu periodu 32bit citace (537 s): posledni hrana vypada
+  // jako 0.5 ms stara, ustaly signal musi poznat az podle Ticks
+  const uint64_t since = sim_square_ticks(&wave) - wave.rise_ticks;
+  sim_square_wait(&wave, ((1ULL << 32) + 4000 - since) * tick_ns);
+  check("ustaly signal po 2^32 tiku [mHz]", CAP_frequency_mhz(), 0);
+  check("ustaly signal strida [promile]", CAP_duty_permille(), 0);
+
+  sim_square_run(&wave, 20000000, 5000000, 1); // Obnoveni signalu 50 Hz: prvni hrana po vymazani
+  check("50 Hz, jedna hrana [mHz]", CAP_frequency_mhz(), 0);
+  sim_square_run(&wave, 20000000, 5000000, CAP_AVERAGE);
+  check("50 Hz [mHz]", CAP_frequency_mhz(), 50000);
+  check("50 Hz strida [promile]", CAP_duty_permille(), 250);
+  check("cas hrany po preteceni [tiky]", CAP_last_edge(), wave.rise_ticks);
+  check("preteceni citace", CAP_overflows, 1);
+
+  printf("%d chyb, %lu hran\n", failures, (unsigned long)wave.edges);
+  return failures != 0;
+}
@@ -0,0 +1,200 @@
+/**
+  ******************************************************************************
+  * @file     sim_06-format.c
+  * @author   SPSE Havirov
+  * @version  1.0
+  * @date     19-October-2026
+  * @brief    Kontrola formatovani cisel (format.h) na PC a porovnani rychlosti
+  *             se snprintf(). Vystup fmt_uint(), fmt_int(), fmt_fixed() a fmt_hex()
+  *             se porovnava se snprintf() pro krajni hodnoty (0, 2^32 - 1, INT32_MIN,
+  *             sirka, vypln nulami, chybejici nuly za desetinnou teckou) a nahodna
+  *             cisla ruzne velikosti, pak se meri doba prevodu jednoho cisla.
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * Preklad a spusteni na PC (z korene repozitare):
+  *   gcc -std=gnu11 -O2 -Istm32/sim -Istm32/include -Istm32/config -Istm32/boards \
+  *       examples/sim_06-format.c -o sim_format && ./sim_format
+  *
+  * Rychlost na PC jen orientacne: format.h se obejde bez deleni (G071 nema
+  * hardwarovou delicku), snprintf() na PC deli jednou instrukci.
+  *
+  * Program vraci 1, pokud nektera kontrola selhala.
+  *
+  ******************************************************************************
+*/
+#include "stm32_kit.h"                        // Pripojeni globalniho konfiguracniho souboru pro praci s pripravkem.
+#include "stm32_kit/format.h"
+
+#include <string.h>
+#include <time.h>
+
+#define VALUES  4096                          // Pocet nahodnych cisel
+#define ROUNDS  500                           // Opakovani pri mereni rychlosti
+
+static char out[32];                          // Vystup fmt_*() (sink)
+static int out_len;
+static int32_t values[VALUES];
+static int failures;
+static uint32_t checksum;                     // Proti vypusteni mereneho kodu prekladacem
+
+static void sink(uint8_t c) {
+  out[out_len++] = (char)c;
+}
+
+static uint32_t random32(void) {              // xorshift32 - stale stejna posloupnost
+  static uint32_t state = 2463534242UL;
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+static double now_s(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+//#=======================================================================
+//#=== Stejny vystup pres snprintf() - ZACATEK
+static int ref_uint(char *buf, uint32_t value, int width, char pad) {
+  return snprintf(buf, 32, (pad == '0') ? "%0*lu" : "%*lu", width, (unsigned long)value);
+}
+
+static int ref_int(char *buf, int32_t value, int width, char pad) {
+  return snprintf(buf, 32, (pad == '0') ? "%0*ld" : "%*ld", width, (long)value);
+}
+
+static int ref_fixed(char *buf, int32_t value, int decimals, int width) {
+  if (decimals <= 0) return snprintf(buf, 32, "%*ld", width, (long)value);
+
+  char text[32];
+  uint32_t scale = 1;
+  for (int i = 0; i < decimals; i++) scale *= 10;
+  const uint32_t magnitude = (value < 0) ? 0UL - (uint32_t)value : (uint32_t)value;
+
+  snprintf(text, sizeof(text), "%s%lu.%0*lu", (value < 0) ? "-" : "", (unsigned long)(magnitude / scale),
+           decimals, (unsigned long)(magnitude % scale));
+  return snprintf(buf, 32, "%*s", width, text);
+}
+
+static int ref_hex(char *buf, uint32_t value, int digits) {
+  const uint32_t mask = (digits >= 8) ? 0xFFFFFFFFUL : (1UL << (4 * digits)) - 1;
+  return snprintf(buf, 32, "%0*lX", digits, (unsigned long)(value & mask));
+}
+//#=== Stejny vystup pres snprintf() - KONEC
+//#=======================================================================
+
+/**
+ * @brief  Porovnani posledniho vystupu fmt_*() s referenci.
+ *
+ */
+static void compare(const char *name, const char *want, int32_t value, int arg) {
+  out[out_len] = '\0';
+  if (strcmp(out, want) == 0) return;
+
+  if (failures < 20) {
+    printf("%-10s %11ld (%d): \"%s\" (ocekavano \"%s\") CHYBA\n", name, (long)value, arg, out, want);
+  }
+  failures++;
+}
+
+/**
+ * @brief  Kontrola vsech funkci pro jednu hodnotu.
+ *
+ */
+static void check_value(int32_t value) {
+  static const int widths[] = { 0, 1, 5, 12 };
+  char want[32];
+
+  for (unsigned w = 0; w < sizeof(widths) / sizeof(widths[0]); w++) {
+    const int width = widths[w];
+
+    out_len = 0; fmt_uint(sink, (uint32_t)value, width, ' ');
+    ref_uint(want, (uint32_t)value, width, ' ');
+    compare("fmt_uint", want, value, width);
+
+    out_len = 0; fmt_uint(sink, (uint32_t)value, width, '0');
+    ref_uint(want, (uint32_t)value, width, '0');
+    compare("fmt_uint 0", want, value, width);
+
+    out_len = 0; fmt_int(sink, value, width, ' ');
+    ref_int(want, value, width, ' ');
+    compare("fmt_int", want, value, width);
+
+    out_len = 0; fmt_int(sink, value, width, '0');
+    ref_int(want, value, width, '0');
+    compare("fmt_int 0", want, value, width);
+
+    for (int decimals = 0; decimals <= 9; decimals += 3) {
+      out_len = 0; fmt_fixed(sink, value, decimals, width);
+      ref_fixed(want, value, decimals, width);
+      compare("fmt_fixed", want, value, decimals);
+    }
+  }
+
+  for (int digits = 1; digits <= 8; digits++) {
+    out_len = 0; fmt_hex(sink, (uint32_t)value, digits);
+    ref_hex(want, (uint32_t)value, digits);
+    compare("fmt_hex", want, value, digits);
+  }
+}
+
+/**
+ * @brief  Doba prevodu jednoho cisla v ns: format.h proti snprintf().
+ *
+ */
+static void benchmark(const char *name, int kind) {
+  char buf[32];
+  double elapsed[2];
+
+  for (int impl = 0; impl < 2; impl++) {
+    const double start = now_s();
+    for (int r = 0; r < ROUNDS; r++) {
+      for (int i = 0; i < VALUES; i++) {
+        const int32_t v = values[i];
+        int len;
+
+        out_len = 0;
+        switch (kind) {
+          case 0:  if (impl) len = ref_uint(buf, (uint32_t)v, 0, ' '); else fmt_uint(sink, (uint32_t)v, 0, ' '); break;
+          case 1:  if (impl) len = ref_int(buf, v, 8, ' ');            else fmt_int(sink, v, 8, ' ');            break;
+          case 2:  if (impl) len = ref_fixed(buf, v, 2, 0);            else fmt_fixed(sink, v, 2, 0);            break;
+          default: if (impl) len = ref_hex(buf, (uint32_t)v, 8);       else fmt_hex(sink, (uint32_t)v, 8);       break;
+        }
+        if (!impl) len = out_len;
+        checksum += (uint32_t)len + (uint8_t)(impl ? buf[0] : out[0]);
+      }
+    }
+    elapsed[impl] = (now_s() - start) * 1e9 / ((double)ROUNDS * VALUES);
+  }
+  printf("%-24s %7.1f ns %7.1f ns %6.2fx\n", name, elapsed[0], elapsed[1], elapsed[1] / elapsed[0]);
+}
+
+int main(void) {
+  static const int32_t edges[] = {
+    0, 1, -1, 5, -5, 9, 10, 99, 100, -100, 12345, -12345, 999999999, 1000000000,
+    2147483647, -2147483647 - 1, (int32_t)0xFFFFFFFFUL, (int32_t)0x80000001UL,
+  };
+
+  for (unsigned i = 0; i < sizeof(edges) / sizeof(edges[0]); i++) {
+    check_value(edges[i]);
+  }
+  for (int i = 0; i < VALUES; i++) {          // Rovnomerne zastoupeni poctu cislic
+    values[i] = (int32_t)(random32() >> (random32() % 32));
+    if (random32() & 1) values[i] = -values[i];
+    check_value(values[i]);
+  }
+  printf("kontrola: %d hodnot, %d chyb\n", (int)(sizeof(edges) / sizeof(edges[0])) + VALUES, failures);
+
+  printf("%-24s %10s %10s %7s\n", "", "format.h", "snprintf", "pomer");
+  benchmark("fmt_uint / %lu", 0);
+  benchmark("fmt_int / %8ld", 1);
+  benchmark("fmt_fixed / %lu.%02lu", 2);
+  benchmark("fmt_hex / %08lX", 3);
+  printf("(kontrolni soucet %08lX)\n", (unsigned long)checksum);
+
+  return failures != 0;
+}
@@ -50,6 +50,64 @@ extern "C" {
  #define LCD_ROWS      2
 #endif
 
+//   <q>LCD ASYNC
+//   <i> Output to the LCD is queued and sent from the TIM7 interrupt (F401/F411: TIM5, non-blocking).
+//   <i> Default: 0 (synchronous output)
+#ifndef LCD_ASYNC
+ #define LCD_ASYNC     0
+#endif
+
+//   <o>LCD ASYNC QUEUE <16=>   16
+//                      <32=>   32
+//                      <64=>   64
+//                      <128=> 128
+//                      <256=> 256
+//   <i> Size of the command queue for asynchronous output (power of 2).
+//   <i> Default: 64
+#ifndef LCD_ASYNC_QUEUE
+ #define LCD_ASYNC_QUEUE   64
+#endif
+
+//   <o>LCD ASYNC TICK [us] <40-1000>
+//   <i> Period of the TIM7 interrupt, one nibble is sent per tick.
+//   <i> Must be longer than the command execution time (37us).
+//   <i> Default: 50
+#ifndef LCD_ASYNC_TICK_US
+ #define LCD_ASYNC_TICK_US 50
+#endif
+
+//   <o>LCD GLYPHS <1-64>
+//   <i> Maximum number of custom 5x8 glyphs registered with LCD_glyph_register().
+//   <i> Glyphs share the 8 CGRAM slots of the display (least recently used is replaced).
+//   <i> Default: 16
+#ifndef LCD_GLYPHS
+ #define LCD_GLYPHS    16
+#endif
+
+//   <q>LCD I2C
+//   <i> The LCD is connected through a PCF8574 I2C backpack (i2c.h, SCL PB8, SDA PB9)
+//   <i> instead of the direct pins from the board header. Not combinable with LCD ASYNC.
+//   <i> Default: 0 (direct connection)
+#ifndef LCD_I2C
+ #define LCD_I2C       0
+#endif
+
+//   <o>LCD I2C ADDR <0x20-0x3F>
+//   <i> 7-bit address of the backpack (PCF8574: 0x20 - 0x27, PCF8574A: 0x38 - 0x3F).
+//   <i> Default: 0x27
+#ifndef LCD_I2C_ADDR
+ #define LCD_I2C_ADDR  0x27
+#endif
+
+//   <o>LCD I2C HZ <100000=> 100 kHz
+//                 <400000=> 400 kHz
+//                 <1000000=> 1 MHz (G0 only)
+//   <i> I2C bus speed set by LCD_setup() (when the bus is not set up yet).
+//   <i> Default: 400000
+#ifndef LCD_I2C_HZ
+ #define LCD_I2C_HZ    400000
+#endif
+
 
 // </h>
 
@@ -79,6 +137,42 @@ extern "C" {
 #endif
 
 
+// </h>
+
+// <h> LED PWM
+// ===============================
+//   <o>LED PWM FREQUENCY [Hz] <100-1000>
+//   <i> PWM period of the board LEDs (led_pwm.h), also the tick rate of blink/fade/breathe effects.
+//   <i> Default: 200
+#ifndef LED_PWM_HZ
+ #define LED_PWM_HZ       200
+#endif
+
+// </h>
+
+// <h> WS2812
+// ===============================
+//   <o>WS2812 LEDS <1-4096>
+//   <i> Number of addressable RGB LEDs on the strip (3 bytes of RAM each).
+//   <i> Default: 8
+#ifndef WS2812_LEDS
+ #define WS2812_LEDS      8
+#endif
+
+// </h>
+
+// <h> UART
+// ===============================
+//   <q>UART DMA
+//   <i> Receive and transmit through DMA ring buffers (UART_dma_setup, UART_send, packet.h, log.h).
+//   <i> Uses two DMA streams, their interrupt handlers (dma.h) and 2 kB of RAM. F4 only.
+//   <i> Default: 0
+#ifndef UART_DMA
+ #define UART_DMA         0
+#endif
+
+// </h>
+
 //------------- <<< end of configuration section >>> -----------------------
 
 // Defaultni rozlozeni pro 4x4 KeyPad
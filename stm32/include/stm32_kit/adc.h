@@ -34,17 +34,15 @@ extern "C" {
  *  @returns None
  */
 void ADC_setup(void) {
-  __disable_irq();
   pin_enable(ADC_1);
   pin_mode(ADC_1, PIN_MODE_ANALOG); // Analog mode
   
-  RCC->APB2ENR |= 0x00000100; // Enable ADC clock
+  atomic_bit_set(&RCC->APB2ENR, RCC_APB2ENR_ADC1EN_Pos); // Enable ADC clock
   MODIFY_REG(ADC1->SMPR2, 7UL << (3 * 1), 7UL << (3 * 1)); // Set sampling to 111 - 480 cycles
   
   ADC1->CR2  = 0;
   ADC1->SQR3 = 1; // Convert on channel 1
   ADC1->CR2  = 1;
-  __enable_irq();
 }
 
 /**
@@ -0,0 +1,158 @@
+/**
+ * @file       atomic.h
+ * @brief      Atomicke operace s bity a poli registru periferii (bez zakazani preruseni).
+ *
+ *             Cortex-M3/M4 (F4, L1):
+ *               - jednotlive bity se zapisuji pres bit-band alias (1 zapis = 1 bit,
+ *                 sbernice provede cteni-modifikaci-zapis nedelitelne),
+ *               - vicebitova pole (napr. MODER) pres LDREX/STREX (pri preruseni
+ *                 mezi ctenim a zapisem se operace zopakuje).
+ *
+ *             Cortex-M0+ (G0) bit-band ani LDREX/STREX nema, operace se provadi
+ *             v kratke kriticke sekci (PRIMASK se ulozi a obnovi, takze funkce lze
+ *             volat i se zakazanym prerusenim).
+ *
+ * @code
+ *     atomic_bit_set(&RCC->AHB1ENR, 3);                     // Hodiny GPIOD
+ *     atomic_bit_toggle(&GPIOD->ODR, 12);                   // Zmena stavu LED
+ *     atomic_modify(&GPIOD->MODER, 3UL << 24, 1UL << 24);   // PD12 jako vystup
+ * @endcode
+ *
+ * @author     Petr Madecki (petr.madecki@spsehavirov.cz)
+ * @author     Tomas Michalek (tomas.michalek@spsehavirov.cz)
+ *
+ * @date       2026-10-19
+ * @copyright  Copyright SPSE Havirov (c) 2026
+ */
+#ifndef STM32_KIT_ATOMIC
+#define STM32_KIT_ATOMIC
+
+#include <stdint.h>
+
+#include "platform.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(STM32_KIT_SIM)
+# define ATOMIC_BITBAND 0             // Simulace na PC: alias oblast neni mapovana
+#elif defined(__CORTEX_M) && (__CORTEX_M >= 3U)
+# define ATOMIC_BITBAND 1             // Cortex-M3/M4: bit-band a LDREX/STREX
+#else
+# define ATOMIC_BITBAND 0             // Cortex-M0+: kriticka sekce
+#endif
+
+#define BITBAND_PERIPH_BASE   0x40000000UL  // Bit-band oblast periferii (1MB: APB1, APB2, AHB1)
+#define BITBAND_PERIPH_ALIAS  0x42000000UL
+#define BITBAND_SRAM_BASE     0x20000000UL  // Bit-band oblast SRAM (1MB)
+#define BITBAND_SRAM_ALIAS    0x22000000UL
+#define BITBAND_REGION_SIZE   0x00100000UL
+
+#if ATOMIC_BITBAND
+/**
+ * @brief  Adresa aliasu bitu v bit-band oblasti.
+ *
+ * @param  reg Adresa registru (periferie nebo SRAM).
+ * @param  bit Cislo bitu (0 - 31).
+ *
+ * @return Alias bitu, nebo 0, pokud registr lezi mimo bit-band oblast.
+ */
+INLINE_STM32 volatile uint32_t *bitband_alias(volatile const uint32_t *reg, int bit) {
+  const uint32_t addr = (uint32_t)reg;
+
+  if (addr - BITBAND_PERIPH_BASE < BITBAND_REGION_SIZE) {
+    return (volatile uint32_t *)(BITBAND_PERIPH_ALIAS + (addr - BITBAND_PERIPH_BASE) * 32U + bit * 4U);
+  }
+  if (addr - BITBAND_SRAM_BASE < BITBAND_REGION_SIZE) {
+    return (volatile uint32_t *)(BITBAND_SRAM_ALIAS + (addr - BITBAND_SRAM_BASE) * 32U + bit * 4U);
+  }
+  return 0;
+}
+#endif
+
+/**
+ * @brief  Atomicka zmena bitu @p mask registru na hodnotu @p value.
+ *
+ * @param  reg   Registr.
+ * @param  mask  Menene bity.
+ * @param  value Nova hodnota menenych bitu (bity mimo @p mask se ignoruji).
+ *
+ */
+INLINE_STM32 void atomic_modify(volatile uint32_t *reg, uint32_t mask, uint32_t value) {
+  value &= mask;
+#if ATOMIC_BITBAND
+  do {
+    const uint32_t old = __LDREXW(reg);
+    if (__STREXW((old & ~mask) | value, reg) == 0) break;
+  } while (1);
+#else
+  const uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  *reg = (*reg & ~mask) | value;
+  __set_PRIMASK(primask);
+#endif
+}
+
+/**
+ * @brief  Atomicky zapis jednoho bitu registru.
+ *
+ * @param  reg   Registr.
+ * @param  bit   Cislo bitu (0 - 31).
+ * @param  value 0 nebo 1.
+ *
+ */
+INLINE_STM32 void atomic_bit_write(volatile uint32_t *reg, int bit, int value) {
+#if ATOMIC_BITBAND
+  volatile uint32_t *alias = bitband_alias(reg, bit);
+  if (alias) {
+    *alias = !!value;
+    return;
+  }
+#endif
+  atomic_modify(reg, 1UL << bit, (uint32_t)!!value << bit);
+}
+
+INLINE_STM32 void atomic_bit_set(volatile uint32_t *reg, int bit) {
+  atomic_bit_write(reg, bit, 1);
+}
+
+INLINE_STM32 void atomic_bit_clear(volatile uint32_t *reg, int bit) {
+  atomic_bit_write(reg, bit, 0);
+}
+
+/**
+ * @brief  Cteni jednoho bitu registru (jeden pristup na sbernici).
+ *
+ */
+INLINE_STM32 int atomic_bit_read(volatile const uint32_t *reg, int bit) {
+#if ATOMIC_BITBAND
+  volatile uint32_t *alias = bitband_alias(reg, bit);
+  if (alias) return (int)*alias;
+#endif
+  return (int)((*reg >> bit) & 1UL);
+}
+
+/**
+ * @brief  Atomicka negace jednoho bitu registru.
+ *
+ */
+INLINE_STM32 void atomic_bit_toggle(volatile uint32_t *reg, int bit) {
+#if ATOMIC_BITBAND
+  do {
+    const uint32_t old = __LDREXW(reg);
+    if (__STREXW(old ^ (1UL << bit), reg) == 0) break;
+  } while (1);
+#else
+  const uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  *reg ^= 1UL << bit;
+  __set_PRIMASK(primask);
+#endif
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STM32_KIT_ATOMIC */
@@ -47,12 +47,8 @@ extern "C" {
  * @brief Inicializace uzivatelskeho tlacitka
  */
 void BTN_setup(void) {
-  __disable_irq();
-  
   pin_enable(USER_BUTTON);
   pin_mode(USER_BUTTON, PIN_MODE_INPUT);
-
-  __enable_irq();
 }
 
 #ifdef __cplusplus
@@ -0,0 +1,370 @@
+/**
+ * @file       capture.h
+ * @brief      Mereni frekvence, periody a stridy vstupniho signalu (input capture + DMA).
+ *
+ *             Vstup je pripojen na kanal 1 casovace (TI1). Kanal 1 zachycuje nabezne,
+ *             kanal 2 (z tehoz vstupu TI1) sestupne hrany. Casove znacky kazde hrany
+ *             zapisuje DMA do kruhoveho bufferu, CPU se hran vubec neucastni.
+ *             Frekvence a strida se pocitaji az pri dotazu z poslednich CAP_AVERAGE hran,
+ *             rozdily znacek modulo sirka citace (hrany musi byt blize nez 2^16, resp.
+ *             2^32 tiku).
+ *
+ *             Preteceni citace pocita preruseni casovace: casove znacky se tak
+ *             rozsiruji na 32 bitu (16bit casovac) nebo 64 bitu (32bit casovac).
+ *             Ustaly signal se pozna podle Ticks (SysTick, chrono.h): zadna nova hrana
+ *             dele nez CAP_TIMEOUT ms, nejvyse vsak jedna perioda citace (32bit citac
+ *             pri 10 MHz pretece az po 429 s, preteceni k detekci nestaci).
+ *
+ *             Smerovani: F4 - TIM2 (32bit), PA15 (AF1), G0 - TIM2 (32bit), PA15 (AF2),
+ *                        pozadavky DMA TIM2_CH1/CH2, streamy/kanaly prideli dma_alloc()
+ *                        (F4 - DMA1 Stream5/6, sdileny s dac.h a ws2812.h).
+ *
+ * @code
+ *     CAP_setup(100);                        // Rozliseni 100 ns
+ *     CAP_start();
+ *     ...
+ *     uint32_t rpm  = CAP_frequency_mhz() * 60 / 1000 / 2; // Tachometr, 2 pulzy na otacku
+ *     uint32_t duty = CAP_duty_permille();
+ * @endcode
+ *
+ * @author     Petr Madecki (petr.madecki@spsehavirov.cz)
+ * @author     Tomas Michalek (tomas.michalek@spsehavirov.cz)
+ *
+ * @date       2026-10-19
+ * @copyright  Copyright SPSE Havirov (c) 2026
+ */
+#ifndef STM32_KIT_CAPTURE
+#define STM32_KIT_CAPTURE
+
+#include "platform.h"
+#include "gpio.h"
+#include "pin.h"
+#include "timers.h"
+#include "dma.h"
+#include "chrono.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef CAP_SAMPLES
+# define CAP_SAMPLES   32   // Velikost bufferu hran (kazdy smer)
+#endif
+#ifndef CAP_AVERAGE
+# define CAP_AVERAGE   8    // Pocet period pro prumer (nejvyse CAP_SAMPLES / 2)
+#endif
+#ifndef CAP_FILTER
+# define CAP_FILTER    3    // Digitalni filtr vstupu ICxF (0 = bez filtru, 3 = 8 vzorku)
+#endif
+#ifndef CAP_TIMEOUT
+# define CAP_TIMEOUT   2000 // Bez hrany dele nez CAP_TIMEOUT ms = signal ustal (nejnizsi frekvence 0.5 Hz)
+#endif
+#define CAP_EMPTY      0xFFFFFFFFUL  // Dosud nezapsana pozice bufferu
+
+//#========================================================================
+//#=== Smerovani casovac -> DMA - ZACATEK
+#ifndef CAP_TIM
+# if defined(STM32F4)
+#  define CAP_TIM              2   // TIM2
+#  define CAP_PIN              PA15
+#  define CAP_AF               PIN_AF1
+#  define CAP_REQ              { DMA_REQ_TIM2_CH1, DMA_REQ_TIM2_CH2 }
+#  define CAP_TIM_IRQ_HANDLER  TIM2_IRQHandler
+# elif defined(STM32G0)
+#  define CAP_TIM              2   // TIM2
+#  define CAP_PIN              PA15
+#  define CAP_AF               PIN_AF2
+#  define CAP_REQ              { DMA_REQ_TIM2_CH1, DMA_REQ_TIM2_CH2 }
+#  define CAP_TIM_IRQ_HANDLER  TIM2_IRQHandler
+# endif
+#endif
+//#=== Smerovani casovac -> DMA - KONEC
+//#========================================================================
+
+static const dma_t *CAP_dma[2];
+static const tim_t *CAP_tim;
+
+static uint32_t          CAP_edges[2][CAP_SAMPLES]; // [0] nabezne, [1] sestupne hrany
+static uint32_t          CAP_tick_hz;     // Frekvence citace
+static uint32_t          CAP_mask;        // Maximalni hodnota citace (0xFFFF / 0xFFFFFFFF)
+static volatile uint32_t CAP_overflows;   // Pocet preteceni citace
+static uint32_t          CAP_timeout;     // Nejdelsi doba bez hrany v Ticks (0.1 ms)
+static uint32_t          CAP_seen_stamp;  // Posledni hrana videna CAP_stalled()
+static uint32_t          CAP_seen_ticks;  //  a Ticks, kdy byla videna
+
+/**
+ * @brief  Pocatecni inicializace: pin, casovac (volne bezici citac) a DMA.
+ *
+ * @param  tick_ns Rozliseni casovych znacek (perioda citace), napr. 100 ns.
+ *
+ * @return Skutecne rozliseni v ns, 0 = neni volny kanal DMA.
+ */
+uint32_t CAP_setup(uint32_t tick_ns) {
+  static const dma_request_t requests[2] = CAP_REQ;
+  for (int i = 0; i < 2; i++) {
+    if (!CAP_dma[i]) CAP_dma[i] = dma_alloc(requests[i]);
+    if (!CAP_dma[i]) {                        // Stream/kanal DMA obsazen jinym ovladacem
+      for (int k = 0; k < i; k++) {           //  - uvolnit i uz pridelene
+        dma_free(CAP_dma[k]);
+        CAP_dma[k] = 0;
+      }
+      return 0;
+    }
+  }
+
+  CAP_tim = TIM_get(CAP_TIM);
+  TIM_enable(CAP_tim);
+
+  pin_setup_af(CAP_PIN, PIN_MODE_AF, PIN_PULL_DEFAULT, PIN_SPEED_DEFAULT, PIN_TYPE_DEFAULT, CAP_AF);
+
+  const uint32_t clock = TIM_clock(CAP_tim);
+  uint32_t psc = (uint32_t)(((uint64_t)clock * tick_ns + 500000000ULL) / 1000000000ULL);
+  if (psc < 1) psc = 1;
+  if (psc > 0x10000) psc = 0x10000;
+
+  TIM_TypeDef *tim = CAP_tim->tim;
+  CAP_mask    = (CAP_tim->width == 32) ? 0xFFFFFFFFUL : 0xFFFFUL;
+  CAP_tick_hz = clock / psc;
+
+  tim->PSC   = psc - 1;
+  tim->ARR   = CAP_mask;                      // Volne bezici citac
+  tim->CCMR1 = (1UL << 0) | ((uint32_t)CAP_FILTER << 4)     // CC1S = 01: IC1 <- TI1
+             | (2UL << 8) | ((uint32_t)CAP_FILTER << 12);   // CC2S = 10: IC2 <- TI1
+  tim->CCER  = (1UL << 0)                                   // CC1E, nabezna hrana
+             | (1UL << 4) | (1UL << 5);                     // CC2E, CC2P: sestupna hrana
+  tim->EGR   = TIM_EGR_UG;
+
+  const uint64_t wrap = ((uint64_t)CAP_mask + 1) * 10000 / CAP_tick_hz; // Perioda citace v Ticks
+  CAP_timeout = (wrap < CAP_TIMEOUT * 10ULL) ? (uint32_t)wrap : CAP_TIMEOUT * 10UL;
+
+  return (uint32_t)(((uint64_t)psc * 1000000000ULL + clock / 2) / clock);
+}
+
+/**
+ * @brief  Zastaveni mereni.
+ *
+ */
+void CAP_stop(void) {
+  if (!CAP_dma[0]) return;                    // CAP_setup() neuspel
+
+  TIM_stop(CAP_tim);
+  CAP_tim->tim->DIER &= ~(TIM_DIER_CC1DE | TIM_DIER_CC2DE | TIM_DIER_UIE);
+  for (int i = 0; i < 2; i++) {
+    dma_stop(CAP_dma[i]);
+  }
+}
+
+/**
+ * @brief  Vymazani bufferu (mereni zacne znovu od prvni hrany).
+ *
+ */
+INLINE_STM32 void CAP_clear(void) {
+  for (int i = 0; i < CAP_SAMPLES; i++) {
+    CAP_edges[0][i] = CAP_EMPTY;
+    CAP_edges[1][i] = CAP_EMPTY;
+  }
+}
+
+/**
+ * @brief  Spusteni mereni.
+ *
+ */
+void CAP_start(void) {
+  if (!CAP_dma[0]) return;                    // CAP_setup() neuspel
+
+  CAP_stop();
+  CAP_clear();
+  CAP_overflows  = 0;
+  CAP_seen_stamp = CAP_EMPTY;
+  CAP_seen_ticks = Ticks;
+
+  for (int i = 0; i < 2; i++) {                // CCRx je 32bit registr i u 16bit casovace
+    dma_start(CAP_dma[i], i ? &CAP_tim->tim->CCR2 : &CAP_tim->tim->CCR1, CAP_edges[i], CAP_SAMPLES,
+              DMA_PERIPH_TO_MEM | DMA_SIZE_32 | DMA_CIRCULAR);
+  }
+
+  CAP_tim->tim->DIER |= TIM_DIER_CC1DE | TIM_DIER_CC2DE;
+  TIM_irq_enable(CAP_tim);
+  TIM_start(CAP_tim);
+}
+
+/**
+ * @brief  Pozice bufferu, kam DMA zapise pristi hranu.
+ *
+ */
+INLINE_STM32 uint16_t CAP_position(int edge) {
+  const uint16_t left = dma_remaining(CAP_dma[edge]);
+  return (left == 0 || left >= CAP_SAMPLES) ? 0 : CAP_SAMPLES - left; // 0 = kanal nepridelen
+}
+
+/**
+ * @brief  Casova znacka @p back-te posledni hrany (0 = posledni).
+ *
+ * @return Znacka, nebo CAP_EMPTY.
+ */
+INLINE_STM32 uint32_t CAP_edge(int edge, uint16_t back) {
+  const uint16_t pos = CAP_position(edge);
+  return CAP_edges[edge][(pos + 2U * CAP_SAMPLES - 1U - back) % CAP_SAMPLES];
+}
+
+/**
+ * @brief  Soucet poslednich @p n period nabeznych hran v tikach citace.
+ *
+ * @return Pocet skutecne sectenych period (0 = zatim malo hran).
+ */
+INLINE_STM32 int CAP_periods(uint64_t *sum, int n) {
+  uint32_t next = CAP_edge(0, 0);
+  int count = 0;
+
+  *sum = 0;
+  if (next == CAP_EMPTY) return 0;
+  for (int i = 1; i <= n; i++) {
+    const uint32_t prev = CAP_edge(0, (uint16_t)i);
+    if (prev == CAP_EMPTY) break;
+    *sum += (next - prev) & CAP_mask;          // Rozdil modulo sirka citace
+    next = prev;
+    count++;
+  }
+  return count;
+}
+
+/**
+ * @brief  Detekce ustaleho signalu: zadna nova hrana dele nez CAP_timeout (podle Ticks).
+ *         Ustaly signal vymaze buffer, dalsi mereni zacne od nuly (stare rozdily neplati).
+ *         Vola se z preruseni casovace i z dotazu.
+ *
+ * @return 1 = signal ustal.
+ */
+int CAP_stalled(void) {
+  const uint32_t primask = __get_PRIMASK();
+  int stalled = 0;
+
+  __disable_irq();
+  const uint32_t stamp = CAP_edge(0, 0);
+  const uint32_t now = Ticks;
+  if (stamp != CAP_seen_stamp || stamp == CAP_EMPTY) { // Nova hrana (cas se meri od jejiho zjisteni)
+    CAP_seen_stamp = stamp;
+    CAP_seen_ticks = now;
+  } else if (now - CAP_seen_ticks > CAP_timeout) {
+    CAP_clear();
+    stalled = 1;
+  }
+  __set_PRIMASK(primask);
+  return stalled;
+}
+
+/**
+ * @brief  Soucet poslednich CAP_AVERAGE period, pokud signal neustal.
+ *
+ * @return Pocet sectenych period (0 = signal neni nebo ustal).
+ */
+INLINE_STM32 int CAP_average(uint64_t *sum) {
+  const int n = CAP_periods(sum, CAP_AVERAGE);
+  if (!n || !*sum || CAP_stalled()) return 0;
+
+  const uint64_t age = (CAP_tim->tim->CNT - CAP_edge(0, 0)) & CAP_mask;
+  return (age * n > 2 * *sum) ? 0 : n;        // Posledni hrana starsi nez 2 periody - signal ustal
+}
+
+/**
+ * @brief  Prumerna perioda v tikach citace (0 = signal neni nebo ustal).
+ *
+ */
+uint32_t CAP_period_ticks(void) {
+  uint64_t sum;
+  const int n = CAP_average(&sum);
+  return n ? (uint32_t)(sum / n) : 0;
+}
+
+/**
+ * @brief  Prumerna perioda v ns (do 4.29 s).
+ *
+ */
+INLINE_STM32 uint32_t CAP_period_ns(void) {
+  return (uint32_t)((uint64_t)CAP_period_ticks() * 1000000000ULL / CAP_tick_hz);
+}
+
+/**
+ * @brief  Frekvence v mHz (tisiciny Hz - i pomale tachometry, do 4.29 MHz).
+ *
+ */
+uint32_t CAP_frequency_mhz(void) {
+  uint64_t sum;
+  const int n = CAP_average(&sum);
+  if (!n) return 0;                           // Soucet i pocet z jedineho cteni bufferu
+  return (uint32_t)((uint64_t)CAP_tick_hz * 1000ULL * n / sum);
+}
+
+/**
+ * @brief  Frekvence v Hz.
+ *
+ */
+INLINE_STM32 uint32_t CAP_frequency_hz(void) {
+  uint64_t sum;
+  const int n = CAP_average(&sum);
+  if (!n) return 0;
+  return (uint32_t)(((uint64_t)CAP_tick_hz * n + sum / 2) / sum);
+}
+
+/**
+ * @brief  Strida posledni periody v promile (doba v log. 1 / perioda).
+ *
+ */
+uint32_t CAP_duty_permille(void) {
+  const uint32_t period = CAP_period_ticks();
+  const uint32_t fall = CAP_edge(1, 0);
+  if (!period || fall == CAP_EMPTY) return 0;
+
+  uint32_t high = (fall - CAP_edge(0, 0)) & CAP_mask;
+  if (high > period) {                        // Nabezna hrana po posledni sestupne -> predchozi perioda
+    const uint32_t rise = CAP_edge(0, 1);
+    if (rise == CAP_EMPTY) return 0;
+    high = (fall - rise) & CAP_mask;
+  }
+  return (high >= period) ? 1000 : (uint32_t)((uint64_t)high * 1000 / period);
+}
+
+/**
+ * @brief  Rozsireni casove znacky o pocet preteceni (16bit -> 32bit, 32bit -> 64bit).
+ *         Znacka musi pochazet z posledni periody citace.
+ *
+ */
+uint64_t CAP_extend(uint32_t stamp) {
+  uint32_t ovf, cnt;
+
+  do {
+    ovf = CAP_overflows;
+    cnt = CAP_tim->tim->CNT;
+  } while (ovf != CAP_overflows);
+  if ((CAP_tim->tim->SR & TIM_SR_UIF) && cnt < CAP_mask / 2) ovf++; // Preteceni jeste neobslouzene
+
+  uint64_t hi = ovf;
+  if (stamp > cnt && hi) hi--;                // Hrana pred poslednim pretecenim
+  return (CAP_mask == 0xFFFFUL) ? (hi << 16 | stamp) : (hi << 32 | stamp);
+}
+
+/**
+ * @brief  Rozsireny cas posledni nabezne hrany v tikach od CAP_start() (0 = zadna).
+ *
+ */
+INLINE_STM32 uint64_t CAP_last_edge(void) {
+  const uint32_t stamp = CAP_edge(0, 0);
+  return (stamp == CAP_EMPTY) ? 0 : CAP_extend(stamp);
+}
+
+/**
+ * @brief  Obsluha preruseni casovace: pocitani preteceni, detekce ustaleho signalu
+ *         i bez dotazu (16bit citac).
+ *
+ */
+void CAP_TIM_IRQ_HANDLER(void) {
+  CAP_tim->tim->SR &= ~(TIM_SR_UIF);
+  CAP_overflows++;
+  (void)CAP_stalled();
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STM32_KIT_CAPTURE */
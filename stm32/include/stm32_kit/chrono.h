@@ -67,6 +67,10 @@ extern "C" {
 //#=========================================================================
 //#=== Casove funkce - ZACATEK
 
+#ifndef CHRONO_IDLE // Telo cekaci smycky (simulace na PC zde posouva virtualni cas)
+# define CHRONO_IDLE() /* cekani na ubehnuti casu */
+#endif
+
 #if !defined(RTE_CMSIS_RTOS2) && !defined(__RL_ARM_VER)
 static volatile uint32_t Ticks; // Vyuzito pro SysTick k nacitani Ticku pri podteceni.
 
@@ -105,7 +109,7 @@ INLINE_STM32 void delay_ms(uint32_t ms) {
   ms *= 10;
 
   while ((Ticks - start) < ms) {
-    /* cekani na ubehnuti casu */
+    CHRONO_IDLE();
   }
 }
 
@@ -118,7 +122,7 @@ INLINE_STM32 void delay_ms(uint32_t ms) {
 INLINE_STM32 void delay_us(uint32_t us) {
   uint32_t start = Ticks;
   while ((Ticks - start) < us) {
-    /* cekani na ubehnuti casu */
+    CHRONO_IDLE();
   }
 }
 #elif defined(__RL_ARM_VER)
@@ -0,0 +1,352 @@
+/**
+ * @file       crc.h
+ * @brief      CRC-32 (jako zlib, Ethernet, PNG) hardwarovou jednotkou CRC, pripadne softwarove.
+ *
+ *             Vsechny cesty pocitaji stejnou hodnotu (odrazeny CRC-32, pocatecni
+ *             hodnota i zaverecny XOR 0xFFFFFFFF, polynom CRC_POLY), takze protistrana
+ *             na PC muze pouzit napr. zlib.crc32() v Pythonu. Vypocet lze navazovat:
+ *             crc = crc32(crc, cast, delka) po castech dava stejny vysledek jako najednou
+ *             (na zacatku crc = 0).
+ *
+ *             Cesty:
+ *               - softwarova (slicing-by-4): tabulka 4 x 256 slov v RAM (4 KiB)
+ *                 se spocita pri prvnim pouziti pro libovolny CRC_POLY, zpracovava
+ *                 4 bajty na jedno cteni slova. Pouziva se na PC (simulace), na L1,
+ *                 pro kratka data a kdyz je jednotka CRC obsazena prenosem DMA,
+ *               - hardwarova (CRC_HW): zarovnana slova zapisuje CPU do CRC->DR,
+ *                 zacatek a konec mimo slova dopocita software.
+ *                 F4: pevny polynom 0x04C11DB7 bez otaceni bitu, vstup i vysledek
+ *                 se otaci instrukci RBIT (jine CRC_POLY = jen softwarove),
+ *                 G0: polynom CRC_POLY, otaceni bitu (REV_IN, REV_OUT) dela jednotka,
+ *               - DMA (CRC_DMA, jen G0): crc32_start() preda slova kanalu DMA pamet -> registr
+ *                 a hned se vrati, vysledek vrati crc32_wait(). Na F4 nelze, DMA neumi
+ *                 bity jednotlivych slov otocit.
+ *
+ *             Jednotka CRC je jedna: crc32() a crc32_start() nevolat zaroven z preruseni
+ *             a hlavni smycky (v preruseni lze vzdy pouzit crc32_sw()).
+ *
+ * @code
+ *     uint32_t crc = crc32(0, packet, len);             // Najednou
+ *
+ *     crc32_start(0, image, sizeof(image));             // G0: na pozadi pres DMA
+ *     ...
+ *     crc32_wait(&crc);
+ * @endcode
+ *
+ * @author     Petr Madecki (petr.madecki@spsehavirov.cz)
+ * @author     Tomas Michalek (tomas.michalek@spsehavirov.cz)
+ *
+ * @date       2026-10-19
+ * @copyright  Copyright SPSE Havirov (c) 2026
+ */
+#ifndef STM32_KIT_CRC
+#define STM32_KIT_CRC
+
+#include <stdint.h>
+
+#include "platform.h"
+#include "chrono.h"
+#include "atomic.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef CRC_POLY
+# define CRC_POLY  0x04C11DB7UL     // Polynom v normalnim tvaru (CRC-32; 0x1EDC6F41 = CRC-32C)
+#endif
+
+#ifndef CRC_HW                      // 1 = jednotka CRC (F4 jen pro polynom 0x04C11DB7, G0 libovolny)
+# if defined(CRC) && (defined(STM32G0) || (defined(STM32F4) && (CRC_POLY == 0x04C11DB7UL)))
+#  define CRC_HW  1
+# else
+#  define CRC_HW  0
+# endif
+#endif
+
+#ifndef CRC_DMA                     // 1 = crc32_start() pres DMA (pouze G0)
+# if CRC_HW && defined(STM32G0)
+#  define CRC_DMA  1
+# else
+#  define CRC_DMA  0
+# endif
+#endif
+
+#ifndef CRC_HW_MIN
+# define CRC_HW_MIN  16             // Kratsi data pocita software (rezie zarovnani a resetu jednotky)
+#endif
+
+#if CRC_DMA
+# include "dma.h"
+#endif
+
+static uint32_t CRC_table[4][256];  // Slicing-by-4: CRC_table[k][b] = b posunute o dalsich k bajtu
+static uint8_t  CRC_ready;
+
+/**
+ * @brief  Otoceni poradi bitu slova (bit 0 <-> bit 31).
+ *
+ */
+INLINE_STM32 uint32_t CRC_reflect(uint32_t x) {
+  uint32_t r = 0;
+  for (int i = 0; i < 32; i++) {
+    r = (r << 1) | (x & 1);
+    x >>= 1;
+  }
+  return r;
+}
+
+/**
+ * @brief  Vypocet tabulek pro CRC_POLY a zapnuti jednotky CRC (vola se samo pri prvnim pouziti).
+ *
+ */
+void crc32_setup(void) {
+  const uint32_t poly = CRC_reflect(CRC_POLY);
+
+  for (uint32_t i = 0; i < 256; i++) {
+    uint32_t c = i;
+    for (int bit = 0; bit < 8; bit++) {
+      c = (c & 1) ? (c >> 1) ^ poly : c >> 1;
+    }
+    CRC_table[0][i] = c;
+  }
+  for (uint32_t i = 0; i < 256; i++) {
+    for (int k = 1; k < 4; k++) {
+      const uint32_t c = CRC_table[k - 1][i];
+      CRC_table[k][i] = (c >> 8) ^ CRC_table[0][c & 0xFF];
+    }
+  }
+
+#if CRC_HW && defined(STM32F4)
+  atomic_bit_set(&RCC->AHB1ENR, RCC_AHB1ENR_CRCEN_Pos);
+#elif CRC_HW
+  atomic_bit_set(&RCC->AHBENR, RCC_AHBENR_CRCEN_Pos);
+  CRC->POL  = CRC_POLY;
+  CRC->INIT = 0xFFFFFFFFUL;
+#endif
+  CRC_ready = 1;
+}
+
+/**
+ * @brief  Softwarovy vypocet nad vnitrnim stavem (bez pocatecniho a zaverecneho XOR).
+ *
+ */
+INLINE_STM32 uint32_t CRC_sw_state(uint32_t state, const uint8_t *p, uint32_t len) {
+  while (len && ((uintptr_t)p & 3)) {         // Po bajtech az k zarovnani na slovo
+    state = (state >> 8) ^ CRC_table[0][(state ^ *p++) & 0xFF];
+    len--;
+  }
+  for (; len >= 4; len -= 4, p += 4) {        // 4 bajty jednim ctenim (little endian)
+    state ^= *(const uint32_t *)p;
+    state = CRC_table[3][state & 0xFF] ^ CRC_table[2][(state >> 8) & 0xFF]
+          ^ CRC_table[1][(state >> 16) & 0xFF] ^ CRC_table[0][state >> 24];
+  }
+  while (len--) {
+    state = (state >> 8) ^ CRC_table[0][(state ^ *p++) & 0xFF];
+  }
+  return state;
+}
+
+/**
+ * @brief  Softwarovy vypocet (slicing-by-4), lze volat i z preruseni.
+ *
+ * @param  crc  Vysledek predchozi casti, 0 na zacatku.
+ * @param  data Data.
+ * @param  len  Pocet bajtu.
+ *
+ * @return CRC-32 dosavadnich dat.
+ */
+uint32_t crc32_sw(uint32_t crc, const void *data, uint32_t len) {
+  if (!CRC_ready) crc32_setup();
+  return ~CRC_sw_state(~crc, (const uint8_t *)data, len);
+}
+
+#if CRC_HW
+//#========================================================================
+//#=== Jednotka CRC - ZACATEK
+//
+// Jednotka zpracuje slovo za 4 takty AHB od nejvyssiho bitu (neodrazene CRC).
+// Odrazeny vypocet vznikne otocenim bitu vstupnich slov a vysledku (F4 RBIT,
+// G0 REV_IN = po slovech, REV_OUT). Navazani na stav S: jednotka startuje
+// z 0xFFFFFFFF a prvni slovo se zapise s XOR ~S, coz dava stejny vysledek
+// jako start ze stavu S (CRC je linearni).
+
+#if defined(STM32F4)
+# define CRC_IN(word)  (CRC->DR = __RBIT(word))
+# define CRC_OUT()     __RBIT(CRC->DR)
+# define CRC_RESET()   (CRC->CR = CRC_CR_RESET)
+#else
+# define CRC_IN(word)  (CRC->DR = (word))
+# define CRC_OUT()     (CRC->DR)
+# define CRC_RESET()   (CRC->CR = (3UL << CRC_CR_REV_IN_Pos) | CRC_CR_REV_OUT | CRC_CR_RESET) // 32bit polynom
+#endif
+
+static volatile uint8_t CRC_running;          // Jednotku prave plni DMA (crc32_start())
+static uint8_t          CRC_pending;          // Jednotka drzi vysledek pro crc32_wait()
+
+/**
+ * @brief  Zpracovani zarovnanych slov jednotkou CRC.
+ *
+ * @param  state Vnitrni stav pred prvnim slovem.
+ * @param  words Pocet slov (alespon 1).
+ *
+ * @return Vnitrni stav po poslednim slove.
+ */
+INLINE_STM32 uint32_t CRC_hw_words(uint32_t state, const uint32_t *w, uint32_t words) {
+  CRC_RESET();
+  CRC_IN(*w++ ^ ~state);
+  while (--words) {
+    CRC_IN(*w++);
+  }
+  return CRC_OUT();
+}
+
+//#=== Jednotka CRC - KONEC
+//#========================================================================
+#endif
+
+/**
+ * @brief  Vypocet CRC-32, delsi data jednotkou CRC (pokud neni obsazena crc32_start()), jinak softwarove.
+ *
+ * @param  crc  Vysledek predchozi casti, 0 na zacatku.
+ * @param  data Data.
+ * @param  len  Pocet bajtu.
+ *
+ * @return CRC-32 dosavadnich dat.
+ */
+uint32_t crc32(uint32_t crc, const void *data, uint32_t len) {
+  if (!CRC_ready) crc32_setup();
+
+#if CRC_HW
+  if (len >= CRC_HW_MIN && !CRC_running && !CRC_pending) {
+    const uint8_t *p = (const uint8_t *)data;
+    const uint32_t head = (uint32_t)(-(uintptr_t)p) & 3;
+    uint32_t state = CRC_sw_state(~crc, p, head);
+
+    p += head;
+    len -= head;
+    state = CRC_hw_words(state, (const uint32_t *)p, len >> 2);
+    return ~CRC_sw_state(state, p + (len & ~3UL), len & 3);
+  }
+#endif
+  return ~CRC_sw_state(~crc, (const uint8_t *)data, len);
+}
+
+#if CRC_DMA
+//#========================================================================
+//#=== Plneni jednotky CRC pres DMA - ZACATEK
+
+static const dma_t    *CRC_dma;
+static const uint32_t *CRC_next;              // Dalsi slova pro DMA
+static uint32_t        CRC_words;             // Zbyvajici slova
+static const uint8_t  *CRC_tail;              // Bajty za poslednim slovem (dopocita crc32_wait())
+static uint8_t         CRC_tail_len;
+static uint32_t        CRC_state;             // Stav bez jednotky (kratka data)
+static volatile int8_t CRC_status;
+
+INLINE_STM32 void CRC_dma_chunk(void) {
+  const uint16_t n = (CRC_words > 0xFFFF) ? 0xFFFF : (uint16_t)CRC_words;
+
+  dma_start(CRC_dma, &CRC->DR, CRC_next, n, DMA_MEM_TO_MEM | DMA_SIZE_32 | DMA_IRQ);
+  CRC_next  += n;
+  CRC_words -= n;
+}
+
+/**
+ * @brief  Udalost DMA (z preruseni) - dalsi blok slov nebo konec.
+ *
+ */
+void CRC_dma_event(void *ctx, uint32_t flags) {
+  (void)ctx;
+
+  if (flags & DMA_FLAG_ERROR) {
+    dma_stop(CRC_dma);
+    CRC_status = -1;
+    CRC_running = 0;
+  } else if (flags & DMA_FLAG_COMPLETE) {
+    if (CRC_words) CRC_dma_chunk();
+    else CRC_running = 0;
+  }
+}
+
+/**
+ * @brief  Spusteni vypoctu na pozadi (slova plni DMA do jednotky CRC, CPU je volne).
+ *         Data musi zustat platna az do crc32_wait().
+ *
+ * @param  crc  Vysledek predchozi casti, 0 na zacatku.
+ *
+ * @return 1 = spusteno, 0 = predchozi vypocet jeste bezi nebo neni volny kanal DMA.
+ */
+int crc32_start(uint32_t crc, const void *data, uint32_t len) {
+  const uint8_t *p = (const uint8_t *)data;
+
+  if (CRC_running) return 0;
+  if (!CRC_ready) crc32_setup();
+  if (!CRC_dma) CRC_dma = dma_alloc(DMA_REQ_MEM);
+  if (!CRC_dma) return 0;
+  dma_callback(CRC_dma, CRC_dma_event, 0);
+
+  CRC_status = 0;
+  CRC_pending = 0;
+  CRC_tail_len = 0;
+  if (len < CRC_HW_MIN) {
+    CRC_state = CRC_sw_state(~crc, p, len);
+    return 1;
+  }
+
+  const uint32_t head = (uint32_t)(-(uintptr_t)p) & 3;
+  const uint32_t state = CRC_sw_state(~crc, p, head);
+  const uint32_t *w = (const uint32_t *)(p + head);
+
+  len -= head;
+  CRC_tail     = p + head + (len & ~3UL);
+  CRC_tail_len = len & 3;
+  CRC_RESET();
+  CRC_IN(*w ^ ~state);                        // Navazani na stav (viz Jednotka CRC)
+  CRC_next  = w + 1;
+  CRC_words = (len >> 2) - 1;
+  CRC_pending = 1;
+  CRC_running = 1;
+  CRC_dma_chunk();
+  return 1;
+}
+
+/**
+ * @brief  Probiha vypocet pres DMA?
+ *
+ */
+INLINE_STM32 int crc32_busy(void) {
+  return CRC_running;
+}
+
+/**
+ * @brief  Cekani na vysledek crc32_start().
+ *
+ * @param  crc CRC-32 vsech dat.
+ *
+ * @return 0 = v poradku, -1 = chyba sbernice DMA (vysledek neplatny).
+ */
+int crc32_wait(uint32_t *crc) {
+  while (CRC_running) {
+    CHRONO_IDLE();
+  }
+
+  uint32_t state = CRC_state;
+  if (CRC_pending) {
+    state = CRC_OUT();
+    CRC_pending = 0;
+  }
+  *crc = ~CRC_sw_state(state, CRC_tail, CRC_tail_len);
+  CRC_tail_len = 0;
+  return CRC_status;
+}
+
+//#=== Plneni jednotky CRC pres DMA - KONEC
+//#========================================================================
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STM32_KIT_CRC */
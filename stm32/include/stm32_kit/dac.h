@@ -0,0 +1,296 @@
+/**
+ * @file       dac.h
+ * @brief      12bit DAC (pouze F407) - vystup tabulky vzorku pres DMA, spousteny casovacem TIM6/TIM7.
+ *
+ *             Kazde preteceni casovace (TRGO) prevede jeden vzorek, DMA mezitim
+ *             pripravi dalsi do DHR. Vystup tak bezi bez ucasti CPU rychlosti az
+ *             stovek kS/s (DAC s vystupnim bufferem se ustali za cca 3 us pri
+ *             plnem rozkmitu, pro male kroky rychleji).
+ *
+ *             Rezimy vystupu (stejne jako wave.h):
+ *               - DAC_start(): tabulka dokola (napr. jedna perioda z DAC_sine()),
+ *               - DAC_stream(): dvojity buffer, po odeslani kazde poloviny se
+ *                 v preruseni DMA zavola funkce pro jeji doplneni.
+ *
+ *             Smerovani: DAC_OUT 1 - PA4, DMA1 Stream5 Channel7,
+ *                        DAC_OUT 2 - PA5, DMA1 Stream6 Channel7 (stream sdileny s ws2812.h),
+ *                        stream prideli dma_alloc().
+ *             Casovac: DAC_TIM 6 (vychozi) nebo 7 (TIM7 pouziva LCD_ASYNC).
+ *
+ * @code
+ *     static uint16_t sine[100];
+ *     DAC_sine(sine, 100, 2000, 2048);     // Jedna perioda, rozkmit +-2000 kolem 2048
+ *     DAC_setup(100000);                   // 100 kS/s -> sinus 1 kHz
+ *     DAC_start(sine, 100);
+ * @endcode
+ *
+ * @author     Petr Madecki (petr.madecki@spsehavirov.cz)
+ * @author     Tomas Michalek (tomas.michalek@spsehavirov.cz)
+ *
+ * @date       2026-10-19
+ * @copyright  Copyright SPSE Havirov (c) 2026
+ */
+#ifndef STM32_KIT_DAC
+#define STM32_KIT_DAC
+
+#include "platform.h"
+#include "gpio.h"
+#include "pin.h"
+#include "timers.h"
+#include "dma.h"
+
+#if !defined(STM32F4) || !defined(DAC)
+# error "DAC je k dispozici pouze na F407 (skolni pripravek)."
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef DAC_OUT
+# define DAC_OUT   1   // 1 = PA4 (DAC_OUT1), 2 = PA5 (DAC_OUT2)
+#endif
+#ifndef DAC_TIM
+# define DAC_TIM   6   // Spousteci casovac TIM6 nebo TIM7
+#endif
+
+#define DAC_MAX    4095
+
+//#========================================================================
+//#=== Smerovani DAC -> DMA - ZACATEK
+#if DAC_OUT == 1
+# define DAC_PIN              PA4
+# define DAC_DHR              DAC->DHR12R1
+# define DAC_REQ              DMA_REQ_DAC1
+#else
+# define DAC_PIN              PA5
+# define DAC_DHR              DAC->DHR12R2
+# define DAC_REQ              DMA_REQ_DAC2
+#endif
+#define DAC_SHIFT  (16 * (DAC_OUT - 1))                // Bity kanalu 2 v CR a SR o 16 vys
+#define DAC_TSEL   ((DAC_TIM == 7) ? 2UL : 0UL)        // TSEL: 000 = TIM6 TRGO, 010 = TIM7 TRGO
+//#=== Smerovani DAC -> DMA - KONEC
+//#========================================================================
+
+/**
+ * @brief Doplneni poloviny bufferu pri DAC_stream().
+ *
+ * @param  samples Prvni vzorek poloviny, ktera byla prave odeslana.
+ * @param  count   Pocet vzorku poloviny.
+ */
+typedef void (*dac_refill_t)(uint16_t *samples, uint16_t count);
+
+static const dma_t *DAC_dma;
+static const tim_t *DAC_tim;
+
+static uint16_t          *DAC_buffer;
+static uint16_t           DAC_count;
+static dac_refill_t       DAC_refill;
+static volatile uint32_t  DAC_underruns; // Doplneni nestihlo odeslani (obe poloviny hotove)
+
+void DAC_dma_event(void *ctx, uint32_t flags);
+
+// Ctvrtina periody sinu, 64 kroku, Q15
+static const int16_t DAC_sin_table[65] = {
+      0,   804,  1608,  2410,  3212,  4011,  4808,  5602,
+   6393,  7179,  7962,  8739,  9512, 10278, 11039, 11793,
+  12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530,
+  18204, 18868, 19519, 20159, 20787, 21403, 22005, 22594,
+  23170, 23731, 24279, 24811, 25329, 25832, 26319, 26790,
+  27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956,
+  30273, 30571, 30852, 31113, 31356, 31580, 31785, 31971,
+  32137, 32285, 32412, 32521, 32609, 32678, 32728, 32757,
+  32767,
+};
+
+/**
+ * @brief  Sinus faze @p phase (cela perioda = 2^32) v Q15, linearni interpolace tabulky.
+ *         Faze je vhodna pro fazovy akumulator v DAC_stream() (libovolna frekvence).
+ *
+ */
+INLINE_STM32 int16_t DAC_sin_q15(uint32_t phase) {
+  const uint32_t quadrant = phase >> 30;
+  uint32_t pos = (phase >> 8) & 0x3FFFFFUL;            // Poloha ve ctvrtine, 22 bitu
+  if (quadrant & 1) pos = 0x400000UL - pos;            // Sestupna ctvrtina - zrcadleni
+
+  const uint32_t index = pos >> 16;                    // 0 - 64
+  const int32_t frac = (int32_t)(pos & 0xFFFFUL);
+  int32_t value = DAC_sin_table[index];
+  if (index < 64) value += ((DAC_sin_table[index + 1] - value) * frac) >> 16;
+
+  return (int16_t)((quadrant & 2) ? -value : value);
+}
+
+/**
+ * @brief  Prevod hodnoty -32768 az 32767 (Q15) na vzorek DAC: offset + amplitude * value.
+ *
+ */
+INLINE_STM32 uint16_t DAC_scale(int32_t value, uint16_t amplitude, uint16_t offset) {
+  int32_t sample = (int32_t)offset + ((value * amplitude) >> 15);
+  if (sample < 0) sample = 0;
+  if (sample > DAC_MAX) sample = DAC_MAX;
+  return (uint16_t)sample;
+}
+
+/**
+ * @brief  Jedna perioda sinu do tabulky.
+ *
+ * @param  samples   Tabulka.
+ * @param  count     Pocet vzorku periody.
+ * @param  amplitude Amplituda (0 - 2047 pro plny rozsah).
+ * @param  offset    Stredni hodnota (2048 = polovina VREF).
+ *
+ */
+void DAC_sine(uint16_t *samples, uint16_t count, uint16_t amplitude, uint16_t offset) {
+  for (uint16_t i = 0; i < count; i++) {
+    samples[i] = DAC_scale(DAC_sin_q15((uint32_t)(((uint64_t)i << 32) / count)), amplitude, offset);
+  }
+}
+
+/**
+ * @brief  Jedna perioda trojuhelniku do tabulky (zacina na minimu).
+ *
+ */
+void DAC_triangle(uint16_t *samples, uint16_t count, uint16_t amplitude, uint16_t offset) {
+  for (uint16_t i = 0; i < count; i++) {
+    const uint32_t phase = (uint32_t)(((uint64_t)i << 32) / count);
+    const int32_t up = (int32_t)(phase >> 15);         // 0 - 131071 za periodu
+    samples[i] = DAC_scale((phase < 0x80000000UL) ? up - 32768 : 98303 - up, amplitude, offset);
+  }
+}
+
+/**
+ * @brief  Jedna perioda pily do tabulky (nabezna, od minima k maximu).
+ *
+ */
+void DAC_sawtooth(uint16_t *samples, uint16_t count, uint16_t amplitude, uint16_t offset) {
+  for (uint16_t i = 0; i < count; i++) {
+    const uint32_t phase = (uint32_t)(((uint64_t)i << 32) / count);
+    samples[i] = DAC_scale((int32_t)(phase >> 16) - 32768, amplitude, offset);
+  }
+}
+
+/**
+ * @brief  Pocatecni inicializace pinu, DAC a spousteciho casovace.
+ *
+ * @param  rate_hz Pocet vzorku za sekundu.
+ *
+ * @return Skutecna frekvence vzorku (omezena rozlisenim PSC/ARR), 0 = stream DMA obsazen.
+ */
+uint32_t DAC_setup(uint32_t rate_hz) {
+  if (!DAC_dma) DAC_dma = dma_alloc(DAC_REQ);
+  if (!DAC_dma) return 0;                     // Stream DMA obsazen jinym ovladacem
+  dma_callback(DAC_dma, DAC_dma_event, 0);
+
+  DAC_tim = TIM_get(DAC_TIM);
+
+  pin_setup(DAC_PIN, PIN_MODE_ANALOG, PIN_PULL_NONE, PIN_SPEED_DEFAULT, PIN_TYPE_DEFAULT);
+  atomic_bit_set(&RCC->APB1ENR, RCC_APB1ENR_DACEN_Pos);
+
+  TIM_enable(DAC_tim);
+  TIM_trgo_update(DAC_tim);
+
+  DAC->CR = (DAC->CR & ~(0xFFFFUL << DAC_SHIFT)) | (DAC_CR_EN1 << DAC_SHIFT); // Vystupni buffer zapnut (BOFF = 0)
+  return TIM_set_rate(DAC_tim, rate_hz);
+}
+
+/**
+ * @brief  Zastaveni vystupu (DAC drzi posledni vzorek).
+ *
+ */
+void DAC_stop(void) {
+  if (!DAC_dma) return;                       // DAC_setup() neuspel
+
+  TIM_stop(DAC_tim);
+  dma_stop(DAC_dma);
+  DAC->CR &= ~((DAC_CR_TEN1 | DAC_CR_TSEL1 | DAC_CR_DMAEN1) << DAC_SHIFT);
+  DAC->SR  = DAC_SR_DMAUDR1 << DAC_SHIFT;
+}
+
+/**
+ * @brief  Primy zapis vzorku (zastavi probihajici vystup).
+ *
+ */
+INLINE_STM32 void DAC_write(uint16_t value) {
+  DAC_stop();
+  DAC_DHR = value & DAC_MAX;                  // Bez spousteni se prevede hned
+}
+
+INLINE_STM32 void DAC_run(const uint16_t *samples, uint16_t count, uint32_t mode) {
+  if (!DAC_dma) return;                       // DAC_setup() neuspel
+
+  DAC_stop();
+
+  DAC_DHR = samples[0];
+  dma_start(DAC_dma, &DAC_DHR, samples, count, DMA_MEM_TO_PERIPH | DMA_SIZE_16 | DMA_CIRCULAR | mode);
+  DAC->CR |= (DAC_CR_TEN1 | (DAC_TSEL << DAC_CR_TSEL1_Pos) | DAC_CR_DMAEN1) << DAC_SHIFT;
+  TIM_start(DAC_tim);
+}
+
+/**
+ * @brief  Vystup tabulky stale dokola.
+ *
+ * @param  samples Tabulka 12bit vzorku (musi existovat po celou dobu vystupu).
+ * @param  count   Pocet vzorku.
+ *
+ */
+void DAC_start(const uint16_t *samples, uint16_t count) {
+  DAC_refill = 0;
+  DAC_run(samples, count, 0);
+}
+
+/**
+ * @brief  Nepretrzity vystup s dvojitym bufferem.
+ *         Obe poloviny se nejdrive naplni, pak se po odeslani kazde poloviny
+ *         v preruseni DMA zavola @p refill pro jeji doplneni.
+ *
+ * @param  buffer Buffer pro obe poloviny.
+ * @param  count  Velikost bufferu (sude cislo).
+ * @param  refill Funkce pro doplneni poloviny bufferu.
+ *
+ */
+void DAC_stream(uint16_t *buffer, uint16_t count, dac_refill_t refill) {
+  const uint16_t half = count / 2;
+
+  DAC_buffer = buffer;
+  DAC_count  = half * 2;
+  DAC_refill = refill;
+
+  refill(buffer, half);
+  refill(buffer + half, half);
+  DAC_run(buffer, DAC_count, DMA_IRQ);
+}
+
+/**
+ * @brief  DAC nestihl vzorek (spousteni rychlejsi nez DMA), vystup je nutne spustit znovu.
+ *
+ */
+INLINE_STM32 int DAC_underrun(void) {
+  return (DAC->SR & (DAC_SR_DMAUDR1 << DAC_SHIFT)) != 0;
+}
+
+/**
+ * @brief  Udalost DMA (z preruseni DMA, pouze DAC_stream()).
+ *
+ */
+void DAC_dma_event(void *ctx, uint32_t flags) {
+  const uint16_t half = DAC_count / 2;
+  (void)ctx;
+
+  if (flags & DMA_FLAG_ERROR) {
+    DAC_stop();
+    return;
+  }
+
+  if (DAC_refill) {
+    if ((flags & DMA_FLAG_HALF) && (flags & DMA_FLAG_COMPLETE)) DAC_underruns++;
+    if (flags & DMA_FLAG_HALF) DAC_refill(DAC_buffer, half);
+    if (flags & DMA_FLAG_COMPLETE) DAC_refill(DAC_buffer + half, half);
+  }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STM32_KIT_DAC */
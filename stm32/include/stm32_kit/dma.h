@@ -0,0 +1,549 @@
+/**
+ * @file       dma.h
+ * @brief      Obsluha DMA (F4: streamy DMA1/DMA2, G0: kanaly DMA1 + DMAMUX).
+ *
+ *             Kanal DMA je popsan strukturou dma_t (stream/kanal, pozadavek, preruseni).
+ *             Ovladace si kanal nevybiraji samy, ziskaji ho podle logickeho
+ *             pozadavku (dma_alloc(DMA_REQ_TIM1_UP) apod.):
+ *               - F4: tabulka smerovani (DMA_routes) urcuje, ktere streamy a kanal
+ *                 CHSEL pozadavek obsluhuji, prideli se prvni volny,
+ *               - G0: pozadavek lze pripojit na libovolny kanal pres DMAMUX,
+ *                 tabulka obsahuje jen cislo pozadavku.
+ *             Obsazeny stream/kanal se dalsimu ovladaci neprideli (dma_alloc() vrati 0).
+ *             Rada L1 zatim podporovana neni (ovladace s DMA jsou jen pro F4 a G0).
+ *
+ *             Obsluhy preruseni DMA definuje tento soubor a predavaji priznaky
+ *             funkci registrovane dma_callback(). Na G0 tak muze vice ovladacu
+ *             sdilet jedno preruseni (kanaly 2 - 3 a 4 - 7). Vlastni obsluhy
+ *             lze pouzit po DMA_IRQ_HANDLERS = 0.
+ *
+ *             Dvojity buffer: v kruhovem rezimu (DMA_CIRCULAR | DMA_IRQ) hlasi
+ *             DMA_FLAG_HALF dokonceni prvni a DMA_FLAG_COMPLETE druhe poloviny.
+ *             dma_start_double() pouziva na F4 hardwarovy rezim DBM (dva samostatne
+ *             buffery), na G0 kruhovy rezim pres oba buffery (musi lezet za sebou).
+ *             Priznaky maji stejny vyznam.
+ *
+ * @code
+ *     static void done(void *ctx, uint32_t flags) { ... }
+ *     const dma_t *tx = dma_alloc(DMA_REQ_TIM1_UP);
+ *     dma_callback(tx, done, 0);
+ *     dma_start(tx, &GPIOD->BSRR, buffer, 64, DMA_MEM_TO_PERIPH | DMA_SIZE_32 | DMA_CIRCULAR | DMA_IRQ);
+ * @endcode
+ *
+ * @author     Petr Madecki (petr.madecki@spsehavirov.cz)
+ * @author     Tomas Michalek (tomas.michalek@spsehavirov.cz)
+ *
+ * @date       2026-10-19
+ * @copyright  Copyright SPSE Havirov (c) 2026
+ */
+#ifndef STM32_KIT_DMA
+#define STM32_KIT_DMA
+
+#include <stdint.h>
+
+#include "platform.h"
+#include "atomic.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef DMA_IRQ_HANDLERS
+# define DMA_IRQ_HANDLERS 1   // 0 = obsluhy preruseni DMA definuje aplikace
+#endif
+
+//#========================================================================
+//#=== Popis kanalu DMA - ZACATEK
+#if defined(STM32F4)
+typedef struct {
+  DMA_TypeDef        *dma;      // DMA1 nebo DMA2
+  DMA_Stream_TypeDef *stream;
+  uint8_t             index;    // Cislo streamu (0 - 7)
+  uint8_t             request;  // Kanal pozadavku CHSEL (0 - 7)
+  IRQn_Type           irq;
+} dma_t;
+#elif defined(STM32G0)
+typedef struct {
+  DMA_Channel_TypeDef    *channel;
+  DMAMUX_Channel_TypeDef *mux;  // DMAMUX1_Channel(x - 1) pro DMA1_Channel(x)
+  uint8_t                 index;    // Cislo kanalu - 1 (0 - 6)
+  uint8_t                 request;  // DMAMUX request ID
+  IRQn_Type               irq;
+} dma_t;
+#else
+# error "DMA neni pro tuto radu implementovano (podporovano: F4, G0)."
+#endif
+//#=== Popis kanalu DMA - KONEC
+//#========================================================================
+
+// Rezim prenosu pro dma_start()
+#define DMA_PERIPH_TO_MEM  (0x00UL)  // Cteni z periferie do pameti
+#define DMA_MEM_TO_PERIPH  (0x01UL)  // Zapis z pameti do periferie
+#define DMA_CIRCULAR       (0x02UL)  // Po poslednim prvku pokracuje od zacatku
+#define DMA_IRQ            (0x04UL)  // Preruseni v polovine, na konci a pri chybe
+#define DMA_FIXED          (0x08UL)  // Adresa v pameti se neposouva (stale stejny prvek)
+#define DMA_MEM_TO_MEM     (0x40UL)  // Z pameti do registru bez pozadavku periferie (kanal DMA_REQ_MEM)
+#define DMA_SIZE_8         (0x00UL)  // Velikost prvku (periferie i pamet)
+#define DMA_SIZE_16        (0x10UL)
+#define DMA_SIZE_32        (0x20UL)
+#define DMA_SIZE_MASK      (0x30UL)
+
+// Priznaky vracene dma_flags()
+#define DMA_FLAG_HALF      (0x01UL)
+#define DMA_FLAG_COMPLETE  (0x02UL)
+#define DMA_FLAG_ERROR     (0x04UL)
+
+/**
+ * @brief Logicke pozadavky DMA (stejne na vsech deskach, smerovani urcuje tabulka rady).
+ */
+typedef enum {
+  DMA_REQ_ADC1,
+  DMA_REQ_DAC1,
+  DMA_REQ_DAC2,
+  DMA_REQ_SPI1_RX,
+  DMA_REQ_SPI1_TX,
+  DMA_REQ_SPI2_RX,
+  DMA_REQ_SPI2_TX,
+  DMA_REQ_I2C1_RX,
+  DMA_REQ_I2C1_TX,
+  DMA_REQ_USART1_RX,
+  DMA_REQ_USART1_TX,
+  DMA_REQ_USART2_RX,
+  DMA_REQ_USART2_TX,
+  DMA_REQ_TIM1_UP,
+  DMA_REQ_TIM1_CH1,
+  DMA_REQ_TIM1_CH2,
+  DMA_REQ_TIM1_CH3,
+  DMA_REQ_TIM2_UP,
+  DMA_REQ_TIM2_CH1,
+  DMA_REQ_TIM2_CH2,
+  DMA_REQ_TIM3_UP,
+  DMA_REQ_TIM3_CH1,
+  DMA_REQ_TIM4_UP,      // Pouze F4
+  DMA_REQ_TIM4_CH1,     // Pouze F4
+  DMA_REQ_TIM6_UP,
+  DMA_REQ_TIM7_UP,
+  DMA_REQ_TIM8_UP,      // Pouze F4 s TIM8
+  DMA_REQ_TIM8_CH1,
+  DMA_REQ_TIM8_CH2,
+  DMA_REQ_TIM15_UP,     // Pouze G0
+  DMA_REQ_TIM15_CH1,
+  DMA_REQ_TIM15_CH2,
+  DMA_REQ_MEM,          // Prenos pamet -> pamet/registr (F4 jen DMA2)
+  DMA_REQ_COUNT
+} dma_request_t;
+
+/**
+ * @brief Obsluha udalosti kanalu (volana z preruseni DMA).
+ *
+ * @param  ctx   Ukazatel predany dma_callback().
+ * @param  flags Kombinace DMA_FLAG_HALF, DMA_FLAG_COMPLETE, DMA_FLAG_ERROR.
+ */
+typedef void (*dma_callback_t)(void *ctx, uint32_t flags);
+
+//#========================================================================
+//#=== Smerovani pozadavku - ZACATEK
+#if defined(STM32F4)
+# define DMA_SLOTS 16   // DMA1 Stream0 - 7, DMA2 Stream0 - 7
+
+# define DMA_STREAM(n, s) { DMA##n, DMA##n##_Stream##s, s, 0, DMA##n##_Stream##s##_IRQn }
+
+static const dma_t DMA_slot[DMA_SLOTS] = {
+  DMA_STREAM(1, 0), DMA_STREAM(1, 1), DMA_STREAM(1, 2), DMA_STREAM(1, 3),
+  DMA_STREAM(1, 4), DMA_STREAM(1, 5), DMA_STREAM(1, 6), DMA_STREAM(1, 7),
+  DMA_STREAM(2, 0), DMA_STREAM(2, 1), DMA_STREAM(2, 2), DMA_STREAM(2, 3),
+  DMA_STREAM(2, 4), DMA_STREAM(2, 5), DMA_STREAM(2, 6), DMA_STREAM(2, 7),
+};
+
+/**
+ * @brief Radek tabulky smerovani: pozadavek -> stream (0 - 7 DMA1, 8 - 15 DMA2) a CHSEL.
+ *        Vice radku pro stejny pozadavek = alternativy, prideli se prvni volna.
+ */
+typedef struct {
+  uint8_t request;
+  uint8_t slot;
+  uint8_t channel;
+} dma_route_t;
+
+static const dma_route_t DMA_routes[] = {   // RM0090, tabulky 42 a 43
+  { DMA_REQ_ADC1,       8, 0 }, { DMA_REQ_ADC1,      12, 0 },
+# ifdef DAC
+  { DMA_REQ_DAC1,       5, 7 },
+  { DMA_REQ_DAC2,       6, 7 },
+# endif
+  { DMA_REQ_SPI1_RX,    8, 3 }, { DMA_REQ_SPI1_RX,   10, 3 },
+  { DMA_REQ_SPI1_TX,   11, 3 }, { DMA_REQ_SPI1_TX,   13, 3 },
+  { DMA_REQ_SPI2_RX,    3, 0 },
+  { DMA_REQ_SPI2_TX,    4, 0 },
+  { DMA_REQ_I2C1_RX,    0, 1 }, { DMA_REQ_I2C1_RX,    5, 1 },
+  { DMA_REQ_I2C1_TX,    6, 1 }, { DMA_REQ_I2C1_TX,    7, 1 },
+  { DMA_REQ_USART1_RX, 10, 4 }, { DMA_REQ_USART1_RX, 13, 4 },
+  { DMA_REQ_USART1_TX, 15, 4 },
+  { DMA_REQ_USART2_RX,  5, 4 },
+  { DMA_REQ_USART2_TX,  6, 4 },
+  { DMA_REQ_TIM1_UP,   13, 6 },
+  { DMA_REQ_TIM1_CH1,   9, 6 }, { DMA_REQ_TIM1_CH1,  11, 6 }, { DMA_REQ_TIM1_CH1, 14, 0 },
+  { DMA_REQ_TIM1_CH2,  10, 6 },
+  { DMA_REQ_TIM1_CH3,  14, 6 },
+  { DMA_REQ_TIM2_UP,    1, 3 }, { DMA_REQ_TIM2_UP,    7, 3 },
+  { DMA_REQ_TIM2_CH1,   5, 3 },
+  { DMA_REQ_TIM2_CH2,   6, 3 },
+  { DMA_REQ_TIM3_UP,    2, 5 },
+  { DMA_REQ_TIM3_CH1,   4, 5 },
+  { DMA_REQ_TIM4_UP,    6, 2 },
+  { DMA_REQ_TIM4_CH1,   0, 2 },
+# ifdef TIM6
+  { DMA_REQ_TIM6_UP,    1, 7 },
+  { DMA_REQ_TIM7_UP,    2, 1 }, { DMA_REQ_TIM7_UP,    4, 1 },
+# endif
+# ifdef TIM8
+  { DMA_REQ_TIM8_UP,    9, 7 },
+  { DMA_REQ_TIM8_CH1,  10, 7 }, { DMA_REQ_TIM8_CH1,  10, 0 },
+  { DMA_REQ_TIM8_CH2,  11, 7 }, { DMA_REQ_TIM8_CH2,  10, 0 },
+# endif
+  { DMA_REQ_MEM,       12, 0 }, { DMA_REQ_MEM,       14, 0 }, { DMA_REQ_MEM,       15, 0 },
+};
+
+static const uint8_t DMA_flag_shift[4] = { 0, 6, 16, 22 }; // Pozice priznaku streamu v LISR/HISR
+
+#elif defined(STM32G0)
+# ifdef DMA1_Channel6
+#  define DMA_SLOTS 7
+# else
+#  define DMA_SLOTS 5
+# endif
+
+static const dma_t DMA_slot[DMA_SLOTS] = {
+  { DMA1_Channel1, DMAMUX1_Channel0, 0, 0, DMA1_Channel1_IRQn },
+  { DMA1_Channel2, DMAMUX1_Channel1, 1, 0, DMA1_Channel2_3_IRQn },
+  { DMA1_Channel3, DMAMUX1_Channel2, 2, 0, DMA1_Channel2_3_IRQn },
+  { DMA1_Channel4, DMAMUX1_Channel3, 3, 0, DMA1_Ch4_7_DMAMUX1_OVR_IRQn },
+  { DMA1_Channel5, DMAMUX1_Channel4, 4, 0, DMA1_Ch4_7_DMAMUX1_OVR_IRQn },
+# ifdef DMA1_Channel6
+  { DMA1_Channel6, DMAMUX1_Channel5, 5, 0, DMA1_Ch4_7_DMAMUX1_OVR_IRQn },
+  { DMA1_Channel7, DMAMUX1_Channel6, 6, 0, DMA1_Ch4_7_DMAMUX1_OVR_IRQn },
+# endif
+};
+
+static const uint8_t DMA_mux_id[DMA_REQ_COUNT] = {   // RM0444, tabulka 59 (0 = pozadavek neexistuje)
+  [DMA_REQ_ADC1]      =  5,
+  [DMA_REQ_DAC1]      =  8, [DMA_REQ_DAC2]      =  9,
+  [DMA_REQ_SPI1_RX]   = 16, [DMA_REQ_SPI1_TX]   = 17,
+  [DMA_REQ_SPI2_RX]   = 18, [DMA_REQ_SPI2_TX]   = 19,
+  [DMA_REQ_I2C1_RX]   = 10, [DMA_REQ_I2C1_TX]   = 11,
+  [DMA_REQ_USART1_RX] = 50, [DMA_REQ_USART1_TX] = 51,
+  [DMA_REQ_USART2_RX] = 52, [DMA_REQ_USART2_TX] = 53,
+  [DMA_REQ_TIM1_UP]   = 25, [DMA_REQ_TIM1_CH1]  = 20, [DMA_REQ_TIM1_CH2] = 21, [DMA_REQ_TIM1_CH3] = 22,
+  [DMA_REQ_TIM2_UP]   = 31, [DMA_REQ_TIM2_CH1]  = 26, [DMA_REQ_TIM2_CH2] = 27,
+  [DMA_REQ_TIM3_UP]   = 37, [DMA_REQ_TIM3_CH1]  = 32,
+  [DMA_REQ_TIM6_UP]   = 38, [DMA_REQ_TIM7_UP]   = 39,
+  [DMA_REQ_TIM15_UP]  = 43, [DMA_REQ_TIM15_CH1] = 40, [DMA_REQ_TIM15_CH2] = 41,
+};
+#endif
+//#=== Smerovani pozadavku - KONEC
+//#========================================================================
+
+static dma_t          DMA_pool[DMA_SLOTS];      // Pridelene kanaly (request doplnen dle smerovani)
+static uint32_t       DMA_used;                 // Bit = slot prideleny
+static dma_callback_t DMA_callbacks[DMA_SLOTS];
+static void          *DMA_contexts[DMA_SLOTS];
+
+/**
+ * @brief  Zapnuti hodin radice DMA, zastaveni kanalu a nastaveni pozadavku (G0: DMAMUX).
+ *
+ */
+void dma_setup(const dma_t *d) {
+#if defined(STM32F4)
+  atomic_bit_set(&RCC->AHB1ENR, (d->dma == DMA1) ? RCC_AHB1ENR_DMA1EN_Pos : RCC_AHB1ENR_DMA2EN_Pos);
+  d->stream->CR &= ~DMA_SxCR_EN;
+  while (d->stream->CR & DMA_SxCR_EN) {} // Stream se zastavi az po dokonceni probihajiciho prenosu
+#else
+  atomic_bit_set(&RCC->AHBENR, RCC_AHBENR_DMA1EN_Pos);
+  d->channel->CCR &= ~DMA_CCR_EN;
+  d->mux->CCR = d->request & DMAMUX_CxCR_DMAREQ_ID;
+#endif
+  NVIC_ClearPendingIRQ(d->irq);
+}
+
+/**
+ * @brief  Prideleni volneho kanalu pro pozadavek a jeho nastaveni (dma_setup()).
+ *
+ * @param  request Logicky pozadavek.
+ *
+ * @return Kanal, nebo 0, pokud pozadavek na teto rade neexistuje nebo jsou jeho kanaly obsazene.
+ */
+const dma_t *dma_alloc(dma_request_t request) {
+  int slot = -1;
+  uint8_t channel = 0;
+
+#if defined(STM32F4)
+  for (unsigned i = 0; i < sizeof(DMA_routes) / sizeof(DMA_routes[0]); i++) {
+    if (DMA_routes[i].request == request && !(DMA_used & (1UL << DMA_routes[i].slot))) {
+      slot = DMA_routes[i].slot;
+      channel = DMA_routes[i].channel;
+      break;
+    }
+  }
+#else
+  channel = (request < DMA_REQ_COUNT) ? DMA_mux_id[request] : 0;
+  for (int i = 0; (channel || request == DMA_REQ_MEM) && i < DMA_SLOTS; i++) { // Pamet: bez DMAMUX (id 0)
+    if (!(DMA_used & (1UL << i))) {
+      slot = i;
+      break;
+    }
+  }
+#endif
+  if (slot < 0) return 0;
+
+  DMA_used |= 1UL << slot;
+  DMA_pool[slot] = DMA_slot[slot];
+  DMA_pool[slot].request = channel;
+  DMA_callbacks[slot] = 0;
+  dma_setup(&DMA_pool[slot]);
+  return &DMA_pool[slot];
+}
+
+/**
+ * @brief  Index kanalu v DMA_pool, nebo -1 pro kanal nepridelany dma_alloc().
+ *
+ */
+INLINE_STM32 int dma_slot(const dma_t *d) {
+  return (d >= DMA_pool && d < DMA_pool + DMA_SLOTS) ? (int)(d - DMA_pool) : -1;
+}
+
+/**
+ * @brief  Registrace obsluhy udalosti kanalu (preruseni povoli dma_start() s DMA_IRQ).
+ *
+ */
+void dma_callback(const dma_t *d, dma_callback_t fn, void *ctx) {
+  const int slot = dma_slot(d);
+  if (slot < 0) return;
+
+  DMA_callbacks[slot] = 0;                    // Obsluha nesmi videt novou funkci se starym ctx
+  DMA_contexts[slot] = ctx;
+  DMA_callbacks[slot] = fn;
+}
+
+/**
+ * @brief  Nacteni a vynulovani priznaku kanalu.
+ *         V rezimu DBM (F4, dma_start_double()) znamena DMA_FLAG_HALF dokonceni
+ *         prvniho a DMA_FLAG_COMPLETE druheho bufferu.
+ *
+ * @return Kombinace DMA_FLAG_HALF, DMA_FLAG_COMPLETE, DMA_FLAG_ERROR.
+ */
+INLINE_STM32 uint32_t dma_flags(const dma_t *d) {
+  uint32_t flags = 0;
+#if defined(STM32F4)
+  const uint32_t shift = DMA_flag_shift[d->index & 3];
+  const uint32_t isr = ((d->index < 4) ? d->dma->LISR : d->dma->HISR) >> shift;
+
+  if (isr & (1UL << 4)) flags |= DMA_FLAG_HALF;         // HTIF
+  if (isr & (1UL << 5)) flags |= DMA_FLAG_COMPLETE;     // TCIF
+  if (isr & (1UL << 3)) flags |= DMA_FLAG_ERROR;        // TEIF
+
+  const uint32_t seen = (isr & 0x3DUL) << shift;        // Nulovat jen prectene priznaky (novy HT/TC se neztrati)
+  if (d->index < 4) d->dma->LIFCR = seen;
+  else d->dma->HIFCR = seen;
+
+  if (d->stream->CR & DMA_SxCR_DBM) {                   // TCIF na konci kazdeho bufferu
+    const uint32_t done = flags & DMA_FLAG_COMPLETE;
+    flags &= ~(DMA_FLAG_HALF | DMA_FLAG_COMPLETE);
+    if (done) flags |= (d->stream->CR & DMA_SxCR_CT) ? DMA_FLAG_HALF : DMA_FLAG_COMPLETE; // CT = buffer, ktery se prave plni
+  }
+#else
+  const uint32_t shift = 4 * d->index;
+  const uint32_t isr = DMA1->ISR >> shift;
+
+  if (isr & (1UL << 2)) flags |= DMA_FLAG_HALF;         // HTIF
+  if (isr & (1UL << 1)) flags |= DMA_FLAG_COMPLETE;     // TCIF
+  if (isr & (1UL << 3)) flags |= DMA_FLAG_ERROR;        // TEIF
+
+  DMA1->IFCR = (isr & 0xEUL) << shift;                  // Jen prectene priznaky (CGIF by nuloval vsechny)
+#endif
+  return flags;
+}
+
+INLINE_STM32 void dma_run(const dma_t *d, volatile void *periph, const void *mem0, const void *mem1, uint16_t count, uint32_t mode) {
+  if (!d) return;                                    // Kanal nepridelen (dma_alloc() vratil 0)
+
+  const uint32_t size = (mode & DMA_SIZE_MASK) >> 4; // 0 = 8bit, 1 = 16bit, 2 = 32bit
+
+#if defined(STM32F4)
+  DMA_Stream_TypeDef *s = d->stream;
+  uint32_t cr = ((uint32_t)d->request << DMA_SxCR_CHSEL_Pos)
+              | (size << DMA_SxCR_PSIZE_Pos) | (size << DMA_SxCR_MSIZE_Pos)
+              | DMA_SxCR_PL_1;
+
+  if (!(mode & DMA_FIXED)) cr |= DMA_SxCR_MINC;
+  if (mode & DMA_MEM_TO_PERIPH) cr |= DMA_SxCR_DIR_0;
+  if (mode & DMA_CIRCULAR) cr |= DMA_SxCR_CIRC;
+  if (mode & DMA_IRQ) cr |= DMA_SxCR_HTIE | DMA_SxCR_TCIE | DMA_SxCR_TEIE;
+  if (mem1) cr = (cr & ~DMA_SxCR_HTIE) | DMA_SxCR_DBM | DMA_SxCR_CIRC; // Bez HT: TC po kazdem bufferu
+
+  s->CR   = 0;
+  while (s->CR & DMA_SxCR_EN) {}                     // Registry lze menit az po zastaveni streamu
+  (void)dma_flags(d);
+  s->PAR  = (uint32_t)periph;
+  s->M0AR = (uint32_t)mem0;
+  s->M1AR = (uint32_t)mem1;
+  s->NDTR = count;
+  s->FCR  = 0;                                       // Primy rezim (bez FIFO)
+  if (mode & DMA_MEM_TO_MEM) {                       // Zdroj je PAR, cil M0AR; vyzaduje FIFO
+    s->PAR  = (uint32_t)mem0;
+    s->M0AR = (uint32_t)periph;
+    s->FCR  = DMA_SxFCR_DMDIS;
+    cr = (cr & ~(DMA_SxCR_MINC | DMA_SxCR_DIR_0 | DMA_SxCR_CIRC)) | DMA_SxCR_DIR_1;
+    if (!(mode & DMA_FIXED)) cr |= DMA_SxCR_PINC;
+  }
+  s->CR   = cr;
+  s->CR  |= DMA_SxCR_EN;
+#else
+  DMA_Channel_TypeDef *c = d->channel;
+  uint32_t ccr = (size << DMA_CCR_PSIZE_Pos) | (size << DMA_CCR_MSIZE_Pos)
+               | DMA_CCR_PL_1;
+
+  (void)mem1;                                        // G0: buffery za sebou (dma_start_double())
+  if (!(mode & DMA_FIXED)) ccr |= DMA_CCR_MINC;
+  if (mode & DMA_MEM_TO_PERIPH) ccr |= DMA_CCR_DIR;
+  if (mode & DMA_CIRCULAR) ccr |= DMA_CCR_CIRC;
+  if (mode & DMA_IRQ) ccr |= DMA_CCR_HTIE | DMA_CCR_TCIE | DMA_CCR_TEIE;
+  if (mode & DMA_MEM_TO_MEM) ccr = (ccr & ~DMA_CCR_CIRC) | DMA_CCR_MEM2MEM | DMA_CCR_DIR; // Cte CMAR, zapisuje CPAR
+
+  c->CCR   = 0;
+  (void)dma_flags(d);
+  c->CPAR  = (uint32_t)periph;
+  c->CMAR  = (uint32_t)mem0;
+  c->CNDTR = count;
+  c->CCR   = ccr;
+  c->CCR  |= DMA_CCR_EN;
+#endif
+
+  if (mode & DMA_IRQ) NVIC_EnableIRQ(d->irq);
+}
+
+/**
+ * @brief  Spusteni prenosu.
+ *
+ * @param  d      Kanal DMA (po dma_setup() nebo z dma_alloc()).
+ * @param  periph Registr periferie.
+ * @param  mem    Buffer v pameti.
+ * @param  count  Pocet prvku (1 - 65535).
+ * @param  mode   Kombinace DMA_MEM_TO_PERIPH, DMA_CIRCULAR, DMA_IRQ, DMA_FIXED a DMA_SIZE_x.
+ *                DMA_MEM_TO_MEM (kanal DMA_REQ_MEM): @p mem se zapisuje do @p periph
+ *                hned po spusteni, bez pozadavku periferie a bez kruhoveho rezimu.
+ *
+ */
+void dma_start(const dma_t *d, volatile void *periph, const void *mem, uint16_t count, uint32_t mode) {
+  dma_run(d, periph, mem, 0, count, mode);
+}
+
+/**
+ * @brief  Nepretrzity prenos stridave ze dvou bufferu (vzdy kruhovy, s prerusenim).
+ *         Po dokonceni bufferu 0 prijde DMA_FLAG_HALF, po bufferu 1 DMA_FLAG_COMPLETE;
+ *         dokonceny buffer lze v obsluze doplnit, DMA mezitim pracuje s druhym.
+ *
+ * @param  mem0, mem1 Buffery (G0: @p mem1 musi lezet hned za @p mem0).
+ * @param  count      Pocet prvku jednoho bufferu.
+ *
+ * @return 0 pri uspechu, -1 pokud buffery nelze pouzit.
+ */
+int dma_start_double(const dma_t *d, volatile void *periph, const void *mem0, const void *mem1, uint16_t count, uint32_t mode) {
+  mode |= DMA_CIRCULAR | DMA_IRQ;
+#if defined(STM32F4)
+  dma_run(d, periph, mem0, mem1, count, mode);
+#else
+  const uint32_t bytes = 1UL << ((mode & DMA_SIZE_MASK) >> 4);
+  if ((const uint8_t *)mem1 != (const uint8_t *)mem0 + (uint32_t)count * bytes || count > 0x7FFF) return -1;
+  dma_run(d, periph, mem0, 0, 2 * count, mode);
+#endif
+  return 0;
+}
+
+/**
+ * @brief  Zastaveni prenosu (d = 0: nic, kanal nebyl pridelen).
+ *
+ */
+INLINE_STM32 void dma_stop(const dma_t *d) {
+  if (!d) return;
+#if defined(STM32F4)
+  d->stream->CR &= ~(DMA_SxCR_EN | DMA_SxCR_HTIE | DMA_SxCR_TCIE | DMA_SxCR_TEIE);
+  while (d->stream->CR & DMA_SxCR_EN) {}
+#else
+  d->channel->CCR &= ~(DMA_CCR_EN | DMA_CCR_HTIE | DMA_CCR_TCIE | DMA_CCR_TEIE);
+#endif
+  (void)dma_flags(d);
+}
+
+/**
+ * @brief  Zastaveni a uvolneni kanalu z dma_alloc().
+ *
+ */
+void dma_free(const dma_t *d) {
+  const int slot = dma_slot(d);
+  if (slot < 0) return;
+
+  dma_stop(d);
+  DMA_callbacks[slot] = 0;
+  DMA_used &= ~(1UL << slot);
+}
+
+/**
+ * @brief  Pocet prvku, ktere zbyva prenest (v kruhovem rezimu pozice v bufferu od konce).
+ *         Pro neprideleny kanal (d = 0) vraci 0.
+ *
+ */
+INLINE_STM32 uint16_t dma_remaining(const dma_t *d) {
+  if (!d) return 0;
+#if defined(STM32F4)
+  return (uint16_t)d->stream->NDTR;
+#else
+  return (uint16_t)d->channel->CNDTR;
+#endif
+}
+
+/**
+ * @brief  Predani priznaku kanalu jeho obsluze (z preruseni DMA).
+ *
+ */
+INLINE_STM32 void dma_dispatch(int slot) {
+  if (!(DMA_used & (1UL << slot))) return;
+
+  const uint32_t flags = dma_flags(&DMA_pool[slot]);    // Nulovat i bez obsluhy (jinak by se preruseni opakovalo)
+  if (flags && DMA_callbacks[slot]) DMA_callbacks[slot](DMA_contexts[slot], flags);
+}
+
+//#========================================================================
+//#=== Obsluhy preruseni DMA - ZACATEK
+#if DMA_IRQ_HANDLERS
+# if defined(STM32F4)
+#  define DMA_HANDLER(n, s) void DMA##n##_Stream##s##_IRQHandler(void) { dma_dispatch(8 * (n - 1) + s); }
+
+DMA_HANDLER(1, 0) DMA_HANDLER(1, 1) DMA_HANDLER(1, 2) DMA_HANDLER(1, 3)
+DMA_HANDLER(1, 4) DMA_HANDLER(1, 5) DMA_HANDLER(1, 6) DMA_HANDLER(1, 7)
+DMA_HANDLER(2, 0) DMA_HANDLER(2, 1) DMA_HANDLER(2, 2) DMA_HANDLER(2, 3)
+DMA_HANDLER(2, 4) DMA_HANDLER(2, 5) DMA_HANDLER(2, 6) DMA_HANDLER(2, 7)
+# else
+void DMA1_Channel1_IRQHandler(void) {
+  dma_dispatch(0);
+}
+
+void DMA1_Channel2_3_IRQHandler(void) {       // Sdilene preruseni - obsluha vsech kanalu s priznaky
+  dma_dispatch(1);
+  dma_dispatch(2);
+}
+
+void DMA1_Ch4_7_DMAMUX1_OVR_IRQHandler(void) {
+  for (int slot = 3; slot < DMA_SLOTS; slot++) {
+    dma_dispatch(slot);
+  }
+}
+# endif
+#endif
+//#=== Obsluhy preruseni DMA - KONEC
+//#========================================================================
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STM32_KIT_DMA */
@@ -0,0 +1,208 @@
+/**
+ * @file       encoder.h
+ * @brief      Inkrementalni (kvadraturni) enkoder - citani v hardware casovace (encoder mode).
+ *
+ *             Kanaly A a B enkoderu jsou pripojeny na vstupy TI1 a TI2 casovace, ktery
+ *             pocita hrany sam (bez ucasti CPU, zadny krok se neztrati ani pri zatizeni).
+ *             16bit citac se rozsiruje na 32 bitu v preruseni pri preteceni/podteceni:
+ *             smer se urci z hodnoty CNT v obsluze (blizko 0 = preteceni nahoru).
+ *             Citac startuje uprostred rozsahu (0x8000), aby kmitani hridele kolem
+ *             pocatecni polohy nezpusobovalo preteceni.
+ *
+ *             Omezeni: preteceni a okamzite podteceni (kmitani presne na hranici rozsahu)
+ *             behem jedine obsluhy preruseni nelze rozlisit.
+ *
+ *             Smerovani (ENC_TIM):
+ *               F4 - TIM2 (32bit, bez preruseni): PA15/PB3 (AF1)
+ *                    TIM3: PA6/PA7 (AF2, na Nucleo sloupce klavesnice), TIM4: PB6/PB7 (AF2)
+ *               G0 - TIM1: PA8/PA9 (AF2), TIM3: PA6/PA7 (AF1)
+ *
+ * @code
+ *     ENC_setup();
+ *     ...
+ *     int32_t position = ENC_position();      // Hrany od ENC_setup()/ENC_set()
+ *     int32_t speed = ENC_velocity(10000);    // Volano kazdych 10 ms -> hrany za sekundu
+ * @endcode
+ *
+ * @author     Petr Madecki (petr.madecki@spsehavirov.cz)
+ * @author     Tomas Michalek (tomas.michalek@spsehavirov.cz)
+ *
+ * @date       2026-10-19
+ * @copyright  Copyright SPSE Havirov (c) 2026
+ */
+#ifndef STM32_KIT_ENCODER
+#define STM32_KIT_ENCODER
+
+#include "platform.h"
+#include "gpio.h"
+#include "pin.h"
+#include "timers.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef ENC_TIM
+# define ENC_TIM     3   // TIM3 (F4 i G0)
+#endif
+#ifndef ENC_MODE
+# define ENC_MODE    3   // 1 = hrany A (x2), 2 = hrany B (x2), 3 = hrany A i B (x4)
+#endif
+#ifndef ENC_FILTER
+# define ENC_FILTER  3   // Digitalni filtr vstupu ICxF (0 = bez filtru, 3 = 8 vzorku)
+#endif
+#ifndef ENC_INVERT
+# define ENC_INVERT  0   // 1 = opacny smer citani
+#endif
+
+//#========================================================================
+//#=== Smerovani casovac -> piny - ZACATEK
+#ifndef ENC_PIN_A
+# if defined(STM32F4) && ENC_TIM == 2
+#  define ENC_PIN_A            PA15
+#  define ENC_PIN_B            PB3
+#  define ENC_AF               PIN_AF1
+# elif defined(STM32F4) && ENC_TIM == 3
+#  define ENC_PIN_A            PA6
+#  define ENC_PIN_B            PA7
+#  define ENC_AF               PIN_AF2
+# elif defined(STM32F4) && ENC_TIM == 4
+#  define ENC_PIN_A            PB6
+#  define ENC_PIN_B            PB7
+#  define ENC_AF               PIN_AF2
+# elif defined(STM32G0) && ENC_TIM == 1
+#  define ENC_PIN_A            PA8
+#  define ENC_PIN_B            PA9
+#  define ENC_AF               PIN_AF2
+# elif defined(STM32G0) && ENC_TIM == 3
+#  define ENC_PIN_A            PA6
+#  define ENC_PIN_B            PA7
+#  define ENC_AF               PIN_AF1
+# endif
+#endif
+
+#ifndef ENC_TIM_IRQ_HANDLER
+# if defined(STM32G0) && ENC_TIM == 1
+#  define ENC_TIM_IRQ_HANDLER  TIM1_BRK_UP_TRG_COM_IRQHandler
+# elif ENC_TIM == 3
+#  define ENC_TIM_IRQ_HANDLER  TIM3_IRQHandler
+# elif ENC_TIM == 4
+#  define ENC_TIM_IRQ_HANDLER  TIM4_IRQHandler
+# endif
+#endif
+//#=== Smerovani casovac -> piny - KONEC
+//#========================================================================
+
+#define ENC_START    0x8000L  // Pocatecni hodnota 16bit citace (stred rozsahu)
+
+static const tim_t     *ENC_tim;
+static volatile int32_t ENC_high;      // Rozsireni citace (nasobky 0x10000, posunute o -ENC_START)
+static int32_t          ENC_last;      // Poloha pri poslednim ENC_velocity()
+
+/**
+ * @brief  Nastaveni polohy (napr. nulovani po najeti na koncovy spinac).
+ *
+ */
+void ENC_set(int32_t position) {
+  TIM_TypeDef *tim = ENC_tim->tim;
+
+  if (ENC_tim->width == 32) {
+    tim->CNT = (uint32_t)position;
+  } else {
+    NVIC_DisableIRQ(ENC_tim->irq);
+    tim->CNT = ENC_START;
+    tim->SR &= ~(TIM_SR_UIF);
+    ENC_high = position - ENC_START;
+    NVIC_EnableIRQ(ENC_tim->irq);
+  }
+  ENC_last = position;
+}
+
+/**
+ * @brief  Pocatecni inicializace pinu a casovace v rezimu enkoderu, poloha 0.
+ *
+ */
+void ENC_setup(void) {
+  ENC_tim = TIM_get(ENC_TIM);
+  TIM_enable(ENC_tim);
+
+  pin_setup_af(ENC_PIN_A, PIN_MODE_AF, PIN_PULL_UP, PIN_SPEED_DEFAULT, PIN_TYPE_DEFAULT, ENC_AF);
+  pin_setup_af(ENC_PIN_B, PIN_MODE_AF, PIN_PULL_UP, PIN_SPEED_DEFAULT, PIN_TYPE_DEFAULT, ENC_AF);
+
+  TIM_TypeDef *tim = ENC_tim->tim;
+  tim->PSC   = 0;
+  tim->ARR   = (ENC_tim->width == 32) ? 0xFFFFFFFFUL : 0xFFFFUL;
+  tim->CCMR1 = (1UL << 0) | ((uint32_t)ENC_FILTER << 4)     // CC1S = 01: IC1 <- TI1 (A)
+             | (1UL << 8) | ((uint32_t)ENC_FILTER << 12);   // CC2S = 01: IC2 <- TI2 (B)
+  tim->CCER  = ENC_INVERT ? (1UL << 1) : 0;                 // CC1P: obraceni kanalu A
+  tim->SMCR  = ENC_MODE;                                    // SMS = 001/010/011: encoder mode
+
+  ENC_set(0);
+  if (ENC_tim->width != 32) TIM_irq_enable(ENC_tim);
+  tim->CR1 |= TIM_CR1_CEN;
+}
+
+/**
+ * @brief  Aktualni poloha (pocet hran, se znamenkem).
+ *
+ */
+int32_t ENC_position(void) {
+  TIM_TypeDef *tim = ENC_tim->tim;
+  int32_t high;
+  uint32_t cnt, sr;
+
+  if (ENC_tim->width == 32) return (int32_t)tim->CNT;
+
+  do {                                        // Konzistentni trojice ENC_high, SR a CNT
+    high = ENC_high;
+    sr   = tim->SR;
+    cnt  = tim->CNT;
+  } while (high != ENC_high || ((tim->SR ^ sr) & TIM_SR_UIF));
+
+  if (sr & TIM_SR_UIF) {                      // Preteceni, ktere obsluha jeste nezpracovala
+    high += (cnt < 0x8000UL) ? 0x10000L : -0x10000L;
+  }
+  return high + (int32_t)cnt;
+}
+
+/**
+ * @brief  Smer posledniho pohybu (1 = nahoru, -1 = dolu).
+ *
+ */
+INLINE_STM32 int ENC_direction(void) {
+  return (ENC_tim->tim->CR1 & TIM_CR1_DIR) ? -1 : 1;
+}
+
+/**
+ * @brief  Rychlost v hranach za sekundu od predchoziho volani.
+ *         Volat v pravidelnem intervalu (napr. z preruseni jineho casovace).
+ *
+ * @param  dt_us Doba od predchoziho volani v us.
+ *
+ */
+int32_t ENC_velocity(uint32_t dt_us) {
+  const int32_t position = ENC_position();
+  const int32_t delta = position - ENC_last;
+
+  ENC_last = position;
+  return dt_us ? (int32_t)((int64_t)delta * 1000000 / dt_us) : 0;
+}
+
+#ifdef ENC_TIM_IRQ_HANDLER                    // 32bit TIM2 preruseni nepotrebuje
+/**
+ * @brief  Obsluha preruseni casovace: rozsireni 16bit citace pri preteceni/podteceni.
+ *
+ */
+void ENC_TIM_IRQ_HANDLER(void) {
+  TIM_TypeDef *tim = ENC_tim->tim;
+
+  tim->SR &= ~(TIM_SR_UIF);
+  ENC_high += (tim->CNT < 0x8000UL) ? 0x10000L : -0x10000L; // Blizko 0 = preteceni nahoru
+}
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STM32_KIT_ENCODER */
@@ -0,0 +1,200 @@
+/**
+ * @file       format.h
+ * @brief      Formatovani cisel pro vystup na LCD a UART (bez stdio a bez haldy).
+ *
+ *             Cislice se ziskavaji odecitanim mocnin deseti, takze neni potreba
+ *             deleni (Cortex-M0+ na G071 nema hardwarovou delicku). Vystup jde
+ *             znak po znaku primo do zvolene vystupni funkce (LCD_symbol, UART_putc).
+ *
+ * @code
+ *     fmt_int(LCD_symbol, -42, 5, ' ');    // "  -42"
+ *     fmt_fixed(UART_putc, 2345, 2, 0);    // "23.45"
+ *     fmt_hex(UART_putc, 0xBEEF, 8);       // "0000BEEF"
+ * @endcode
+ *
+ * @author     Petr Madecki (petr.madecki@spsehavirov.cz)
+ * @author     Tomas Michalek (tomas.michalek@spsehavirov.cz)
+ *
+ * @date       2026-10-19
+ * @copyright  Copyright SPSE Havirov (c) 2026
+ */
+#ifndef STM32_KIT_FORMAT
+#define STM32_KIT_FORMAT
+
+#include <stdint.h>
+
+#include "platform.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FMT_U32_DIGITS  10  // Maximalni pocet cislic uint32_t
+
+/**
+ * @brief Vystupni funkce pro jeden znak (napr. LCD_symbol nebo UART_putc).
+ */
+typedef void (*fmt_sink_t)(uint8_t c);
+
+static const uint32_t fmt_pow10[FMT_U32_DIGITS] = {
+  1000000000UL, 100000000UL, 10000000UL, 1000000UL, 100000UL,
+  10000UL, 1000UL, 100UL, 10UL, 1UL
+};
+
+/**
+ * @brief  Prevod cisla na dekadicke cislice (bez uvodnich nul).
+ *
+ * @param  out   Buffer alespon pro FMT_U32_DIGITS znaku (neukoncuje se '\0').
+ * @param  value Prevadena hodnota.
+ *
+ * @return Pocet zapsanych cislic (1 - 10).
+ */
+int fmt_digits(char *out, uint32_t value) {
+  int len = 0;
+
+  for (int i = 0; i < FMT_U32_DIGITS; i++) {
+    const uint32_t pow = fmt_pow10[i];
+    char digit = '0';
+
+    while (value >= pow) { // Nejvyse 9 odecteni na cislici
+      value -= pow;
+      digit++;
+    }
+
+    if (len || digit != '0' || i == FMT_U32_DIGITS - 1) {
+      out[len++] = digit;
+    }
+  }
+
+  return len;
+}
+
+/**
+ * @brief  Vypis znaku @p c @p count krat.
+ *
+ */
+INLINE_STM32 void fmt_fill(fmt_sink_t sink, char c, int count) {
+  while (count-- > 0) sink(c);
+}
+
+/**
+ * @brief  Vypis cisla zarovnaneho vpravo na sirku @p width.
+ *
+ * @param  sink     Vystupni funkce.
+ * @param  negative Vypsat znamenko minus.
+ * @param  digits   Cislice (viz fmt_digits()).
+ * @param  len      Pocet cislic.
+ * @param  width    Minimalni sirka vystupu (0 = bez zarovnani).
+ * @param  pad      Vyplnovy znak (' ' nebo '0').
+ *
+ */
+void fmt_emit(fmt_sink_t sink, int negative, const char *digits, int len, int width, char pad) {
+  const int fill = width - len - !!negative;
+
+  if (pad == '0') {
+    if (negative) sink('-');
+    fmt_fill(sink, '0', fill);
+  } else {
+    fmt_fill(sink, pad, fill);
+    if (negative) sink('-');
+  }
+
+  for (int i = 0; i < len; i++) sink(digits[i]);
+}
+
+/**
+ * @brief  Vypis cisla bez znamenka.
+ *
+ * @param  sink  Vystupni funkce.
+ * @param  value Vypisovana hodnota.
+ * @param  width Minimalni sirka vystupu (0 = bez zarovnani).
+ * @param  pad   Vyplnovy znak (' ' nebo '0').
+ *
+ */
+void fmt_uint(fmt_sink_t sink, uint32_t value, int width, char pad) {
+  char digits[FMT_U32_DIGITS];
+  const int len = fmt_digits(digits, value);
+
+  fmt_emit(sink, 0, digits, len, width, pad);
+}
+
+/**
+ * @brief  Vypis cisla se znamenkem.
+ *
+ * @param  sink  Vystupni funkce.
+ * @param  value Vypisovana hodnota.
+ * @param  width Minimalni sirka vystupu vcetne znamenka (0 = bez zarovnani).
+ * @param  pad   Vyplnovy znak (' ' nebo '0').
+ *
+ */
+void fmt_int(fmt_sink_t sink, int32_t value, int width, char pad) {
+  char digits[FMT_U32_DIGITS];
+  const uint32_t magnitude = (value < 0) ? 0UL - (uint32_t)value : (uint32_t)value;
+  const int len = fmt_digits(digits, magnitude);
+
+  fmt_emit(sink, value < 0, digits, len, width, pad);
+}
+
+/**
+ * @brief  Vypis cisla s pevnou desetinnou carkou.
+ *
+ *         Hodnota je predana jako cele cislo vynasobene 10^decimals, napr.
+ *         teplota 23.45 C jako 2345 s decimals = 2.
+ *
+ * @param  sink     Vystupni funkce.
+ * @param  value    Hodnota vynasobena 10^decimals.
+ * @param  decimals Pocet desetinnych mist (0 - 9).
+ * @param  width    Minimalni sirka vystupu vcetne znamenka a tecky (0 = bez zarovnani).
+ *
+ */
+void fmt_fixed(fmt_sink_t sink, int32_t value, int decimals, int width) {
+  char digits[FMT_U32_DIGITS + 1];
+  const uint32_t magnitude = (value < 0) ? 0UL - (uint32_t)value : (uint32_t)value;
+  int len = fmt_digits(digits, magnitude);
+
+  if (decimals <= 0) {
+    fmt_emit(sink, value < 0, digits, len, width, ' ');
+    return;
+  }
+
+  const int lead = (len > decimals) ? 0 : decimals - len + 1; // Chybejici nuly, napr. 5 -> "0.05"
+  const int total = len + lead + 1 + (value < 0);
+
+  fmt_fill(sink, ' ', width - total);
+  if (value < 0) sink('-');
+
+  for (int i = 0; i < lead + len; i++) {
+    if (i == lead + len - decimals) sink('.');
+    sink((i < lead) ? '0' : digits[i - lead]);
+  }
+}
+
+/**
+ * @brief  Vypis cisla v sestnactkove soustave (velka pismena, bez "0x").
+ *
+ * @param  sink   Vystupni funkce.
+ * @param  value  Vypisovana hodnota.
+ * @param  digits Pocet vypsanych cislic (1 - 8), horni cislice se orizne.
+ *
+ */
+void fmt_hex(fmt_sink_t sink, uint32_t value, int digits) {
+  static const char hex[] = "0123456789ABCDEF";
+
+  for (int shift = 4 * (digits - 1); shift >= 0; shift -= 4) {
+    sink(hex[(value >> shift) & 0x0F]);
+  }
+}
+
+/**
+ * @brief  Vypis retezce ukonceneho '\0'.
+ *
+ */
+INLINE_STM32 void fmt_str(fmt_sink_t sink, const char *text) {
+  while (*text) sink(*text++);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STM32_KIT_FORMAT */
@@ -12,6 +12,7 @@
 #define STM32_KIT_GPIO
 
 #include "platform.h"
+#include "atomic.h"
 #include <assert.h>
 
 #ifdef __cplusplus
@@ -170,14 +171,26 @@ INLINE_STM32 int io_read(enum pin pin) {
     return READ_BIT(io_port(pin)->IDR, (1UL << io_pin(pin))) >> io_pin(pin);
 }
 
-//#=== Makro pro negaci zadaneho bitu v zadanem registru.
-#define TOGGLE_BIT(REG, BIT)    ((REG) ^= (1UL << (BIT)))
+/**
+ * @brief Toggle the output pin
+ *
+ * Atomic toggle of the ODR bit (safe against interrupts changing
+ * other pins of the same port, see atomic.h)
+ *
+ * @param pin Pin to be toggled
+ */
+INLINE_STM32 void io_toggle(enum pin pin) {
+    atomic_bit_toggle(&io_port(pin)->ODR, io_pin(pin));
+}
+
+//#=== Makro pro negaci zadaneho bitu v zadanem registru (atomicky, viz atomic.h).
+#define TOGGLE_BIT(REG, BIT)    atomic_bit_toggle(&(REG), (BIT))
 
 //#=======================================================================
-//#=== Makra pro nastaveni funkce pinu - ZACATEK
-#define SET_PIN_MODE(GPIOx, PIN, MODE)    ((GPIOx)->MODER |= ((MODE) << (PIN)))
-#define CLR_PIN_MODE(GPIOx, PIN)          ((GPIOx)->MODER &= ~(3UL << (PIN)))
-//#=== Makra pro nastaveni funkce pinu - KONEC
+//#=== Makra pro nastaveni funkce pinu (atomicky, viz atomic.h) - ZACATEK
+#define SET_PIN_MODE(GPIOx, PIN, MODE)    atomic_modify(&(GPIOx)->MODER, (uint32_t)(MODE) << (PIN), (uint32_t)(MODE) << (PIN))
+#define CLR_PIN_MODE(GPIOx, PIN)          atomic_modify(&(GPIOx)->MODER, 3UL << (PIN), 0)
+//#=== Makra pro nastaveni funkce pinu (atomicky, viz atomic.h) - KONEC
 //#=======================================================================
 
 //#=======================================================================
@@ -192,28 +205,117 @@ static uint8_t STM32_port_name[] = {
 //#=======================================================================
 //#=== Aktivace/deaktivace portu - ZACATEK
 
+#define GPIO_PORTS  (sizeof(STM32_port_name))
+
+// Pouzivane piny kazdeho portu (bitova maska), hodiny portu bezi, dokud je
+// pouzivan alespon jeden jeho pin. Pocet bitu = pocet referenci na port.
+// Zmena masky a zapis do RCC musi byt nedelitelne (jinak by jiny kontext mohl
+// pouzit port pred zapnutim nebo po vypnuti hodin), proto probihaji v jedne
+// kriticke sekci (PRIMASK) - uvnitr uz staci obycejny zapis registru.
+static volatile uint16_t GPIO_port_pins[GPIO_PORTS];
+
+/**
+ * @brief  Zapocitani pinu jako pouzivaneho (bez zapisu do RCC, volat v kriticke sekci).
+ *
+ * @return Bitova maska portu, kterym je nutne zapnout hodiny (prvni pin portu).
+ */
+INLINE_STM32 uint32_t GPIO_pin_claim(enum pin pin) {
+  const uint32_t port = io_port_source(io_port(pin));
+  if (port >= GPIO_PORTS) return 0;
+
+  const uint32_t first = !GPIO_port_pins[port];
+  GPIO_port_pins[port] |= io_pin_pos(pin);
+  return first << port;
+}
+
 /**
  * @brief  Aktivace CLK na portu.
+ *         Pin se zapocita jako pouzivany, hodiny se zapnou s prvnim pinem portu.
+ *         Opakovane volani pro stejny pin se zapocita jen jednou.
  *
  * @param  pin Pin pro aktivaci hodinoveho signalu
  *
  */
 void GPIO_clock_enable(enum pin pin) {
-  const uint32_t source = 1UL << io_port_source(io_port(pin));
-  SET_BIT(RCC->IO_ENABLE, source);
+  const uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  const uint32_t enable = GPIO_pin_claim(pin);
+  if (enable) RCC->IO_ENABLE |= enable;
+  __set_PRIMASK(primask);
 }
 
 /**
  * @brief  Deaktivace CLK na portu.
+ *         Pin se uvolni a prepne do analogoveho rezimu (MODER = 11, nejnizsi spotreba,
+ *         vystup i pull-up/down prestanou pusobit), hodiny portu se vypnou az
+ *         s poslednim pouzivanym pinem. Pin, ktery neni zapocitany, se nemeni.
  *
  * @param  pin Pin pro deaktivaci hodinoveho signalu
  *
  */
 void GPIO_clock_disable(enum pin pin) {
-  const uint32_t source = 1UL << io_port_source(io_port(pin));
-  CLEAR_BIT(RCC->IO_ENABLE, source);
+  const uint32_t port = io_port_source(io_port(pin));
+  if (port >= GPIO_PORTS) return;
+
+  const uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  if (GPIO_port_pins[port] & io_pin_pos(pin)) { // Test uvnitr sekce - pin neuvolni dva kontexty
+    io_port(pin)->MODER |= 3UL << (2 * io_pin(pin));
+    GPIO_port_pins[port] &= ~io_pin_pos(pin);
+    if (!GPIO_port_pins[port]) {
+      RCC->IO_ENABLE &= ~(1UL << port);
+    }
+  }
+  __set_PRIMASK(primask);
 }
 
+/**
+ * @brief  Pocet pouzivanych pinu portu.
+ *
+ * @param  port Index portu (0 = GPIOA).
+ *
+ */
+INLINE_STM32 int GPIO_port_users(uint32_t port) {
+  int count = 0;
+  for (uint16_t pins = (port < GPIO_PORTS) ? GPIO_port_pins[port] : 0; pins; pins &= pins - 1) {
+    count++;
+  }
+  return count;
+}
+
+/**
+ * @brief  Porty se zapnutymi hodinami (bitova maska, bit 0 = GPIOA).
+ *
+ */
+INLINE_STM32 uint32_t GPIO_clock_active(void) {
+  uint32_t active = 0;
+  for (uint32_t port = 0; port < GPIO_PORTS; port++) {
+    if (GPIO_port_pins[port]) active |= 1UL << port;
+  }
+  return active;
+}
+
+/**
+ * @brief  Vypis aktivnich portu a poctu pouzivanych pinu, napr. "D:8 E:9".
+ *
+ * @param  sink Vystupni funkce (napr. UART_putc, LCD_putc; stejny typ jako fmt_sink_t).
+ *
+ */
+void GPIO_clock_report(void (*sink)(uint8_t c)) {
+  int first = 1;
+
+  for (uint32_t port = 0; port < GPIO_PORTS; port++) {
+    if (!GPIO_port_pins[port]) continue;
+    const int users = GPIO_port_users(port); // 1 - 16
+
+    if (!first) sink(' ');
+    sink(STM32_port_name[port]);
+    sink(':');
+    if (users >= 10) sink((uint8_t)('0' + users / 10));
+    sink((uint8_t)('0' + users % 10));
+    first = 0;
+  }
+}
 
 //#=== Aktivace/deaktivace portu - KONEC
 //#=======================================================================
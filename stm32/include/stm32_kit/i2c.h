@@ -0,0 +1,622 @@
+/**
+ * @file       i2c.h
+ * @brief      I2C master rizeny prerusenim a DMA s frontou transakci (F4 i G0).
+ *
+ *             Transakce (i2c_xfer_t) je zapis, cteni, nebo zapis a cteni
+ *             s opakovanym START (napr. adresa registru senzoru a jeho hodnota).
+ *             I2C_submit() ji zaradi do fronty a hned se vrati, stavovy automat
+ *             v preruseni I2C a DMA ji provede a spusti dalsi transakci ve fronte.
+ *             Hlavni smycka tak pri cteni senzoru neceka na sbernici.
+ *             Transakce bez dat (tx_len = rx_len = 0) jen vysle adresu (I2C_probe()).
+ *
+ *             F4 (puvodni I2C): data pres DMA, konec zapisu hlasi BTF, konec cteni
+ *             DMA (LAST = NACK po poslednim bajtu); jediny bajt se cte v preruseni RXNE.
+ *             Rychlost nejvyse 400 kHz (fast mode, DUTY = 0).
+ *             G0 (I2C s TIMINGR): data pres DMA, adresu, START/STOP a pocet bajtu
+ *             (NBYTES, po 255 s RELOAD) ridi periferie, preruseni jen TC, STOPF a chyby.
+ *             TIMINGR se pocita z PCLK pro 100 kHz, 400 kHz i 1 MHz (piny ve FM+).
+ *
+ *             Zaseknuta sbernice (slave drzi SDA po resetu uprostred cteni):
+ *             I2C_setup() a I2C_recover() vyslou az 9 hodinovych pulzu na SCL
+ *             a STOP, pak periferii resetuji. I2C_recover() ukonci probihajici
+ *             transakci s I2C_ERROR, aplikace ho vola, kdyz transakce nedobehne.
+ *
+ *             Smerovani: I2C1 - SCL PB8, SDA PB9 (F4 AF4, G0 AF6, Arduino D15/D14 na Nucleo),
+ *                        pozadavky DMA I2C1_RX/TX, streamy/kanaly prideli dma_alloc().
+ *
+ * @code
+ *     I2C_setup(400000);
+ *
+ *     static const uint8_t reg = 0x0F;              // WHO_AM_I
+ *     static uint8_t id;
+ *     static i2c_xfer_t x = { .addr = 0x1E, .tx = &reg, .tx_len = 1, .rx = &id, .rx_len = 1 };
+ *     I2C_submit(&x);                               // Na pozadi (I2C_wait(&x) nebo x.done)
+ *
+ *     I2C_write(0x27, data, sizeof(data));          // Blokujici zapis
+ * @endcode
+ *
+ * @author     Petr Madecki (petr.madecki@spsehavirov.cz)
+ * @author     Tomas Michalek (tomas.michalek@spsehavirov.cz)
+ *
+ * @date       2026-10-19
+ * @copyright  Copyright SPSE Havirov (c) 2026
+ */
+#ifndef STM32_KIT_I2C
+#define STM32_KIT_I2C
+
+#include "platform.h"
+#include "chrono.h"
+#include "gpio.h"
+#include "pin.h"
+#include "atomic.h"
+#include "dma.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef I2C_QUEUE
+# define I2C_QUEUE  8       // Delka fronty transakci (mocnina 2)
+#endif
+#define I2C_QUEUE_MASK  (I2C_QUEUE - 1)
+
+//#========================================================================
+//#=== Smerovani I2C -> piny, DMA - ZACATEK
+#ifndef I2C_DEV
+# define I2C_DEV              I2C1
+# define I2C_PIN_SCL          PB8
+# define I2C_PIN_SDA          PB9
+# define I2C_REQ_RX           DMA_REQ_I2C1_RX
+# define I2C_REQ_TX           DMA_REQ_I2C1_TX
+# if defined(STM32F4)
+#  define I2C_AF              PIN_AF4
+#  define I2C_ENR             RCC->APB1ENR
+#  define I2C_RSTR            RCC->APB1RSTR
+#  define I2C_EN_Pos          RCC_APB1ENR_I2C1EN_Pos
+#  define I2C_EV_IRQ          I2C1_EV_IRQn
+#  define I2C_ER_IRQ          I2C1_ER_IRQn
+#  define I2C_EV_IRQ_HANDLER  I2C1_EV_IRQHandler
+#  define I2C_ER_IRQ_HANDLER  I2C1_ER_IRQHandler
+# elif defined(STM32G0)
+#  define I2C_AF              PIN_AF6
+#  define I2C_ENR             RCC->APBENR1
+#  define I2C_RSTR            RCC->APBRSTR1
+#  define I2C_EN_Pos          RCC_APBENR1_I2C1EN_Pos
+#  define I2C_IRQ             I2C1_IRQn
+#  define I2C_IRQ_HANDLER     I2C1_IRQHandler
+#  define I2C_FMP             (SYSCFG_CFGR1_I2C_PB8_FMP | SYSCFG_CFGR1_I2C_PB9_FMP)
+# else
+#  error "I2C neni pro tuto radu implementovano (podporovano: F4, G0)."
+# endif
+#endif
+//#=== Smerovani I2C -> piny, DMA - KONEC
+//#========================================================================
+
+// Stav transakce (i2c_xfer_t.status)
+#define I2C_DONE     0
+#define I2C_QUEUED   1
+#define I2C_ACTIVE   2
+#define I2C_NACK    -1      // Zarizeni nepotvrdilo adresu nebo data
+#define I2C_ERROR   -2      // Chyba sbernice, ztrata arbitraze, I2C_recover()
+
+typedef struct i2c_xfer i2c_xfer_t;
+
+/**
+ * @brief Dokonceni transakce (volano z preruseni, muze zaradit dalsi transakci).
+ */
+typedef void (*i2c_done_t)(i2c_xfer_t *x);
+
+struct i2c_xfer {
+  uint8_t          addr;    // 7bit adresa zarizeni
+  const uint8_t   *tx;      // Data k zapisu
+  uint16_t         tx_len;  // 0 = jen cteni
+  uint8_t         *rx;      // Buffer pro cteni (po opakovanem START)
+  uint16_t         rx_len;  // 0 = jen zapis
+  volatile int8_t  status;  // I2C_QUEUED, I2C_ACTIVE, I2C_DONE, I2C_NACK, I2C_ERROR
+  i2c_done_t       done;    // 0 = bez oznameni
+  void            *ctx;     // Libovolna data pro @p done
+};
+
+static const dma_t       *I2C_rx_dma, *I2C_tx_dma;
+static i2c_xfer_t *volatile I2C_queue[I2C_QUEUE];
+static volatile uint16_t  I2C_head;     // Zapis (I2C_submit), index bezi volne a maskuje se
+static volatile uint16_t  I2C_tail;     // Probihajici transakce
+static volatile uint8_t   I2C_running;
+static volatile uint8_t   I2C_reading;  // Faze probihajici transakce (0 = zapis, 1 = cteni)
+static uint32_t           I2C_hz;       // Pozadovana rychlost (pro I2C_recover())
+#if defined(STM32G0)
+static volatile int8_t    I2C_result;   // Vysledek transakce hlaseny az se STOPF
+static volatile uint16_t  I2C_left;     // Bajty faze za aktualnim blokem NBYTES
+#endif
+
+void I2C_next(void);
+#if defined(STM32F4)
+void I2C_dma_event(void *ctx, uint32_t flags);
+#endif
+
+/**
+ * @brief  Frekvence hodin periferie I2C (PCLK1 / PCLK).
+ *
+ */
+INLINE_STM32 uint32_t I2C_pclk(void) {
+#if defined(STM32F4)
+  const uint32_t ppre = (RCC->CFGR & RCC_CFGR_PPRE1) >> RCC_CFGR_PPRE1_Pos;
+#else
+  const uint32_t ppre = (RCC->CFGR & RCC_CFGR_PPRE) >> RCC_CFGR_PPRE_Pos;
+#endif
+  return (ppre & 4) ? (SystemCoreClock >> ((ppre & 3) + 1)) : SystemCoreClock; // 1xx = deleni 2^(xx + 1)
+}
+
+/**
+ * @brief  Reset periferie a nastaveni casovani SCL.
+ *
+ * @param  hz 100000, 400000 nebo 1000000 (F4 nejvyse 400000).
+ *
+ * @return Skutecna frekvence SCL (bez doby nabehu hran).
+ */
+uint32_t I2C_init(uint32_t hz) {
+  const uint32_t pclk = I2C_pclk();
+  uint32_t actual;
+
+  atomic_bit_set(&I2C_ENR, I2C_EN_Pos);
+  atomic_bit_set(&I2C_RSTR, I2C_EN_Pos);      // Reset (stejny bit v registru resetu)
+  atomic_bit_clear(&I2C_RSTR, I2C_EN_Pos);
+
+#if defined(STM32F4)
+  const uint32_t mhz = pclk / 1000000;
+  uint32_t ccr;
+
+  if (hz > 400000) hz = 400000;
+  I2C_DEV->CR2 = mhz | I2C_CR2_ITEVTEN | I2C_CR2_ITERREN;
+  if (hz <= 100000) {                         // Standard mode: Tlow = Thigh = CCR
+    ccr = (pclk + 2 * hz - 1) / (2 * hz);
+    if (ccr < 4) ccr = 4;
+    actual = pclk / (2 * ccr);
+    I2C_DEV->TRISE = mhz + 1;                 // 1000 ns
+  } else {                                    // Fast mode, DUTY = 0: Tlow = 2 * CCR, Thigh = CCR
+    ccr = (pclk + 3 * hz - 1) / (3 * hz);
+    if (ccr < 1) ccr = 1;
+    actual = pclk / (3 * ccr);
+    ccr |= I2C_CCR_FS;
+    I2C_DEV->TRISE = mhz * 300 / 1000 + 1;    // 300 ns
+  }
+  I2C_DEV->CCR = ccr;
+  I2C_DEV->CR1 = I2C_CR1_PE;
+
+  NVIC_EnableIRQ(I2C_EV_IRQ);
+  NVIC_EnableIRQ(I2C_ER_IRQ);
+#else
+  // Tlow = 60 %, Thigh = 40 % periody (splni minima SM, FM i FM+)
+  const uint32_t fmp  = hz > 400000;
+  const uint64_t low  = ((uint64_t)pclk * 3 + 5ULL * hz - 1) / (5ULL * hz);     // Takty PCLK
+  const uint64_t high = ((uint64_t)pclk * 2 + 5ULL * hz - 1) / (5ULL * hz);
+  const uint32_t tsu  = (hz <= 100000) ? 1250 : (hz <= 400000) ? 400 : 170;   // tr + tSU;DAT [ns]
+  const uint32_t thd  = fmp ? 120 : 300;                                      // tf [ns]
+  const uint64_t su   = ((uint64_t)pclk * tsu + 999999999ULL) / 1000000000ULL;
+  const uint64_t hd   = ((uint64_t)pclk * thd + 999999999ULL) / 1000000000ULL;
+
+  uint64_t presc = (low + 255) / 256;
+  if ((su + 15) / 16 > presc) presc = (su + 15) / 16;
+  if (presc < 1) presc = 1;
+  if (presc > 16) presc = 16;
+
+  uint64_t scll   = (low + presc - 1) / presc;    // Zaokrouhleni nahoru: minima Tlow a Thigh
+  uint64_t sclh   = (high + presc - 1) / presc;
+  uint64_t scldel = (su + presc - 1) / presc;
+  uint64_t sdadel = (hd + presc - 1) / presc;
+  if (scll < 2) scll = 2;
+  if (scll > 256) scll = 256;
+  if (sclh < 1) sclh = 1;
+  if (sclh > 256) sclh = 256;
+  if (scldel < 1) scldel = 1;
+  if (scldel > 16) scldel = 16;
+  if (sdadel > 15) sdadel = 15;
+  actual = (uint32_t)(pclk / (presc * (scll + sclh)));
+
+  if (fmp) {                                  // Piny ve Fast-mode Plus (proud 20 mA)
+    atomic_bit_set(&RCC->APBENR2, RCC_APBENR2_SYSCFGEN_Pos);
+    SYSCFG->CFGR1 |= I2C_FMP;
+  }
+  I2C_DEV->TIMINGR = (uint32_t)((presc - 1) << I2C_TIMINGR_PRESC_Pos | (scldel - 1) << I2C_TIMINGR_SCLDEL_Pos
+                   | sdadel << I2C_TIMINGR_SDADEL_Pos | (sclh - 1) << I2C_TIMINGR_SCLH_Pos | (scll - 1));
+  I2C_DEV->CR1 = I2C_CR1_ERRIE | I2C_CR1_TCIE | I2C_CR1_STOPIE | I2C_CR1_NACKIE
+               | I2C_CR1_TXDMAEN | I2C_CR1_RXDMAEN;
+  I2C_DEV->CR1 |= I2C_CR1_PE;
+
+  NVIC_EnableIRQ(I2C_IRQ);
+#endif
+  return actual;
+}
+
+/**
+ * @brief  Pulperioda SCL pri uvolnovani sbernice (priblizne 10 us, nejvyse 100 kHz).
+ *
+ */
+INLINE_STM32 void I2C_spin(void) {
+  for (volatile uint32_t i = SystemCoreClock / 400000; i; i--) {}
+}
+
+/**
+ * @brief  Uvolneni sbernice: dokud slave drzi SDA v log. 0, az 9 pulzu na SCL, pak STOP.
+ *         Piny jsou na konci opet v rezimu AF.
+ *
+ * @return 1 = SDA je volna, 0 = SDA stale v log. 0 (zkrat, porucha slave).
+ */
+int I2C_bus_clear(void) {
+  io_set(I2C_PIN_SCL, 1);
+  io_set(I2C_PIN_SDA, 1);
+  pin_setup(I2C_PIN_SCL, PIN_MODE_OUTPUT, PIN_PULL_UP, PIN_SPEED_DEFAULT, PIN_TYPE_OPENDRAIN);
+  pin_setup(I2C_PIN_SDA, PIN_MODE_OUTPUT, PIN_PULL_UP, PIN_SPEED_DEFAULT, PIN_TYPE_OPENDRAIN);
+  I2C_spin();
+
+  for (int i = 0; i < 9 && !io_get(I2C_PIN_SDA); i++) {
+    io_set(I2C_PIN_SCL, 0);
+    I2C_spin();
+    io_set(I2C_PIN_SCL, 1);
+    I2C_spin();
+  }
+  io_set(I2C_PIN_SDA, 0);                     // STOP: SDA 0 -> 1 pri SCL v log. 1
+  I2C_spin();
+  io_set(I2C_PIN_SDA, 1);
+  I2C_spin();
+  const int free = io_get(I2C_PIN_SDA);
+
+  pin_setup_af(I2C_PIN_SCL, PIN_MODE_AF, PIN_PULL_UP, PIN_SPEED_HIGH, PIN_TYPE_OPENDRAIN, I2C_AF);
+  pin_setup_af(I2C_PIN_SDA, PIN_MODE_AF, PIN_PULL_UP, PIN_SPEED_HIGH, PIN_TYPE_OPENDRAIN, I2C_AF);
+  return free;
+}
+
+/**
+ * @brief  Pocatecni inicializace pinu, kanalu DMA a periferie (vcetne uvolneni sbernice).
+ *         Piny maji vnitrni pull-up, pro 400 kHz a vic jsou nutne vnejsi (2k2 - 4k7).
+ *
+ * @param  hz Rychlost SCL: 100000, 400000 nebo 1000000 (jen G0).
+ *
+ * @return Skutecna frekvence SCL, 0 = neni volny kanal DMA.
+ */
+uint32_t I2C_setup(uint32_t hz) {
+  if (!I2C_rx_dma) I2C_rx_dma = dma_alloc(I2C_REQ_RX);
+  if (!I2C_tx_dma) I2C_tx_dma = dma_alloc(I2C_REQ_TX);
+  if (!I2C_rx_dma || !I2C_tx_dma) {          // Stream/kanal DMA obsazen jinym ovladacem
+    dma_free(I2C_rx_dma);                     //  - uvolnit i ten prideleny
+    dma_free(I2C_tx_dma);
+    I2C_rx_dma = I2C_tx_dma = 0;
+    return 0;
+  }
+#if defined(STM32F4)
+  dma_callback(I2C_rx_dma, I2C_dma_event, 0); // Konec cteni (G0: vse hlasi preruseni I2C)
+#endif
+
+  I2C_hz = hz;
+  I2C_bus_clear();
+  return I2C_init(hz);
+}
+
+/**
+ * @brief  Dokonceni transakce na konci fronty: stav, oznameni.
+ *
+ */
+INLINE_STM32 void I2C_finish(i2c_xfer_t *x, int8_t status) {
+  I2C_tail++;
+  x->status = status;
+  if (x->done) x->done(x);
+}
+
+/**
+ * @brief  Ukonceni probihajici transakce po chybe (zastavi DMA).
+ *
+ */
+void I2C_abort(int8_t status) {
+  dma_stop(I2C_rx_dma);
+  dma_stop(I2C_tx_dma);
+#if defined(STM32F4)
+  I2C_DEV->CR2 &= ~(I2C_CR2_DMAEN | I2C_CR2_LAST | I2C_CR2_ITBUFEN);
+#endif
+  I2C_finish(I2C_queue[I2C_tail & I2C_QUEUE_MASK], status);
+  I2C_next();
+}
+
+#if defined(STM32G0)
+/**
+ * @brief  Spusteni faze zapisu nebo cteni (START, adresa, NBYTES, DMA).
+ *         Po zapisu, za kterym nasleduje cteni, neni AUTOEND: TC spusti cteni opakovanym START.
+ *
+ */
+void I2C_phase(const i2c_xfer_t *x, int reading) {
+  const uint16_t len = reading ? x->rx_len : x->tx_len;
+  uint32_t cr2 = ((uint32_t)x->addr << 1) | I2C_CR2_START | (reading ? I2C_CR2_RD_WRN : 0);
+
+  I2C_reading = reading;
+  if (reading && len) dma_start(I2C_rx_dma, &I2C_DEV->RXDR, x->rx, len, DMA_PERIPH_TO_MEM | DMA_SIZE_8);
+  if (!reading && len) dma_start(I2C_tx_dma, &I2C_DEV->TXDR, x->tx, len, DMA_MEM_TO_PERIPH | DMA_SIZE_8);
+
+  if (len > 255) {
+    I2C_left = len - 255;
+    cr2 |= (255UL << I2C_CR2_NBYTES_Pos) | I2C_CR2_RELOAD;
+  } else {
+    I2C_left = 0;
+    cr2 |= (uint32_t)len << I2C_CR2_NBYTES_Pos;
+    if (reading || !x->rx_len) cr2 |= I2C_CR2_AUTOEND;
+  }
+  I2C_DEV->CR2 = cr2;
+}
+#endif
+
+/**
+ * @brief  Spusteni transakce (START, dalsi kroky ridi preruseni).
+ *
+ */
+INLINE_STM32 void I2C_begin(i2c_xfer_t *x) {
+  x->status = I2C_ACTIVE;
+#if defined(STM32F4)
+  I2C_reading = (x->tx_len == 0 && x->rx_len != 0);
+  while (I2C_DEV->CR1 & I2C_CR1_STOP) {}      // STOP predchozi transakce (RM: do te nezapisovat CR1)
+  I2C_DEV->CR1 |= I2C_CR1_ACK | I2C_CR1_START;
+#else
+  I2C_result = I2C_DONE;
+  I2C_phase(x, x->tx_len == 0 && x->rx_len != 0);
+#endif
+}
+
+/**
+ * @brief  Spusteni dalsi transakce z fronty.
+ *
+ */
+void I2C_next(void) {
+  if (I2C_tail != I2C_head) {
+    I2C_begin(I2C_queue[I2C_tail & I2C_QUEUE_MASK]);
+  } else {
+    I2C_running = 0;
+  }
+}
+
+#if defined(STM32F4)
+/**
+ * @brief  Zapis dokoncen: cteni s opakovanym START, nebo STOP a konec transakce.
+ *
+ */
+INLINE_STM32 void I2C_write_done(i2c_xfer_t *x) {
+  I2C_DEV->CR2 &= ~I2C_CR2_DMAEN;
+  if (x->rx_len) {
+    I2C_reading = 1;
+    I2C_DEV->CR1 |= I2C_CR1_START;
+  } else {
+    I2C_DEV->CR1 |= I2C_CR1_STOP;
+    I2C_finish(x, I2C_DONE);
+    I2C_next();
+  }
+}
+
+/**
+ * @brief  Udalost DMA prijmu (z preruseni DMA) - posledni bajt prijat s NACK.
+ *
+ */
+void I2C_dma_event(void *ctx, uint32_t flags) {
+  (void)ctx;
+  if (!(flags & (DMA_FLAG_COMPLETE | DMA_FLAG_ERROR))) return;   // Polovina prenosu
+
+  I2C_DEV->CR2 &= ~(I2C_CR2_DMAEN | I2C_CR2_LAST);
+  I2C_DEV->CR1 |= I2C_CR1_STOP;
+  I2C_finish(I2C_queue[I2C_tail & I2C_QUEUE_MASK], (flags & DMA_FLAG_ERROR) ? I2C_ERROR : I2C_DONE);
+  I2C_next();
+}
+
+/**
+ * @brief  Obsluha preruseni udalosti I2C (SB, ADDR, BTF, RXNE).
+ *
+ */
+void I2C_EV_IRQ_HANDLER(void) {
+  const uint32_t sr1 = I2C_DEV->SR1;
+  if (!I2C_running) return;
+  i2c_xfer_t *x = I2C_queue[I2C_tail & I2C_QUEUE_MASK];
+
+  if (sr1 & I2C_SR1_SB) {                     // START odeslan: adresa a smer (nuluje SB)
+    I2C_DEV->DR = ((uint32_t)x->addr << 1) | I2C_reading;
+    return;
+  }
+
+  if (sr1 & I2C_SR1_ADDR) {                   // Adresa potvrzena, ADDR nuluje cteni SR2
+    if (!I2C_reading) {
+      if (x->tx_len) {
+        dma_start(I2C_tx_dma, &I2C_DEV->DR, x->tx, x->tx_len, DMA_MEM_TO_PERIPH | DMA_SIZE_8);
+        I2C_DEV->CR2 |= I2C_CR2_DMAEN;
+      }
+      (void)I2C_DEV->SR2;
+      if (!x->tx_len) I2C_write_done(x);      // Jen adresa: BTF neprijde
+    } else if (x->rx_len == 1) {              // Jediny bajt: NACK a STOP uz pri ADDR (RM0090)
+      I2C_DEV->CR1 &= ~I2C_CR1_ACK;
+      (void)I2C_DEV->SR2;
+      I2C_DEV->CR1 |= I2C_CR1_STOP;
+      I2C_DEV->CR2 |= I2C_CR2_ITBUFEN;
+    } else {
+      dma_start(I2C_rx_dma, &I2C_DEV->DR, x->rx, x->rx_len, DMA_PERIPH_TO_MEM | DMA_SIZE_8 | DMA_IRQ);
+      I2C_DEV->CR2 |= I2C_CR2_DMAEN | I2C_CR2_LAST;   // LAST: NACK po poslednim bajtu z DMA
+      (void)I2C_DEV->SR2;
+    }
+    return;
+  }
+
+  if (!I2C_reading && (sr1 & I2C_SR1_BTF) && dma_remaining(I2C_tx_dma) == 0) {
+    I2C_write_done(x);                        // Posledni bajt odvysilan (DMA uz dalsi nema)
+    return;
+  }
+
+  if (I2C_reading && (sr1 & I2C_SR1_RXNE) && x->rx_len == 1) {
+    x->rx[0] = (uint8_t)I2C_DEV->DR;
+    I2C_DEV->CR2 &= ~I2C_CR2_ITBUFEN;
+    I2C_finish(x, I2C_DONE);
+    I2C_next();
+  }
+}
+
+/**
+ * @brief  Obsluha preruseni chyb I2C (NACK, chyba sbernice, ztrata arbitraze).
+ *
+ */
+void I2C_ER_IRQ_HANDLER(void) {
+  const uint32_t sr1 = I2C_DEV->SR1;
+  I2C_DEV->SR1 = ~(sr1 & (I2C_SR1_AF | I2C_SR1_BERR | I2C_SR1_ARLO | I2C_SR1_OVR)) & 0xFFFFUL; // rc_w0
+  if (!I2C_running) return;
+
+  if (!(sr1 & I2C_SR1_ARLO)) I2C_DEV->CR1 |= I2C_CR1_STOP;  // Po ztrate arbitraze sbernici ridi jiny master
+  I2C_abort((sr1 & I2C_SR1_AF) ? I2C_NACK : I2C_ERROR);
+}
+#else
+/**
+ * @brief  Obsluha preruseni I2C (TCR, TC, NACKF, STOPF, chyby).
+ *
+ */
+void I2C_IRQ_HANDLER(void) {
+  const uint32_t isr = I2C_DEV->ISR;
+  if (!I2C_running) {
+    I2C_DEV->ICR = isr & (I2C_ISR_STOPF | I2C_ISR_NACKF | I2C_ISR_BERR | I2C_ISR_ARLO | I2C_ISR_OVR);
+    return;
+  }
+  i2c_xfer_t *x = I2C_queue[I2C_tail & I2C_QUEUE_MASK];
+
+  if (isr & (I2C_ISR_BERR | I2C_ISR_ARLO | I2C_ISR_OVR)) {
+    I2C_DEV->ICR = I2C_ICR_BERRCF | I2C_ICR_ARLOCF | I2C_ICR_OVRCF;
+    I2C_DEV->CR1 &= ~I2C_CR1_PE;              // Reset stavu periferie (PE = 0 alespon 3 takty)
+    (void)I2C_DEV->CR1;
+    I2C_DEV->CR1 |= I2C_CR1_PE;
+    I2C_abort(I2C_ERROR);
+    return;
+  }
+
+  if (isr & I2C_ISR_NACKF) {                  // STOP vysle periferie s AUTOEND, jinak software
+    I2C_DEV->ICR = I2C_ICR_NACKCF;
+    I2C_result = I2C_NACK;
+    if (!(I2C_DEV->CR2 & I2C_CR2_AUTOEND)) I2C_DEV->CR2 |= I2C_CR2_STOP;
+  }
+
+  if (isr & I2C_ISR_STOPF) {
+    I2C_DEV->ICR = I2C_ICR_STOPCF;
+    dma_stop(I2C_rx_dma);
+    dma_stop(I2C_tx_dma);
+    I2C_finish(x, I2C_result);
+    I2C_next();
+    return;
+  }
+
+  if (isr & I2C_ISR_TCR) {                    // Dalsi blok nejvyse 255 bajtu
+    const uint16_t n = (I2C_left > 255) ? 255 : I2C_left;
+    uint32_t cr2 = I2C_DEV->CR2 & ~(I2C_CR2_NBYTES | I2C_CR2_RELOAD | I2C_CR2_AUTOEND);
+
+    I2C_left -= n;
+    cr2 |= (uint32_t)n << I2C_CR2_NBYTES_Pos;
+    if (I2C_left) cr2 |= I2C_CR2_RELOAD;
+    else if (I2C_reading || !x->rx_len) cr2 |= I2C_CR2_AUTOEND;
+    I2C_DEV->CR2 = cr2;
+  } else if (isr & I2C_ISR_TC) {              // Zapis bez AUTOEND dokoncen: cteni s opakovanym START
+    I2C_phase(x, 1);
+  }
+}
+#endif
+
+/**
+ * @brief  Zarazeni transakce do fronty (lze volat i z @p done jine transakce).
+ *         Transakce musi existovat az do dokonceni (status <= I2C_DONE).
+ *
+ * @return 1 = zarazeno, 0 = fronta je plna.
+ */
+int I2C_submit(i2c_xfer_t *x) {
+  const uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+
+  if ((uint16_t)(I2C_head - I2C_tail) >= I2C_QUEUE) {
+    __set_PRIMASK(primask);
+    return 0;
+  }
+  x->status = I2C_QUEUED;
+  I2C_queue[I2C_head & I2C_QUEUE_MASK] = x;
+  I2C_head++;
+  if (!I2C_running) {
+    I2C_running = 1;
+    I2C_next();
+  }
+
+  __set_PRIMASK(primask);
+  return 1;
+}
+
+/**
+ * @brief  Cekani na dokonceni transakce.
+ *
+ * @return I2C_DONE, I2C_NACK nebo I2C_ERROR.
+ */
+INLINE_STM32 int I2C_wait(const i2c_xfer_t *x) {
+  while (x->status > 0) {
+    CHRONO_IDLE();
+  }
+  return x->status;
+}
+
+/**
+ * @brief  Blokujici zapis a/nebo cteni (ve fronte za ostatnimi transakcemi, nevolat z preruseni).
+ *
+ * @return I2C_DONE, I2C_NACK nebo I2C_ERROR.
+ */
+int I2C_transfer(uint8_t addr, const void *tx, uint16_t tx_len, void *rx, uint16_t rx_len) {
+  i2c_xfer_t x = { addr, (const uint8_t *)tx, tx_len, (uint8_t *)rx, rx_len, I2C_DONE, 0, 0 };
+
+  while (!I2C_submit(&x)) {
+    CHRONO_IDLE();
+  }
+  return I2C_wait(&x);
+}
+
+INLINE_STM32 int I2C_write(uint8_t addr, const void *data, uint16_t len) {
+  return I2C_transfer(addr, data, len, 0, 0);
+}
+
+INLINE_STM32 int I2C_read(uint8_t addr, void *data, uint16_t len) {
+  return I2C_transfer(addr, 0, 0, data, len);
+}
+
+/**
+ * @brief  Odpovida zarizeni na adrese (jen adresa a STOP)?
+ *
+ */
+INLINE_STM32 int I2C_probe(uint8_t addr) {
+  return I2C_transfer(addr, 0, 0, 0, 0) == I2C_DONE;
+}
+
+/**
+ * @brief  Probiha prenos (fronta neni prazdna)?
+ *
+ */
+INLINE_STM32 int I2C_busy(void) {
+  return I2C_running;
+}
+
+/**
+ * @brief  Obnoveni po zaseknuti (transakce nedobehla): ukonceni probihajici
+ *         transakce s I2C_ERROR, uvolneni sbernice, reset periferie a pokracovani fronty.
+ *
+ * @return 1 = SDA je volna, 0 = sbernice zustava blokovana.
+ */
+int I2C_recover(void) {
+#if defined(STM32F4)
+  NVIC_DisableIRQ(I2C_EV_IRQ);
+  NVIC_DisableIRQ(I2C_ER_IRQ);
+#else
+  NVIC_DisableIRQ(I2C_IRQ);
+#endif
+  dma_stop(I2C_rx_dma);
+  dma_stop(I2C_tx_dma);
+
+  const int free = I2C_bus_clear();
+  I2C_init(I2C_hz);
+
+  const uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  if (I2C_running) I2C_abort(I2C_ERROR);
+  __set_PRIMASK(primask);
+  return free;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STM32_KIT_I2C */
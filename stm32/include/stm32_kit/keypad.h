@@ -159,15 +159,22 @@ uint8_t KBD_read(void) {
  *
  */
 void KBD_setup(void) {
-  __disable_irq();
+  static const pin_config_t pins[] = {
+    { KEYPAD_C0, PIN_MODE_INPUT,  PIN_PULL_UP,   PIN_SPEED_DEFAULT, PIN_TYPE_DEFAULT,  PIN_AF_NONE, PIN_LEVEL_DEFAULT },
+    { KEYPAD_C1, PIN_MODE_INPUT,  PIN_PULL_UP,   PIN_SPEED_DEFAULT, PIN_TYPE_DEFAULT,  PIN_AF_NONE, PIN_LEVEL_DEFAULT },
+    { KEYPAD_C2, PIN_MODE_INPUT,  PIN_PULL_UP,   PIN_SPEED_DEFAULT, PIN_TYPE_DEFAULT,  PIN_AF_NONE, PIN_LEVEL_DEFAULT },
+#if KEYPAD_COLS >= 4
+    { KEYPAD_C3, PIN_MODE_INPUT,  PIN_PULL_UP,   PIN_SPEED_DEFAULT, PIN_TYPE_DEFAULT,  PIN_AF_NONE, PIN_LEVEL_DEFAULT },
+#endif
+    { KEYPAD_R0, PIN_MODE_OUTPUT, PIN_PULL_NONE, PIN_SPEED_HIGH,    PIN_TYPE_PUSHPULL, PIN_AF_NONE, PIN_LEVEL_DEFAULT },
+    { KEYPAD_R1, PIN_MODE_OUTPUT, PIN_PULL_NONE, PIN_SPEED_HIGH,    PIN_TYPE_PUSHPULL, PIN_AF_NONE, PIN_LEVEL_DEFAULT },
+    { KEYPAD_R2, PIN_MODE_OUTPUT, PIN_PULL_NONE, PIN_SPEED_HIGH,    PIN_TYPE_PUSHPULL, PIN_AF_NONE, PIN_LEVEL_DEFAULT },
+#if KEYPAD_ROWS >= 4
+    { KEYPAD_R3, PIN_MODE_OUTPUT, PIN_PULL_NONE, PIN_SPEED_HIGH,    PIN_TYPE_PUSHPULL, PIN_AF_NONE, PIN_LEVEL_DEFAULT },
+#endif
+  };
 
-  for (int i = 0; KBD_cols[i] != P_INVALID; i++) {
-    pin_setup(KBD_cols[i], PIN_MODE_INPUT, PIN_PULL_UP, PIN_SPEED_DEFAULT, PIN_TYPE_DEFAULT);
-  }
-  for (int i = 0; KBD_rows[i] != P_INVALID; i++) {
-    pin_setup(KBD_rows[i], PIN_MODE_OUTPUT, PIN_PULL_NONE, PIN_SPEED_HIGH, PIN_TYPE_PUSHPULL);
-  }
-  __enable_irq();
+  pin_setup_table(pins, PIN_TABLE_SIZE(pins));
 }
 
 #ifdef __cplusplus
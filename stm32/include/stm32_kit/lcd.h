@@ -1,6 +1,7 @@
 /**
  * @file       lcd.h
- * @brief      Driver pro ovladani LCD v primem pripojeni (4bit komunikace).
+ * @brief      Driver pro ovladani LCD v primem pripojeni (4bit komunikace),
+ *             pripadne pres I2C expander PCF8574 (LCD_I2C).
  *
  * @author     Petr Madecki (petr.madecki@spsehavirov.cz)
  * @author     Tomas Michalek (tomas.michalek@spsehavirov.cz)
@@ -15,6 +16,7 @@
 #include "chrono.h"
 #include "gpio.h"
 #include "pin.h"
+#include "format.h"
 
 #ifndef STRING_H_
 # include <string.h>
@@ -45,6 +47,53 @@
 //#=== Makra pro LCD - KONEC
 //#========================================================================
 
+//#========================================================================
+//#=== Geometrie LCD (LCD_COLS x LCD_ROWS) - ZACATEK
+//
+// DDRAM radice HD44780 ma dve banky po 40 znacich (0x00 a 0x40). Sude radky
+// lezi v bance 0x00, liche v bance 0x40 a u 4-radkovych displeju navazuje
+// 3. (4.) radek primo za 1. (2.) radkem, napr. 20x4: 0x00, 0x40, 0x14, 0x54.
+
+#if (LCD_ROWS != 1) && (LCD_ROWS != 2) && (LCD_ROWS != 4)
+# error "LCD_ROWS musi byt 1, 2 nebo 4!"
+#endif
+
+#define LCD_BANKS         ((LCD_ROWS > 1) ? 2 : 1)             // Pocet pouzitych bank DDRAM
+#define LCD_BANK_LEN      (LCD_COLS * ((LCD_ROWS + 1) / 2))    // Pocet viditelnych znaku v jedne bance
+
+#if (LCD_COLS * ((LCD_ROWS + 1) / 2)) > 40
+# error "Nepodporovana geometrie LCD (displej 40x4 ma dva radice)!"
+#endif
+
+#if (LCD_ROWS > 1)
+# define LCD_FUNCTION_SET (0x28)  // 4bit ; 2 radky (i pro 4-radkove displeje) ; 5x8 bodu
+#else
+# define LCD_FUNCTION_SET (0x20)  // 4bit ; 1 radek ; 5x8 bodu
+#endif
+
+/**
+ * @brief Prikaz (adresa DDRAM) pro prvni znak kazdeho radku.
+ */
+static const uint8_t LCD_row_addr[LCD_ROWS] = {
+  LCD_LINE1,
+#if (LCD_ROWS >= 2)
+  LCD_LINE2,
+#endif
+#if (LCD_ROWS >= 4) && (LCD_COLS == 20)
+  LCD_LINE3,
+  LCD_LINE4,
+#elif (LCD_ROWS >= 4)
+  LCD_LINE1 + LCD_COLS,
+  LCD_LINE2 + LCD_COLS,
+#endif
+};
+
+static uint8_t LCD_ddram;  // Aktualni adresa kurzoru v DDRAM (sledovano ovladacem)
+static uint8_t LCD_eol;    // Radek (1 az LCD_ROWS), za jehoz poslednim znakem stoji kurzor, jinak 0
+
+//#=== Geometrie LCD (LCD_COLS x LCD_ROWS) - KONEC
+//#========================================================================
+
 //#========================================================================
 //#=== Rutiny pro rizeni LCD - ZACATEK
 
@@ -55,23 +104,194 @@
 INLINE_STM32 void LCD_busy(void) { delay_us(4); } // 400us; Pokud nebude fungovat spravne, zmenit na 10ms (doba, kdy by mel LCD radic mit prikaz zpracovan a busy flag volny).
 
 /**
- * @brief  Zapis nibble informace (vyuziti 4bit komunikace, prikazy jsou vsak 8bit).
+ * @brief  Je prikaz LCD_CLR (0x01) nebo navrat kurzoru (0x02, 0x03)? Jejich vykonani trva 1.52ms.
+ *
+ */
+INLINE_STM32 int LCD_cmd_long(uint8_t cmd) { return (cmd & 0xFC) == 0 && cmd; }
+
+#if LCD_I2C
+//#========================================================================
+//#=== Prenos pres I2C expander PCF8574 - ZACATEK
+//
+// Expander drzi stav vsech 8 vystupu, kazdy zapsany bajt je jeden stav pinu
+// LCD. Nibble je tak dvojice bajtu (EN = 1 s daty, EN = 0), bajt LCD ctyri
+// bajty. Bajty se skladaji do bufferu a odesilaji jednou transakci I2C (DMA),
+// cely retezec nebo obnoveni displeje je jedna transakce (do LCD_I2C_BATCH
+// bajtu), takze rychlost je dana jen sbernici. Dva buffery se stridaji, dalsi
+// vypis se sklada, zatimco se predchozi odesila.
+#include "i2c.h"
+
+#if LCD_ASYNC
+# error "LCD_I2C nelze kombinovat s LCD_ASYNC (prenos pres I2C je asynchronni sam o sobe)!"
+#endif
+
+#ifndef LCD_I2C_RS                // Zapojeni expanderu (bezne moduly: P0 - P3 rizeni, P4 - P7 DB4 - DB7)
+# define LCD_I2C_RS  (0x01)
+# define LCD_I2C_RW  (0x02)
+# define LCD_I2C_EN  (0x04)
+# define LCD_I2C_BL  (0x08)       // Podsviceni
+#endif
+
+#ifndef LCD_I2C_BATCH
+# define LCD_I2C_BATCH  128       // Velikost jednoho bufferu (bajtu na transakci)
+#endif
+
+// Bajty I2C (po 9 bitech) mezi zapisy dvou bajtu LCD, aby radic stihl prikaz (37us)
+#define LCD_I2C_STEP   (((37UL * (LCD_I2C_HZ / 1000) + 8999) / 9000) + 2)
+
+static uint8_t          LCD_i2c_buf[2][LCD_I2C_BATCH];
+static i2c_xfer_t       LCD_i2c_xfer[2];
+static uint8_t          LCD_i2c_cur;    // Buffer, do ktereho se sklada
+static uint16_t         LCD_i2c_len;
+static uint8_t          LCD_i2c_out;    // Posledni zapsany stav expanderu
+static uint8_t          LCD_batch_depth;
+
+/**
+ * @brief  Odeslani slozenych bajtu jednou transakci (neceka na jeji dokonceni).
+ *
+ */
+void LCD_i2c_send(void) {
+  if (!LCD_i2c_len) return;
+
+  i2c_xfer_t *x = &LCD_i2c_xfer[LCD_i2c_cur];
+  x->addr   = LCD_I2C_ADDR;
+  x->tx     = LCD_i2c_buf[LCD_i2c_cur];
+  x->tx_len = LCD_i2c_len;
+  while (!I2C_submit(x)) {
+    CHRONO_IDLE(); // Fronta I2C je plna
+  }
+
+  LCD_i2c_cur ^= 1;
+  LCD_i2c_len = 0;
+  I2C_wait(&LCD_i2c_xfer[LCD_i2c_cur]); // Druhy buffer se mohl jeste odesilat
+}
+
+/**
+ * @brief  Odeslani a cekani na dokonceni obou bufferu.
+ *
+ */
+INLINE_STM32 void LCD_i2c_sync(void) {
+  LCD_i2c_send();
+  I2C_wait(&LCD_i2c_xfer[LCD_i2c_cur ^ 1]);
+}
+
+/**
+ * @brief  Pridani stavu expanderu do bufferu (plny buffer se odesle).
+ *
+ */
+INLINE_STM32 void LCD_i2c_put(uint8_t out) {
+  if (LCD_i2c_len >= LCD_I2C_BATCH) LCD_i2c_send();
+
+  LCD_i2c_buf[LCD_i2c_cur][LCD_i2c_len++] = out;
+  LCD_i2c_out = out;
+}
+
+/**
+ * @brief  Zapis nibble - dvojice bajtu (EN = 1 s daty, EN = 0) v bufferu.
  *
  * @param  nibble Hodnota v rozmezi 0 - F.
  *
  */
 INLINE_STM32 void LCD_write_nibble(uint8_t nibble) {
-  io_set(LCD_RW, 0);
-  io_set(LCD_EN, 0);
-  delay_us(1);       // 100us
-  io_set(LCD_EN, 1);
+  const uint8_t out = (LCD_i2c_out & (LCD_I2C_RS | LCD_I2C_BL)) | ((nibble & 0x0F) << 4);
 
+  LCD_i2c_put(out | LCD_I2C_EN);
+  LCD_i2c_put(out);               // Sestupna hrana EN zapise nibble
+}
+
+/**
+ * @brief  Zapis celeho bajtu do LCD. Mimo LCD_batch_begin()/LCD_batch_end()
+ *         se hned odesle, jinak se jen prida do transakce.
+ *
+ * @param  data Kod prikazu nebo znaku.
+ * @param  rs   0 = ridici prikaz, 1 = data (znak).
+ *
+ */
+INLINE_STM32 void LCD_write(uint8_t data, int rs) {
+  const uint8_t out = rs ? (LCD_i2c_out | LCD_I2C_RS) : (LCD_i2c_out & ~LCD_I2C_RS);
+
+  if (out != LCD_i2c_out) {
+    LCD_i2c_put(out);             // RS se musi ustalit pred nabeznou hranou EN
+  }
+  LCD_write_nibble(data >> 4);
+  LCD_write_nibble(data & 0x0F);
+  for (uint32_t i = 4; i < LCD_I2C_STEP; i++) {
+    LCD_i2c_put(LCD_i2c_out);     // Vyplne pro rychlou sbernici (1 MHz)
+  }
+
+  if (!LCD_batch_depth) {
+    LCD_i2c_send();
+  }
+}
+
+/**
+ * @brief  Cekani na vykonani LCD_CLR nebo navratu kurzoru (prikaz uz musi byt odeslan).
+ *
+ */
+INLINE_STM32 void LCD_wait_long(void) {
+  LCD_i2c_sync();
+  delay_ms(2); // LCD_CLR a navrat kurzoru trvaji 1.52ms
+}
+
+/**
+ * @brief  Zacatek davky - nasledujici zapisy se odeslou az jednou transakci
+ *         v LCD_batch_end() (davky lze vnorovat).
+ *
+ */
+INLINE_STM32 void LCD_batch_begin(void) {
+  LCD_batch_depth++;
+}
+
+/**
+ * @brief  Konec davky, po posledni vnorene se buffer odesle.
+ *
+ */
+INLINE_STM32 void LCD_batch_end(void) {
+  if (LCD_batch_depth && !--LCD_batch_depth) {
+    LCD_i2c_send();
+  }
+}
+
+/**
+ * @brief  Zapnuti/vypnuti podsviceni.
+ *
+ */
+INLINE_STM32 void LCD_backlight(int on) {
+  LCD_i2c_put(on ? (LCD_i2c_out | LCD_I2C_BL) : (LCD_i2c_out & ~LCD_I2C_BL));
+  if (!LCD_batch_depth) LCD_i2c_send();
+}
+
+//#=== Prenos pres I2C expander PCF8574 - KONEC
+//#========================================================================
+#else
+/**
+ * @brief  Vystaveni nibble na datove piny DB4 - DB7 (bez pulzu na EN).
+ *
+ * @param  nibble Hodnota v rozmezi 0 - F.
+ *
+ */
+INLINE_STM32 void LCD_put_nibble(uint8_t nibble) {
   nibble &= 0x0F; // Vymaskovani spodnich 4 bitu ze vstupni hodnoty
-  
+
   io_set(LCD_DB4, (nibble & 0x1) >> 0); // Zapis informace
   io_set(LCD_DB5, (nibble & 0x2) >> 1); //  na prislusne
   io_set(LCD_DB6, (nibble & 0x4) >> 2); //  piny (zapis
   io_set(LCD_DB7, (nibble & 0x8) >> 3); //  bit po bitu).
+}
+
+/**
+ * @brief  Zapis nibble informace (vyuziti 4bit komunikace, prikazy jsou vsak 8bit).
+ *
+ * @param  nibble Hodnota v rozmezi 0 - F.
+ *
+ */
+INLINE_STM32 void LCD_write_nibble(uint8_t nibble) {
+  io_set(LCD_RW, 0);
+  io_set(LCD_EN, 0);
+  delay_us(1);       // 100us
+  io_set(LCD_EN, 1);
+
+  LCD_put_nibble(nibble);
 
   delay_us(1);
   io_set(LCD_EN, 0);
@@ -79,23 +299,215 @@ INLINE_STM32 void LCD_write_nibble(uint8_t nibble) {
 }
 
 /**
- * @brief  Funkce pro rizeni/nastaveni LCD.
+ * @brief  Synchronni zapis celeho bajtu do LCD (blokuje po celou dobu prenosu).
  *
- * @param  cmd Kod pro ridici prikaz.
+ * @param  data Kod prikazu nebo znaku.
+ * @param  rs   0 = ridici prikaz, 1 = data (znak).
  *
  */
-INLINE_STM32 void LCD_set(uint8_t cmd) {
+INLINE_STM32 void LCD_write(uint8_t data, int rs) {
   LCD_busy(); // Casova prodleva pro zpracovani ridicich prikazu.
 
-  io_set(LCD_RS, 0);
-  LCD_write_nibble(cmd >> 4); // Poslani 4 hornich bitu na zapis
-  LCD_write_nibble(cmd);      // Poslani 4 dolnich bitu na zapis
-  // delay_us(4);                                              // 400us; V pripade potreby odkomentovat.
+  io_set(LCD_RS, rs);
+  LCD_write_nibble(data >> 4);   // Poslani 4 hornich bitu na zapis
+  LCD_write_nibble(data & 0x0F); // Poslani 4 dolnich bitu na zapis
+}
+
+/**
+ * @brief  Cekani na vykonani LCD_CLR nebo navratu kurzoru.
+ *
+ */
+INLINE_STM32 void LCD_wait_long(void) {
+  delay_ms(2); // LCD_CLR a navrat kurzoru trvaji 1.52ms, LCD_busy() nestaci
+}
+
+/**
+ * @brief  Zacatek davky zapisu (u primeho pripojeni bez vyznamu).
+ *
+ */
+INLINE_STM32 void LCD_batch_begin(void) {}
+
+/**
+ * @brief  Konec davky zapisu (u primeho pripojeni bez vyznamu).
+ *
+ */
+INLINE_STM32 void LCD_batch_end(void) {}
+#endif
+
+#define LCD_DDRAM_LINE   (LCD_ROWS == 1 ? 80 : 40) // Delka radku DDRAM (jednoradkovy rezim N = 0: cela DDRAM)
+
+static volatile uint8_t  LCD_marquee_pos;     // Aktualni posun displeje (0 - LCD_DDRAM_LINE - 1)
+static volatile uint32_t LCD_marquee_period;  // Perioda posunu v tickach TIM7 (0 = marquee neni spusteno)
+static volatile uint32_t LCD_marquee_count;
+static volatile uint8_t  LCD_marquee_due;     // Posun ceka na odeslani
+
+#if LCD_ASYNC
+//#========================================================================
+//#=== Asynchronni vystup (fronta + preruseni TIM7) - ZACATEK
+#include "timers.h"
+
+#if (LCD_ASYNC_QUEUE & (LCD_ASYNC_QUEUE - 1)) != 0 || LCD_ASYNC_QUEUE > 256
+# error "LCD_ASYNC_QUEUE musi byt mocnina 2 (max. 256)!"
+#endif
+
+#define LCD_QUEUE_MASK   (LCD_ASYNC_QUEUE - 1)
+#define LCD_QUEUE_RS     (0x100)  // Priznak polozky fronty: data (RS = 1), jinak ridici prikaz
+#define LCD_EXEC_US      (37)     // Doba vykonani bezneho prikazu
+#define LCD_EXEC_LONG_US (1520)   // Doba vykonani LCD_CLR a navratu kurzoru
+#define LCD_TICKS(us)    (((us) + LCD_ASYNC_TICK_US - 1) / LCD_ASYNC_TICK_US)
+
+static volatile uint16_t LCD_queue[LCD_ASYNC_QUEUE];
+static volatile uint16_t LCD_queue_head;  // Zapis (aplikace), index bezi volne a maskuje se
+static volatile uint16_t LCD_queue_tail;  // Cteni (preruseni)
+static volatile uint16_t LCD_queue_max;   // Nejvetsi zaznamenana hloubka fronty
+static volatile uint8_t  LCD_async_phase; // 0 = cekani na bajt, 1 = vystaven horni nibble, 2 = vystaven dolni nibble
+static volatile uint16_t LCD_async_wait;  // Pocet ticku, po ktere LCD jeste zpracovava prikaz
+static volatile uint16_t LCD_async_entry; // Prave odesilany bajt
+static volatile uint8_t  LCD_async_queued;// Odesilany bajt pochazi z fronty (po odeslani se odebere)
+
+/**
+ * @brief  Aktualni pocet polozek cekajicich ve fronte.
+ *
+ */
+INLINE_STM32 uint16_t LCD_queue_depth(void) {
+  return (uint16_t)(LCD_queue_head - LCD_queue_tail);
 }
 
-INLINE_STM32 void LCD_io_setup(enum pin pin) {
-  pin_enable(pin);
-  pin_setup(pin, PIN_MODE_OUTPUT, PIN_PULL_DEFAULT, PIN_SPEED_HIGH, PIN_TYPE_PUSHPULL);
+/**
+ * @brief  Nejvetsi hloubka fronty od spusteni (pro nastaveni LCD_ASYNC_QUEUE).
+ *
+ */
+INLINE_STM32 uint16_t LCD_queue_peak(void) {
+  return LCD_queue_max;
+}
+
+/**
+ * @brief  Vlozeni bajtu do fronty. Pokud je fronta plna, ceka na jeji uvolneni
+ *         (nevolat se zakazanym prerusenim!).
+ *
+ * @param  entry Bajt pro zapis, pripadne s priznakem LCD_QUEUE_RS.
+ *
+ */
+INLINE_STM32 void LCD_push(uint16_t entry) {
+  while (LCD_queue_depth() >= LCD_ASYNC_QUEUE) {
+    CHRONO_IDLE(); // Fronta je plna, preruseni ji postupne vyprazdni
+  }
+
+  LCD_queue[LCD_queue_head & LCD_QUEUE_MASK] = entry;
+  LCD_queue_head++;
+
+  const uint16_t depth = LCD_queue_depth();
+  if (depth > LCD_queue_max) LCD_queue_max = depth;
+
+  TIM7_TIM->CR1 |= TIM_CR1_CEN; // Spusteni odesilani (pokud casovac stoji)
+}
+
+/**
+ * @brief  Cekani, dokud neni fronta odeslana a posledni prikaz zpracovan.
+ *
+ */
+INLINE_STM32 void LCD_flush(void) {
+  while (LCD_queue_depth() || LCD_async_phase || LCD_async_wait) {
+    CHRONO_IDLE(); // Cekani na vyprazdneni fronty
+  }
+}
+
+/**
+ * @brief  Doba, po kterou LCD zpracovava zapsany bajt.
+ *
+ */
+INLINE_STM32 uint32_t LCD_exec_time(uint16_t entry) {
+  if (!(entry & LCD_QUEUE_RS) && LCD_cmd_long((uint8_t)entry)) {
+    return LCD_EXEC_LONG_US; // LCD_CLR, LCD_CUR_HOME
+  }
+  return LCD_EXEC_US;
+}
+
+/**
+ * @brief  Obsluha preruseni TIM7, kazdy tick zapise na LCD jeden nibble.
+ *
+ *         Sestupna hrana EN na zacatku ticku zapise nibble vystaveny v predchozim
+ *         ticku, takze EN pulz i predstih dat trvaji celou periodu LCD_ASYNC_TICK_US.
+ *
+ */
+void TIM7_IRQ_HANDLER(void) {
+  TIM7_TIM->SR &= ~(TIM_SR_UIF);
+  io_set(LCD_EN, 0);
+
+  if (LCD_marquee_period && ++LCD_marquee_count >= LCD_marquee_period) {
+    LCD_marquee_count = 0;
+    LCD_marquee_due = 1;                  // Posun marquee se vlozi pred dalsi bajt z fronty
+  }
+
+  if (LCD_async_phase == 2) { // Dolni nibble zapsan, bajt je kompletni
+    if (LCD_async_queued) LCD_queue_tail++;
+    LCD_async_phase = 0;
+    LCD_async_wait = LCD_TICKS(LCD_exec_time(LCD_async_entry)) - 1;
+  }
+
+  if (LCD_async_wait) {
+    LCD_async_wait--;
+    return;
+  }
+
+  if (LCD_async_phase == 1) {
+    LCD_put_nibble(LCD_async_entry);
+    io_set(LCD_EN, 1);
+    LCD_async_phase = 2;
+    return;
+  }
+
+  if (LCD_marquee_due) {
+    LCD_marquee_due = 0;
+    LCD_marquee_pos = (LCD_marquee_pos + 1) % LCD_DDRAM_LINE;
+    LCD_async_entry = LCD_SL;
+    LCD_async_queued = 0;
+  } else if (LCD_queue_tail != LCD_queue_head) {
+    LCD_async_entry = LCD_queue[LCD_queue_tail & LCD_QUEUE_MASK];
+    LCD_async_queued = 1;
+  } else {
+    if (!LCD_marquee_period) {
+      TIM7_TIM->CR1 &= ~TIM_CR1_CEN; // Fronta je prazdna, casovac se zastavi
+    }
+    return;
+  }
+
+  io_set(LCD_RS, (LCD_async_entry & LCD_QUEUE_RS) != 0);
+  LCD_put_nibble(LCD_async_entry >> 4);
+  io_set(LCD_EN, 1);
+  LCD_async_phase = 1;
+}
+
+//#=== Asynchronni vystup (fronta + preruseni TIM7) - KONEC
+//#========================================================================
+#endif
+
+static void LCD_buffer_blank(void);
+
+/**
+ * @brief  Funkce pro rizeni/nastaveni LCD.
+ *         V rezimu LCD_ASYNC se prikaz pouze vlozi do fronty.
+ *         LCD_CLR smaze i stinovy buffer (mezery).
+ *
+ * @param  cmd Kod pro ridici prikaz.
+ *
+ */
+INLINE_STM32 void LCD_set(uint8_t cmd) {
+  if (cmd & 0x80) {
+    LCD_ddram = cmd & 0x7F;              // Nastaveni adresy DDRAM
+    LCD_eol = 0;
+  } else if (LCD_cmd_long(cmd)) {
+    LCD_ddram = 0;                       // LCD_CLR, LCD_CUR_HOME
+    LCD_eol = 0;
+    if (cmd == LCD_CLR) LCD_buffer_blank();
+  }
+
+#if LCD_ASYNC
+  LCD_push(cmd);
+#else
+  LCD_write(cmd, 0);
+  if (LCD_cmd_long(cmd)) LCD_wait_long();
+#endif
 }
 
 /**
@@ -103,37 +515,50 @@ INLINE_STM32 void LCD_io_setup(enum pin pin) {
  *
  */
 void LCD_setup(void) {
-  // 1. Reseni napajeni (skolni kit) - ZACATEK
+  static const pin_config_t pins[] = {
+    // 1. Reseni napajeni (skolni kit)
 #if (STM32_TYPE == 407) // Pro F407 (skolni pripravek)
-  // Nasledujici radky jsou pouze pro skolni pripravek, u domacich neni nutno zapojovat PE10
-  const enum pin pwr = PE10;
-  LCD_io_setup(pwr);
-  io_set(pwr, 0); // DIR = 0; Pouzit prevodnik '245 (z 3.3V na 5V a naopak)
-#endif
-  // 1. Reseni napajeni (skolni kit) - KONEC
-
-  // 2. Nastaveni pinu a portu - ZACATEK
-  __disable_irq();
-  LCD_io_setup(LCD_RS);
-  LCD_io_setup(LCD_RW);
-  LCD_io_setup(LCD_EN);
-  LCD_io_setup(LCD_DB4);
-  LCD_io_setup(LCD_DB5);
-  LCD_io_setup(LCD_DB6);
-  LCD_io_setup(LCD_DB7);
-  __enable_irq();
-  // 2. Nastaveni pinu a portu - KONEC
+    // Nasledujici radek je pouze pro skolni pripravek, u domacich neni nutno zapojovat PE10
+    // DIR = 0; Pouzit prevodnik '245 (z 3.3V na 5V a naopak)
+    { PE10,    PIN_MODE_OUTPUT, PIN_PULL_DEFAULT, PIN_SPEED_HIGH, PIN_TYPE_PUSHPULL, PIN_AF_NONE, PIN_LEVEL_LOW },
+#endif
+    // 2. Nastaveni pinu a portu
+    { LCD_RS,  PIN_MODE_OUTPUT, PIN_PULL_DEFAULT, PIN_SPEED_HIGH, PIN_TYPE_PUSHPULL, PIN_AF_NONE, PIN_LEVEL_DEFAULT },
+    { LCD_RW,  PIN_MODE_OUTPUT, PIN_PULL_DEFAULT, PIN_SPEED_HIGH, PIN_TYPE_PUSHPULL, PIN_AF_NONE, PIN_LEVEL_DEFAULT },
+    { LCD_EN,  PIN_MODE_OUTPUT, PIN_PULL_DEFAULT, PIN_SPEED_HIGH, PIN_TYPE_PUSHPULL, PIN_AF_NONE, PIN_LEVEL_DEFAULT },
+    { LCD_DB4, PIN_MODE_OUTPUT, PIN_PULL_DEFAULT, PIN_SPEED_HIGH, PIN_TYPE_PUSHPULL, PIN_AF_NONE, PIN_LEVEL_DEFAULT },
+    { LCD_DB5, PIN_MODE_OUTPUT, PIN_PULL_DEFAULT, PIN_SPEED_HIGH, PIN_TYPE_PUSHPULL, PIN_AF_NONE, PIN_LEVEL_DEFAULT },
+    { LCD_DB6, PIN_MODE_OUTPUT, PIN_PULL_DEFAULT, PIN_SPEED_HIGH, PIN_TYPE_PUSHPULL, PIN_AF_NONE, PIN_LEVEL_DEFAULT },
+    { LCD_DB7, PIN_MODE_OUTPUT, PIN_PULL_DEFAULT, PIN_SPEED_HIGH, PIN_TYPE_PUSHPULL, PIN_AF_NONE, PIN_LEVEL_DEFAULT },
+  };
+
+#if LCD_I2C
+  (void)pins;
+  if (!I2C_hz) I2C_setup(LCD_I2C_HZ);    // Sbernici mohla nastavit uz aplikace
+  LCD_i2c_out = LCD_I2C_BL;
+#else
+  // 1. + 2. Napajeni, piny a porty (kazdy registr portu se zapise jednou)
+  pin_setup_table(pins, PIN_TABLE_SIZE(pins));
+#endif
 
   // 3. Nastaveni/inicializace LCD - ZACATEK
-  LCD_set(0x3); // 1) Reset LCD
-  LCD_set(0x3);
-  LCD_set(0x2);
-
-  LCD_set(0x28); // 2) Nastaveni komunikace, poctu radku a rozliseni: 4bit ; 2 radky ; 5x8 bodu
-  LCD_set(0x0F); // 3) Aktivace displeje: zapnuti displeje a blikajiciho kurzoru
-  LCD_set(0x06); // 4) Chovani displeje pri vypisu znaku: inkrementace adresy a posun kurzoru vpravo po vypsani znaku na LCD
-  LCD_set(0x01); // 5) Smazani displeje
+  LCD_write(0x3, 0); // 1) Reset LCD (zatim 8bit rezim, nejde o navrat kurzoru)
+  delay_ms(5);       //    Prvni reset trva 4.1ms
+  LCD_write(0x3, 0);
+  LCD_write(0x2, 0);
+
+  LCD_write(LCD_FUNCTION_SET, 0); // 2) Nastaveni komunikace, poctu radku a rozliseni: 4bit ; 1 nebo 2 radky ; 5x8 bodu
+  LCD_write(0x0F, 0); // 3) Aktivace displeje: zapnuti displeje a blikajiciho kurzoru
+  LCD_write(0x06, 0); // 4) Chovani displeje pri vypisu znaku: inkrementace adresy a posun kurzoru vpravo po vypsani znaku na LCD
+  LCD_write(0x01, 0); // 5) Smazani displeje
+  LCD_wait_long();
+  LCD_ddram = 0;
+  LCD_buffer_blank(); // Stinovy buffer odpovida smazanemu displeji (0x00 je znak CGRAM)
   // 3. Nastaveni/inicializace LCD - KONEC
+
+#if LCD_ASYNC
+  TIM7_setup(LCD_ASYNC_TICK_US); // Casovac pro odesilani fronty (spousti se az s prvni polozkou)
+#endif
 }
 //#=== Rutiny pro rizeni LCD - KONEC
 //#========================================================================
@@ -143,40 +568,379 @@ void LCD_setup(void) {
 
 /**
  * @brief  Funkce pro vypis 1 znaku na LCD.
+ *         V rezimu LCD_ASYNC se znak pouze vlozi do fronty.
  *
  * @param  data Kod pro vypisovany znak, pripadne konkretni znak.
  *
  */
 void LCD_symbol(uint8_t data)
 {
-  LCD_busy(); // Casova prodleva pro zpracovani ridicich prikazu.
+#if (LCD_ROWS > 1)                         // Posun adresy stejne jako radic (konec banky -> dalsi banka)
+  LCD_ddram = (LCD_ddram == 0x27) ? 0x40 : (LCD_ddram == 0x67) ? 0x00 : LCD_ddram + 1;
+#else
+  LCD_ddram = (LCD_ddram == 0x4F) ? 0x00 : LCD_ddram + 1;
+#endif
+  LCD_eol = 0;
+
+#if LCD_ASYNC
+  LCD_push(LCD_QUEUE_RS | data);
+#else
+  LCD_write(data, 1);
+#endif
+}
+
+/**
+ * @brief  Presun kurzoru na zadanou pozici.
+ *
+ * @param  x Sloupec (0 az LCD_COLS - 1).
+ * @param  y Radek (1 az LCD_ROWS).
+ *
+ */
+void LCD_goto(int x, int y) {
+  if (x < 0 || x >= LCD_COLS || y < 1 || y > LCD_ROWS) return; // Mimo displej
+
+  LCD_set(LCD_row_addr[y - 1] + x);
+}
 
-  io_set(LCD_RS, 1);
-  LCD_write_nibble(data >> 4);   // Horni 4bity
-  LCD_write_nibble(data & 0x0F); // Dolni 4bity
+/**
+ * @brief  Vypis 1 znaku se zalomenim radku.
+ *         Pokud je kurzor za koncem viditelneho radku, presune se na zacatek dalsiho radku
+ *         (za poslednim radkem na prvni).
+ *
+ * @param  data Vypisovany znak.
+ *
+ */
+void LCD_putc(uint8_t data) {
+  LCD_batch_begin();
+  if (LCD_eol) {
+    LCD_goto(0, LCD_eol % LCD_ROWS + 1);
+  }
+
+  const uint8_t addr = LCD_ddram;
+  LCD_symbol(data);
+  LCD_batch_end();
+
+  for (int row = 0; row < LCD_ROWS; row++) { // Zapsan posledni znak radku?
+    if (addr == (LCD_row_addr[row] & 0x7F) + LCD_COLS - 1) {
+      LCD_eol = row + 1;
+      break;
+    }
+  }
 }
 
 /**
  * @brief  Funkce pro vypis retezce znaku na LCD.
- *         Funkce neresi pocet znaku na radek, ani pocet radku, nutno resit v samotnem programu nebo si napsat vl. funkci.
+ *         Text se na konci radku zalamuje na dalsi radek (viz LCD_putc()).
  *
  * @param  text Retezec/pole znaku, jez se maji vypsat na LCD.
  *
  */
 
 void LCD_print(const char *__restrict__ text) {
-  uint8_t i;
-
-  for (i = 0; i < strlen(text); i++) {
-    LCD_symbol(text[i]);
+  LCD_batch_begin();                      // Cely retezec jednou transakci (LCD_I2C)
+  while (*text) {
+    LCD_putc(*text++);
   }
+  LCD_batch_end();
 }
 
-void LCD_goto(int x, int y) {
-  const uint8_t row_offset[] = { 0x00, 0x40 };
-  LCD_set(0x80 | (x + row_offset[y - 1]));
+/**
+ * @brief  Vypis celeho cisla na LCD (bez sprintf).
+ *
+ * @param  value Vypisovana hodnota.
+ * @param  width Minimalni sirka (zarovnani vpravo mezerami), 0 = bez zarovnani.
+ *
+ */
+void LCD_print_int(int32_t value, int width) {
+  LCD_batch_begin();
+  fmt_int(LCD_putc, value, width, ' ');
+  LCD_batch_end();
 }
+
+/**
+ * @brief  Vypis cisla s pevnou desetinnou carkou na LCD, napr. 2345 s decimals = 2 jako "23.45".
+ *
+ * @param  value    Hodnota vynasobena 10^decimals.
+ * @param  decimals Pocet desetinnych mist.
+ * @param  width    Minimalni sirka (zarovnani vpravo mezerami), 0 = bez zarovnani.
+ *
+ */
+void LCD_print_fixed(int32_t value, int decimals, int width) {
+  LCD_batch_begin();
+  fmt_fixed(LCD_putc, value, decimals, width);
+  LCD_batch_end();
+}
+
+/**
+ * @brief  Vypis cisla v sestnactkove soustave na LCD.
+ *
+ * @param  value  Vypisovana hodnota.
+ * @param  digits Pocet cislic (1 - 8).
+ *
+ */
+void LCD_print_hex(uint32_t value, int digits) {
+  LCD_batch_begin();
+  fmt_hex(LCD_putc, value, digits);
+  LCD_batch_end();
+}
+
 //#=== Rutiny pro praci s LCD - KONEC
 //#========================================================================
 
+//#========================================================================
+//#=== Marquee (hardwarovy posun textu) - ZACATEK
+//
+// Text se zapise jednou do celeho radku DDRAM (LCD_DDRAM_LINE: 40 znaku, u jednoradkoveho
+// displeje 80) a dale se posouva jen prikazem LCD_SL (1 bajt na krok misto prepisu
+// celeho radku). Posun displeje je spolecny pro vsechny radky, u 4-radkovych displeju
+// sdili banku DDRAM radky 1 a 3 (2 a 4).
+
+/**
+ * @brief  Spusteni marquee - zapis textu do celeho radku DDRAM.
+ *
+ * @param  y         Radek (1 az LCD_ROWS), urcuje banku DDRAM.
+ * @param  text      Text (max. LCD_DDRAM_LINE znaku, zbytek radku se doplni mezerami).
+ * @param  period_ms Perioda posunu v rezimu LCD_ASYNC (posouva preruseni TIM7).
+ *                   Bez LCD_ASYNC se nepouziva, posun se vola LCD_marquee_step()
+ *                   z vlastniho casovace.
+ *
+ */
+void LCD_marquee_start(int y, const char *text, uint32_t period_ms) {
+  if (y < 1 || y > LCD_ROWS) return;
+
+  LCD_marquee_period = 0;
+  LCD_marquee_due = 0;
+  LCD_set(LCD_CUR_HOME);                  // Zruseni predchoziho posunu
+  LCD_marquee_pos = 0;
+
+  LCD_batch_begin();
+  LCD_set(0x80 | (LCD_row_addr[y - 1] & 0x40));
+  for (int i = 0; i < LCD_DDRAM_LINE; i++) {
+    LCD_symbol(*text ? *text++ : ' ');
+  }
+  LCD_batch_end();
+
+#if LCD_ASYNC
+  LCD_marquee_count = 0;
+  LCD_marquee_period = (period_ms * 1000UL + LCD_ASYNC_TICK_US - 1) / LCD_ASYNC_TICK_US;
+  TIM7_TIM->CR1 |= TIM_CR1_CEN;
+#else
+  (void)period_ms;
+#endif
+}
+
+/**
+ * @brief  Posun marquee o 1 znak vlevo (jediny prikaz LCD_SL).
+ *         V rezimu LCD_ASYNC lze volat i z preruseni jineho casovace, bez LCD_ASYNC
+ *         jen tam, kde neprobiha jiny zapis na LCD (napr. hlavni smycka s TIM6).
+ *
+ */
+void LCD_marquee_step(void) {
+#if LCD_ASYNC
+  LCD_marquee_due = 1;                    // Prikaz vlozi preruseni TIM7 mimo frontu
+  TIM7_TIM->CR1 |= TIM_CR1_CEN;
+#else
+  LCD_marquee_pos = (LCD_marquee_pos + 1) % LCD_DDRAM_LINE;
+  LCD_set(LCD_SL);
+#endif
+}
+
+/**
+ * @brief  Zastaveni marquee a navrat displeje do vychozi polohy.
+ *
+ */
+void LCD_marquee_stop(void) {
+  LCD_marquee_period = 0;
+  LCD_marquee_due = 0;
+  LCD_set(LCD_CUR_HOME);                  // Zrusi posun displeje
+  LCD_marquee_pos = 0;
+}
+
+//#=== Marquee (hardwarovy posun textu) - KONEC
+//#========================================================================
+
+//#========================================================================
+//#=== Uzivatelske znaky (CGRAM) - ZACATEK
+//
+// Radic ma pouze 8 uzivatelskych znaku (kody 0 - 7). Registrovat lze az LCD_GLYPHS
+// znaku, do CGRAM se nahravaji az pri pouziti a pri nedostatku mista se nahradi
+// nejdele nepouzity. Bitmapa se tak prenasi jen pri zmene prirazeni slotu.
+// Pozor: znaky, ktere jsou na displeji a patri nahrazenemu slotu, zmeni vzhled.
+
+#define LCD_CGRAM_SLOTS  8
+
+static const uint8_t *LCD_glyph_bitmap[LCD_GLYPHS];     // Registrovane bitmapy (8 radku po 5 bitech)
+static uint8_t  LCD_glyph_count;
+static uint8_t  LCD_glyph_slot[LCD_GLYPHS];             // Slot + 1, ve kterem je znak nahran (0 = neni)
+static uint8_t  LCD_slot_owner[LCD_CGRAM_SLOTS];        // Id + 1 znaku v danem slotu (0 = volny)
+static uint32_t LCD_slot_used[LCD_CGRAM_SLOTS];         // Cas posledniho pouziti slotu (pro LRU)
+static uint32_t LCD_glyph_clock;
+static uint32_t LCD_glyph_uploads;                      // Pocet nahrani do CGRAM (statistika)
+
+/**
+ * @brief  Registrace uzivatelskeho znaku 5x8 bodu.
+ *
+ * @param  bitmap 8 radku znaku (spodnich 5 bitu, MSB vlevo), pole musi zustat platne.
+ *
+ * @return Id znaku pro LCD_glyph(), nebo -1 pokud je tabulka plna (viz LCD_GLYPHS).
+ */
+int LCD_glyph_register(const uint8_t *bitmap) {
+  if (LCD_glyph_count >= LCD_GLYPHS) return -1;
+
+  LCD_glyph_bitmap[LCD_glyph_count] = bitmap;
+  return LCD_glyph_count++;
+}
+
+/**
+ * @brief  Nahrani bitmapy do slotu CGRAM (adresa DDRAM kurzoru se zachova).
+ *
+ */
+void LCD_glyph_upload(int slot, const uint8_t *bitmap) {
+  const uint8_t ddram = LCD_ddram;
+  const uint8_t eol = LCD_eol;
+
+  LCD_batch_begin();
+  LCD_set(0x40 | (slot << 3));            // Adresa CGRAM
+  for (int i = 0; i < 8; i++) {
+    LCD_symbol(bitmap[i] & 0x1F);
+  }
+
+  LCD_set(0x80 | ddram);                  // Navrat do DDRAM
+  LCD_batch_end();
+  LCD_eol = eol;
+  LCD_glyph_uploads++;
+}
+
+/**
+ * @brief  Kod znaku (0 - 7) pro vypis registrovaneho znaku.
+ *         Pokud znak neni v CGRAM, nahraje se do volneho nebo nejdele nepouziteho slotu.
+ *
+ * @param  id Id znaku z LCD_glyph_register().
+ *
+ * @return Kod pro LCD_symbol()/LCD_putc(), pro neplatne id mezera.
+ */
+uint8_t LCD_glyph(int id) {
+  if (id < 0 || id >= LCD_glyph_count) return ' ';
+
+  int slot = LCD_glyph_slot[id] - 1;
+  if (slot < 0) {
+    slot = 0;
+    for (int i = 0; i < LCD_CGRAM_SLOTS; i++) {
+      if (!LCD_slot_owner[i]) {           // Volny slot ma prednost
+        slot = i;
+        break;
+      }
+      if (LCD_glyph_clock - LCD_slot_used[i] > LCD_glyph_clock - LCD_slot_used[slot]) {
+        slot = i;                         // Nejdele nepouzity
+      }
+    }
+
+    if (LCD_slot_owner[slot]) {
+      LCD_glyph_slot[LCD_slot_owner[slot] - 1] = 0;
+    }
+    LCD_slot_owner[slot] = id + 1;
+    LCD_glyph_slot[id] = slot + 1;
+    LCD_glyph_upload(slot, LCD_glyph_bitmap[id]);
+  }
+
+  LCD_slot_used[slot] = ++LCD_glyph_clock;
+  return slot;
+}
+
+/**
+ * @brief  Vypis registrovaneho znaku na pozici kurzoru.
+ *
+ * @param  id Id znaku z LCD_glyph_register().
+ *
+ */
+void LCD_glyph_put(int id) {
+  LCD_putc(LCD_glyph(id));
+}
+
+//#=== Uzivatelske znaky (CGRAM) - KONEC
+//#========================================================================
+
+//#========================================================================
+//#=== Stinovy buffer LCD - ZACATEK
+//
+// Buffer je ulozen ve stejnem poradi jako DDRAM (po bankach), takze se cely
+// displej obnovi jednim nastavenim adresy na banku a souvislym zapisem znaku.
+
+static uint8_t LCD_buffer[LCD_BANKS][LCD_BANK_LEN];
+static uint8_t LCD_buffer_dirty;
+
+/**
+ * @brief  Vyplneni stinoveho bufferu mezerami po smazani displeje (buffer odpovida displeji).
+ *
+ */
+static void LCD_buffer_blank(void) {
+  memset(LCD_buffer, ' ', sizeof(LCD_buffer));
+  LCD_buffer_dirty = 0;
+}
+
+/**
+ * @brief  Smazani stinoveho bufferu (vyplneni mezerami).
+ *
+ */
+void LCD_buffer_clear(void) {
+  memset(LCD_buffer, ' ', sizeof(LCD_buffer));
+  LCD_buffer_dirty = 1;
+}
+
+/**
+ * @brief  Zapis znaku do stinoveho bufferu (na displeji se projevi az po LCD_refresh()).
+ *
+ * @param  x    Sloupec (0 az LCD_COLS - 1).
+ * @param  y    Radek (1 az LCD_ROWS).
+ * @param  data Znak.
+ *
+ */
+void LCD_buffer_put(int x, int y, uint8_t data) {
+  if (x < 0 || x >= LCD_COLS || y < 1 || y > LCD_ROWS) return;
+
+  const int row = y - 1;
+  LCD_buffer[row & 1][(row >> 1) * LCD_COLS + x] = data;
+  LCD_buffer_dirty = 1;
+}
+
+/**
+ * @brief  Zapis retezce do stinoveho bufferu, na konci radku se zalamuje.
+ *
+ * @param  x    Pocatecni sloupec (0 az LCD_COLS - 1).
+ * @param  y    Pocatecni radek (1 az LCD_ROWS).
+ * @param  text Retezec.
+ *
+ */
+void LCD_buffer_print(int x, int y, const char *text) {
+  while (*text && y <= LCD_ROWS) {
+    LCD_buffer_put(x, y, *text++);
+    if (++x >= LCD_COLS) {
+      x = 0;
+      y++;
+    }
+  }
+}
+
+/**
+ * @brief  Prenos stinoveho bufferu na displej (pouze pokud se zmenil).
+ *         Na kazdou banku DDRAM staci jeden prikaz adresy a souvisly zapis znaku.
+ *
+ */
+void LCD_refresh(void) {
+  if (!LCD_buffer_dirty) return;
+  LCD_buffer_dirty = 0;
+
+  LCD_batch_begin();
+  for (int bank = 0; bank < LCD_BANKS; bank++) {
+    LCD_set(LCD_row_addr[bank]);
+    for (int i = 0; i < LCD_BANK_LEN; i++) {
+      LCD_symbol(LCD_buffer[bank][i]);
+    }
+  }
+  LCD_batch_end();
+}
+
+//#=== Stinovy buffer LCD - KONEC
+//#========================================================================
+
 #endif /* STM32_LCD */
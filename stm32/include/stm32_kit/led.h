@@ -69,42 +69,19 @@ extern "C" {
  *
  */
 void LED_setup(void) {
-  __disable_irq();
-  // Pro vestavene LED
-  // Nejdrive Aktivace CLK na portu
-  // Pak vynulovani MODERu pro dany pin (input mod)
-  // A nasledne nastaveni smeru pinu (output mod)
-  pin_enable(LED_IN_0);
-  pin_enable(LED_IN_1);
-  pin_enable(LED_IN_2);
-  pin_enable(LED_IN_3);
-  
-  pin_mode(LED_IN_0, PIN_MODE_OUTPUT);
-  pin_mode(LED_IN_1, PIN_MODE_OUTPUT);
-  pin_mode(LED_IN_2, PIN_MODE_OUTPUT);
-  pin_mode(LED_IN_3, PIN_MODE_OUTPUT);
+  // Vsechny LED jako vystupy, externi LED (sviti v log. 0) zhasnute jeste pred prepnutim na vystup
+  static const pin_config_t pins[] = {
+    { LED_IN_0, PIN_MODE_OUTPUT, PIN_PULL_DEFAULT, PIN_SPEED_DEFAULT, PIN_TYPE_DEFAULT, PIN_AF_NONE, PIN_LEVEL_DEFAULT },
+    { LED_IN_1, PIN_MODE_OUTPUT, PIN_PULL_DEFAULT, PIN_SPEED_DEFAULT, PIN_TYPE_DEFAULT, PIN_AF_NONE, PIN_LEVEL_DEFAULT },
+    { LED_IN_2, PIN_MODE_OUTPUT, PIN_PULL_DEFAULT, PIN_SPEED_DEFAULT, PIN_TYPE_DEFAULT, PIN_AF_NONE, PIN_LEVEL_DEFAULT },
+    { LED_IN_3, PIN_MODE_OUTPUT, PIN_PULL_DEFAULT, PIN_SPEED_DEFAULT, PIN_TYPE_DEFAULT, PIN_AF_NONE, PIN_LEVEL_DEFAULT },
+    { LED_EX_0, PIN_MODE_OUTPUT, PIN_PULL_DEFAULT, PIN_SPEED_DEFAULT, PIN_TYPE_DEFAULT, PIN_AF_NONE, PIN_LEVEL_HIGH },
+    { LED_EX_1, PIN_MODE_OUTPUT, PIN_PULL_DEFAULT, PIN_SPEED_DEFAULT, PIN_TYPE_DEFAULT, PIN_AF_NONE, PIN_LEVEL_HIGH },
+    { LED_EX_2, PIN_MODE_OUTPUT, PIN_PULL_DEFAULT, PIN_SPEED_DEFAULT, PIN_TYPE_DEFAULT, PIN_AF_NONE, PIN_LEVEL_HIGH },
+    { LED_EX_3, PIN_MODE_OUTPUT, PIN_PULL_DEFAULT, PIN_SPEED_DEFAULT, PIN_TYPE_DEFAULT, PIN_AF_NONE, PIN_LEVEL_HIGH },
+  };
 
-  // Pro externi LED
-  // Nejdrive Aktivace CLK na portu
-  // Pak vynulovani MODERu pro dany pin (input mod)
-  // A nasledne nastaveni smeru pinu (output mod)
-  pin_enable(LED_EX_0);
-  pin_enable(LED_EX_1);
-  pin_enable(LED_EX_2);
-  pin_enable(LED_EX_3);
-  
-  pin_mode(LED_EX_0, PIN_MODE_OUTPUT);
-  pin_mode(LED_EX_1, PIN_MODE_OUTPUT);
-  pin_mode(LED_EX_2, PIN_MODE_OUTPUT);
-  pin_mode(LED_EX_3, PIN_MODE_OUTPUT);
-
-  // Zhasnuti externich LED (sviti v log. 0)
-  io_set(LED_EX_0, 1);
-  io_set(LED_EX_1, 1);
-  io_set(LED_EX_2, 1);
-  io_set(LED_EX_3, 1);
-
-  __enable_irq();
+  pin_setup_table(pins, PIN_TABLE_SIZE(pins));
 }
 
 #ifdef __cplusplus
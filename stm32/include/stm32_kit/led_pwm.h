@@ -0,0 +1,366 @@
+/**
+ * @file       led_pwm.h
+ * @brief      Jas a svetelne efekty LED pripravku (PWM, blikani, prechod, dychani).
+ *
+ *             LED, jejichz pin je vystupem kanalu casovace (alternativni funkce),
+ *             se ridi hardwarovym PWM (zapis do CCRx). Ostatni LED se ridi softwarove
+ *             bitovou modulaci (BAM) z preruseni jednoho casovace: 8 preruseni na
+ *             periodu, doba preruseni k se rovna vaze bitu 2^k, takze 8bitovy jas
+ *             stoji jen 8 preruseni za periodu (misto 256 u klasickeho SW PWM).
+ *
+ *             Efekty (LED_blink, LED_fade, LED_breathe) pocita stejne preruseni
+ *             jednou za periodu (LED_PWM_HZ), hlavni program se o ne nestara.
+ *             Jas je korigovany (kvadraticky), aby odpovidal vnimani oka.
+ *
+ *             Hardwarove kanaly:
+ *               F407 - PD12..PD15 = TIM4_CH1..CH4 (AF2) (TIM4 sdili s ws2812.h),
+ *               F401, F411 - PC6..PC9 = TIM3_CH1..CH4 (AF2),
+ *               G071 - PD0 = TIM16_CH1, PD1 = TIM17_CH1 (AF2).
+ *             Casovac pro SW PWM a efekty: F4 - TIM11, G0 - TIM14.
+ *
+ * @code
+ *     LED_pwm_setup();
+ *     LED_pwm(LED_PWM_IN_0, 64);             // Ctvrtinovy jas
+ *     LED_breathe(LED_PWM_IN_1, 2000, 255);  // Dychani s periodou 2 s
+ *     LED_blink(LED_PWM_EX_0, 100, 900, 255);
+ *     LED_fade(LED_PWM_IN_2, 255, 500);      // Rozsviceni za 0.5 s
+ * @endcode
+ *
+ * @author     Petr Madecki (petr.madecki@spsehavirov.cz)
+ * @author     Tomas Michalek (tomas.michalek@spsehavirov.cz)
+ *
+ * @date       2026-10-19
+ * @copyright  Copyright SPSE Havirov (c) 2026
+ */
+#ifndef STM32_KIT_LED_PWM
+#define STM32_KIT_LED_PWM
+
+#include "boards.h"
+
+#include "platform.h"
+#include "gpio.h"
+#include "pin.h"
+#include "timers.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LED_PWM_STEPS 255   // Perioda HW PWM v tikach (jas 0 - 255)
+
+enum led_pwm {
+  LED_PWM_IN_0 = 0,
+  LED_PWM_IN_1,
+  LED_PWM_IN_2,
+  LED_PWM_IN_3,
+  LED_PWM_EX_0,
+  LED_PWM_EX_1,
+  LED_PWM_EX_2,
+  LED_PWM_EX_3,
+  LED_PWM_COUNT
+};
+
+typedef enum {
+  LED_EFFECT_NONE = 0,
+  LED_EFFECT_BLINK,
+  LED_EFFECT_FADE,
+  LED_EFFECT_BREATHE
+} led_effect_t;
+
+/**
+ * @brief Pin LED vyvedeny na kanal casovace.
+ */
+typedef struct {
+  enum pin pin;
+  uint8_t  tim;      // Cislo casovace (TIMx)
+  uint8_t  channel;  // 1 - 4
+  uint8_t  af;
+} led_pwm_hw_t;
+
+//#========================================================================
+//#=== Kanaly casovacu a casovac efektu - ZACATEK
+#if defined(STM32F4)
+static const led_pwm_hw_t LED_PWM_hw[] = {
+  { PD12,  4, 1, PIN_AF2 },
+  { PD13,  4, 2, PIN_AF2 },
+  { PD14,  4, 3, PIN_AF2 },
+  { PD15,  4, 4, PIN_AF2 },
+  { PC6,   3, 1, PIN_AF2 },
+  { PC7,   3, 2, PIN_AF2 },
+  { PC8,   3, 3, PIN_AF2 },
+  { PC9,   3, 4, PIN_AF2 },
+};
+# define LED_PWM_TIM              11  // TIM11
+# define LED_PWM_TIM_IRQ_HANDLER  TIM1_TRG_COM_TIM11_IRQHandler
+#elif defined(STM32G0)
+static const led_pwm_hw_t LED_PWM_hw[] = {
+  { PD0,  16, 1, PIN_AF2 },
+  { PD1,  17, 1, PIN_AF2 },
+};
+# define LED_PWM_TIM              14  // TIM14
+# define LED_PWM_TIM_IRQ_HANDLER  TIM14_IRQHandler
+#else
+# error "LED PWM neni pro tuto radu implementovano (podporovano: F4, G0)."
+#endif
+//#=== Kanaly casovacu a casovac efektu - KONEC
+//#========================================================================
+
+/**
+ * @brief Stav jedne LED.
+ */
+typedef struct {
+  enum pin              pin;
+  const led_pwm_hw_t   *hw;       // 0 = softwarove PWM
+  const tim_t          *tim;      // Casovac HW kanalu
+  uint8_t               inverted; // Externi LED sviti v log. 0
+  volatile uint8_t      duty;     // Skutecna strida (po korekci jasu)
+  volatile uint8_t      level;    // Pozadovany jas
+  volatile uint8_t      effect;   // led_effect_t
+  uint8_t               from, to;
+  uint16_t              time, span, pause; // Tiky efektu (1 tik = 1 / LED_PWM_HZ)
+} led_pwm_t;
+
+static led_pwm_t         LED_pwm_leds[LED_PWM_COUNT];
+static const tim_t      *LED_pwm_tim;    // Casovac SW PWM a efektu
+static uint16_t          LED_pwm_unit;   // Tiky casovace na nejnizsi bit BAM
+static volatile uint8_t  LED_pwm_bit;
+
+/**
+ * @brief  Korekce jasu (vnimani oka je priblizne kvadraticke).
+ *
+ */
+INLINE_STM32 CONSTEXPR uint8_t LED_pwm_gamma(uint8_t level) {
+  return (uint8_t)(((uint32_t)level * level + 254) / 255);
+}
+
+/**
+ * @brief  Prevod milisekund na tiky efektu (alespon 1).
+ *
+ */
+INLINE_STM32 uint16_t LED_pwm_ticks(uint32_t ms) {
+  const uint32_t ticks = (ms * LED_PWM_HZ + 500) / 1000;
+  return ticks ? (uint16_t)ticks : 1;
+}
+
+/**
+ * @brief  Zapis strid do HW kanalu (CCRx s preloadem, zmena az od dalsi periody).
+ *
+ */
+INLINE_STM32 void LED_pwm_apply(led_pwm_t *led) {
+  led->duty = LED_pwm_gamma(led->level);
+  if (led->hw) *TIM_ccr(led->tim, led->hw->channel) = led->duty;
+}
+
+/**
+ * @brief  Nastaveni casovace HW kanalu (vice LED muze sdilet jeden casovac).
+ *
+ */
+void LED_pwm_channel(led_pwm_t *led, uint32_t *started) {
+  const tim_t *t = led->tim;
+
+  if (!(*started & (1UL << t->number))) {     // Prvni kanal casovace
+    *started |= 1UL << t->number;
+    TIM_enable(t);
+    t->tim->PSC = TIM_clock(t) / (LED_PWM_STEPS * LED_PWM_HZ) - 1;
+    t->tim->ARR = LED_PWM_STEPS - 1;          // CCR = 255 sviti trvale
+  }
+  TIM_pwm_channel(t, led->hw->channel, led->inverted);
+  t->tim->EGR = TIM_EGR_UG;
+  t->tim->CR1 |= TIM_CR1_CEN;
+}
+
+/**
+ * @brief  Pocatecni inicializace: LED s kanalem casovace jako AF, ostatni jako vystupy
+ *         pro SW PWM, spusteni casovace efektu. Vsechny LED zhasnute.
+ *
+ */
+void LED_pwm_setup(void) {
+  static const enum pin pins[LED_PWM_COUNT] = {
+    LED_IN_0, LED_IN_1, LED_IN_2, LED_IN_3, LED_EX_0, LED_EX_1, LED_EX_2, LED_EX_3
+  };
+
+  uint32_t started = 0;                       // Casovace HW kanalu uz nastavene
+
+  for (int i = 0; i < LED_PWM_COUNT; i++) {
+    led_pwm_t *led = &LED_pwm_leds[i];
+
+    led->pin      = pins[i];
+    led->hw       = 0;
+    led->tim      = 0;
+    led->inverted = (i >= LED_PWM_EX_0);
+    led->level    = 0;
+    led->effect   = LED_EFFECT_NONE;
+    if (led->pin == NC || led->pin == P_INVALID) continue;
+
+    for (unsigned h = 0; h < sizeof(LED_PWM_hw) / sizeof(LED_PWM_hw[0]); h++) {
+      if (LED_PWM_hw[h].pin == led->pin && TIM_get(LED_PWM_hw[h].tim)) {
+        led->hw  = &LED_PWM_hw[h];
+        led->tim = TIM_get(led->hw->tim);
+      }
+    }
+
+    if (led->hw) {
+      LED_pwm_channel(led, &started);
+      pin_setup_af(led->pin, PIN_MODE_AF, PIN_PULL_DEFAULT, PIN_SPEED_DEFAULT, PIN_TYPE_PUSHPULL, (pin_af_t)led->hw->af);
+    } else {
+      pin_enable(led->pin);                   // Zhasnuti jeste pred prepnutim na vystup
+      io_set(led->pin, led->inverted);
+      pin_setup(led->pin, PIN_MODE_OUTPUT, PIN_PULL_DEFAULT, PIN_SPEED_DEFAULT, PIN_TYPE_PUSHPULL);
+    }
+    LED_pwm_apply(led);
+  }
+
+  // Casovac BAM: nejdelsi bit (128 jednotek) se musi vejit do 16bit ARR
+  LED_pwm_tim = TIM_get(LED_PWM_TIM);
+  TIM_enable(LED_pwm_tim);
+
+  const uint32_t unit = TIM_clock(LED_pwm_tim) / (LED_PWM_STEPS * LED_PWM_HZ);
+  const uint32_t psc  = (unit * 128 - 1) >> 16;
+
+  LED_pwm_unit = (uint16_t)(unit / (psc + 1));
+  LED_pwm_bit  = 0;
+
+  LED_pwm_tim->tim->PSC = psc;                // ARR bez preloadu, zapis v preruseni plati hned
+  LED_pwm_tim->tim->ARR = LED_pwm_unit - 1;
+  LED_pwm_tim->tim->EGR = TIM_EGR_UG;
+  TIM_irq_enable(LED_pwm_tim);
+  TIM_start(LED_pwm_tim);
+}
+
+/**
+ * @brief  Ma LED hardwarovy kanal PWM?
+ *
+ */
+INLINE_STM32 int LED_pwm_is_hw(enum led_pwm id) {
+  return LED_pwm_leds[id].hw != 0;
+}
+
+/**
+ * @brief  Nastaveni jasu LED (zrusi probihajici efekt).
+ *
+ * @param  id    LED (LED_PWM_IN_x, LED_PWM_EX_x).
+ * @param  level Jas 0 - 255.
+ *
+ */
+void LED_pwm(enum led_pwm id, uint8_t level) {
+  led_pwm_t *led = &LED_pwm_leds[id];
+
+  led->effect = LED_EFFECT_NONE;
+  led->level  = level;
+  LED_pwm_apply(led);
+}
+
+/**
+ * @brief  Aktualni jas LED (i behem efektu).
+ *
+ */
+INLINE_STM32 uint8_t LED_pwm_level(enum led_pwm id) {
+  return LED_pwm_leds[id].level;
+}
+
+/**
+ * @brief  Spusteni efektu (parametry se zapisou pred zmenou effect, preruseni je vidi konzistentni).
+ *
+ */
+INLINE_STM32 void LED_effect(enum led_pwm id, led_effect_t effect, uint8_t to, uint16_t span, uint16_t pause) {
+  led_pwm_t *led = &LED_pwm_leds[id];
+
+  led->effect = LED_EFFECT_NONE;
+  led->from   = led->level;
+  led->to     = to;
+  led->span   = span;
+  led->pause  = pause;
+  led->time   = 0;
+  led->effect = effect;
+}
+
+/**
+ * @brief  Blikani.
+ *
+ * @param  on_ms  Doba svitu.
+ * @param  off_ms Doba zhasnuti.
+ * @param  level  Jas pri svitu.
+ *
+ */
+void LED_blink(enum led_pwm id, uint16_t on_ms, uint16_t off_ms, uint8_t level) {
+  LED_effect(id, LED_EFFECT_BLINK, level, LED_pwm_ticks(on_ms), LED_pwm_ticks(off_ms));
+}
+
+/**
+ * @brief  Plynuly prechod z aktualniho jasu na @p level (pak efekt skonci).
+ *
+ */
+void LED_fade(enum led_pwm id, uint8_t level, uint16_t ms) {
+  LED_effect(id, LED_EFFECT_FADE, level, LED_pwm_ticks(ms), 0);
+}
+
+/**
+ * @brief  Dychani - jas plynule 0 -> @p level -> 0 s periodou @p period_ms.
+ *
+ */
+void LED_breathe(enum led_pwm id, uint16_t period_ms, uint8_t level) {
+  LED_effect(id, LED_EFFECT_BREATHE, level, LED_pwm_ticks(period_ms / 2), 0);
+}
+
+/**
+ * @brief  Jeden tik efektu (v preruseni, jednou za periodu PWM).
+ *
+ */
+INLINE_STM32 void LED_effect_tick(led_pwm_t *led) {
+  switch (led->effect) {
+    case LED_EFFECT_BLINK:
+      led->level = (led->time < led->span) ? led->to : 0;
+      if (++led->time >= led->span + led->pause) led->time = 0;
+      break;
+
+    case LED_EFFECT_FADE:
+      if (++led->time >= led->span) {
+        led->level  = led->to;
+        led->effect = LED_EFFECT_NONE;
+      } else {
+        led->level = (uint8_t)(led->from + ((int32_t)led->to - led->from) * led->time / led->span);
+      }
+      break;
+
+    case LED_EFFECT_BREATHE: {
+      const uint16_t t = (led->time < led->span) ? led->time : 2 * led->span - led->time; // Trojuhelnik
+      led->level = (uint8_t)((uint32_t)led->to * t / led->span);
+      if (++led->time >= 2 * led->span) led->time = 0;
+      break;
+    }
+
+    default:
+      return;
+  }
+  LED_pwm_apply(led);
+}
+
+/**
+ * @brief  Obsluha preruseni casovace efektu: bit BAM pro SW LED, jednou za periodu efekty.
+ *
+ */
+void LED_PWM_TIM_IRQ_HANDLER(void) {
+  const uint8_t bit = LED_pwm_bit;
+
+  LED_pwm_tim->tim->SR &= ~(TIM_SR_UIF);
+  LED_pwm_tim->tim->ARR = ((uint32_t)LED_pwm_unit << bit) - 1;  // Delka prave zacinajiciho bitu
+
+  for (int i = 0; i < LED_PWM_COUNT; i++) {
+    const led_pwm_t *led = &LED_pwm_leds[i];
+    if (led->hw || led->pin == NC || led->pin == P_INVALID) continue;
+    io_set(led->pin, ((led->duty >> bit) & 1) ^ led->inverted);
+  }
+
+  LED_pwm_bit = (bit + 1) & 7;
+  if (bit == 7) {                             // Nejdelsi bit - cas na prepocet efektu
+    for (int i = 0; i < LED_PWM_COUNT; i++) {
+      LED_effect_tick(&LED_pwm_leds[i]);
+    }
+  }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STM32_KIT_LED_PWM */
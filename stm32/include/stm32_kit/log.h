@@ -0,0 +1,244 @@
+/**
+ * @file       log.h
+ * @brief      Binarni log s odlozenym formatovanim.
+ *
+ *             LOG() na MCU nic neformatuje: do kruhoveho bufferu v RAM zapise jen
+ *             adresu formatovaciho retezce (ID), cas (Ticks) a argumenty jako 32bit
+ *             slova - nekolik zapisu do pameti v kratke kriticke sekci, lze volat
+ *             i z preruseni. Formatovaci retezce lezi v sekci .logfmt (ve flash,
+ *             MCU je nikdy necte), LOG_drain() (s UART_DMA = 1) posila zaznamy na
+ *             pozadi pres packet.h (COBS + CRC-32, vysila DMA). Text sestavi az
+ *             program na PC z retezcu nactenych z ELF:
+ *
+ *               python3 tools/log_decode.py build/app.axf --port COM3 --baud 115200
+ *
+ *             Zaznam = [adresa retezce][pocet argumentu << 28 | Ticks][argumenty...],
+ *             paket obsahuje jen cele zaznamy (ztraceny paket nerozbije ostatni).
+ *
+ *             Argumenty (nejvyse 8) se ukladaji jako 32 bitu: celociselne typy,
+ *             float/double (jako float), libovolne ukazatele. %s funguje jen pro
+ *             konstantni retezce (nacitaji se z ELF podle adresy), 64bit cela
+ *             cisla se oriznou. Pri plnem bufferu se zaznam zahodi, pocet
+ *             zahozenych zaznamu se odesle jako samostatny zaznam s casem prvniho
+ *             zahozeni. Casy zaznamu nemusi jit po sobe (preruseni mezi ctenim
+ *             Ticks a zapisem), PC je bere jako rozdil se znamenkem.
+ *
+ *             Jen pro C (LOG() pouziva _Generic).
+ *
+ * @code
+ *     UART_setup();
+ *     UART_dma_setup();
+ *
+ *     LOG("start, jadro %u Hz", SystemCoreClock);
+ *     LOG("ADC %d, U = %.3f V", raw, raw * 3.3f / 4095);
+ *
+ *     while (1) {
+ *       ...
+ *       LOG_drain();                                 // Neblokuje, vola se ze smycky
+ *     }
+ * @endcode
+ *
+ * @author     Petr Madecki (petr.madecki@spsehavirov.cz)
+ * @author     Tomas Michalek (tomas.michalek@spsehavirov.cz)
+ *
+ * @date       2026-10-19
+ * @copyright  Copyright SPSE Havirov (c) 2026
+ */
+#ifndef STM32_KIT_LOG
+#define STM32_KIT_LOG
+
+#include <stdint.h>
+
+#include "platform.h"
+#include "chrono.h"
+
+#ifndef LOG_ENABLE
+# define LOG_ENABLE  1              // 0 = LOG() se neprelozi (argumenty se nevyhodnoti)
+#endif
+
+#ifndef LOG_RING
+# define LOG_RING    256            // Velikost bufferu ve slovech (mocnina 2)
+#endif
+
+#ifndef LOG_UART                    // 1 = LOG_drain() pres packet.h (vychozi s UART_DMA)
+# if UART_DMA
+#  define LOG_UART  1
+# else
+#  define LOG_UART  0
+# endif
+#endif
+
+#if LOG_UART
+# include "packet.h"
+#endif
+
+#ifdef __cplusplus
+# error "log.h je jen pro C (LOG() pouziva _Generic)."
+#endif
+
+#if LOG_RING & (LOG_RING - 1)
+# error "LOG_RING musi byt mocnina 2!"
+#endif
+
+#define LOG_RING_MASK  (LOG_RING - 1)
+#define LOG_MAX_ARGS   8
+#define LOG_TIME_MASK  0x0FFFFFFFUL   // Cas v zaznamu (28 bitu Ticks, PC dopocita preteceni)
+#define LOG_SECTION    __attribute__((section(".logfmt")))
+
+#if LOG_UART && (PKT_MAX / 4 < 2 + LOG_MAX_ARGS)
+# error "PKT_MAX je pro zaznam logu prilis male!"
+#endif
+
+static uint32_t          LOG_ring[LOG_RING];
+static volatile uint32_t LOG_head;            // Konec zapsanych zaznamu (slova, volne bezici)
+static volatile uint32_t LOG_tail;            // Zacatek neodeslanych zaznamu
+static volatile uint32_t LOG_dropped;         // Zahozene zaznamy (plny buffer)
+static volatile uint32_t LOG_reported;        // Zahozene zaznamy uz oznamene na PC
+static uint32_t          LOG_drop_time;       // Cas prvniho zahozeni od posledniho oznameni
+
+//#=================================================================================================
+//#=== Prevod argumentu na slova - ZACATEK
+//#=================================================================================================
+INLINE_STM32 uint32_t LOG_f32(float value) {
+  union { float f; uint32_t u; } bits = { value };
+  return bits.u;
+}
+
+INLINE_STM32 uint32_t LOG_f64(double value) { return LOG_f32((float)value); }
+
+INLINE_STM32 uint32_t LOG_ptr(const void *ptr) { return (uint32_t)(uintptr_t)ptr; }
+
+// Vsechny vetve _Generic se prekladaji pro kazdy typ argumentu: LOG_REAL() dava
+// vetvim float/double vyraz, ktery jde prelozit i s ukazatelem, default prevede
+// cela cisla i libovolne ukazatele.
+#define LOG_REAL(x) _Generic((x), float: (x), double: (x), default: 0.0f)
+#define LOG_ARG(x)  _Generic((x),                                                \
+    float:   LOG_f32(LOG_REAL(x)),                                               \
+    double:  LOG_f64(LOG_REAL(x)),                                               \
+    default: (uint32_t)(uintptr_t)(x))
+
+#define LOG_CAT_(a, b)  a##b
+#define LOG_CAT(a, b)   LOG_CAT_(a, b)
+#define LOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, n, ...) n
+#define LOG_NARGS(...)  LOG_NARGS_(0, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+
+#define LOG_MAP_0()
+#define LOG_MAP_1(a)                      LOG_ARG(a),
+#define LOG_MAP_2(a, b)                   LOG_ARG(a), LOG_ARG(b),
+#define LOG_MAP_3(a, b, c)                LOG_MAP_2(a, b) LOG_ARG(c),
+#define LOG_MAP_4(a, b, c, d)             LOG_MAP_3(a, b, c) LOG_ARG(d),
+#define LOG_MAP_5(a, b, c, d, e)          LOG_MAP_4(a, b, c, d) LOG_ARG(e),
+#define LOG_MAP_6(a, b, c, d, e, f)       LOG_MAP_5(a, b, c, d, e) LOG_ARG(f),
+#define LOG_MAP_7(a, b, c, d, e, f, g)    LOG_MAP_6(a, b, c, d, e, f) LOG_ARG(g),
+#define LOG_MAP_8(a, b, c, d, e, f, g, h) LOG_MAP_7(a, b, c, d, e, f, g) LOG_ARG(h),
+#define LOG_MAP(...)    LOG_CAT(LOG_MAP_, LOG_NARGS(__VA_ARGS__))(__VA_ARGS__)
+//#=================================================================================================
+//#=== Prevod argumentu na slova - KONEC
+//#=================================================================================================
+
+/**
+ * @brief  Zapis celeho zaznamu do bufferu (kriticka sekce jen po dobu kopirovani).
+ *
+ * @param  words Zaznam.
+ * @param  n     Delka zaznamu ve slovech.
+ *
+ */
+INLINE_STM32 void LOG_write(const uint32_t *words, uint32_t n) {
+  const uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+
+  const uint32_t head = LOG_head;
+  if (LOG_RING - (head - LOG_tail) >= n) {
+    for (uint32_t i = 0; i < n; i++) {
+      LOG_ring[(head + i) & LOG_RING_MASK] = words[i];
+    }
+    LOG_head = head + n;
+  } else {
+    if (LOG_dropped++ == LOG_reported) LOG_drop_time = words[1] & LOG_TIME_MASK;
+  }
+
+  __set_PRIMASK(primask);
+}
+
+#if LOG_ENABLE
+/**
+ * @brief  Zaznam do logu, @p fmt musi byt retezcovy literal (formatovani jako printf na PC).
+ *
+ */
+# define LOG(fmt, ...) do {                                                      \
+    static const char LOG_fmt_[] LOG_SECTION = fmt;                              \
+    uint32_t LOG_rec_[] = { LOG_ptr(LOG_fmt_), 0, LOG_MAP(__VA_ARGS__) };         \
+    const uint32_t LOG_len_ = sizeof(LOG_rec_) / sizeof(LOG_rec_[0]);            \
+    LOG_rec_[1] = ((LOG_len_ - 2) << 28) | (Ticks & LOG_TIME_MASK);              \
+    LOG_write(LOG_rec_, LOG_len_);                                               \
+  } while (0)
+#else
+# define LOG(fmt, ...) do { } while (0)
+#endif
+
+static const char LOG_fmt_dropped[] LOG_SECTION = "log: zahozeno %u zaznamu (plny buffer)";
+
+/**
+ * @brief  Pocet slov v bufferu cekajicich na odeslani.
+ *
+ */
+INLINE_STM32 uint32_t LOG_pending(void) {
+  return LOG_head - LOG_tail;
+}
+
+/**
+ * @brief  Vyzvednuti celych zaznamu z bufferu (pro vlastni prenos, LOG_drain() pouziva packet.h).
+ *         Pokud se od minula zahazovalo, zacina zaznamem s poctem zahozenych.
+ *
+ * @param  buf Cil.
+ * @param  max Velikost @p buf ve slovech (alespon 2 + LOG_MAX_ARGS).
+ *
+ * @return Pocet zkopirovanych slov, 0 = buffer je prazdny.
+ */
+uint32_t LOG_read(uint32_t *buf, uint32_t max) {
+  uint32_t n = 0;
+
+  if (LOG_dropped != LOG_reported && max >= 3) {
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();                            // Pocet a cas prvniho zahozeni spolu
+    buf[n++] = LOG_ptr(LOG_fmt_dropped);
+    buf[n++] = (1UL << 28) | LOG_drop_time;
+    buf[n++] = LOG_dropped - LOG_reported;
+    LOG_reported = LOG_dropped;
+    __set_PRIMASK(primask);
+  }
+
+  const uint32_t head = LOG_head;               // Zapisuje se vzdy cely zaznam
+  uint32_t tail = LOG_tail;
+  while (tail != head) {
+    const uint32_t len = 2 + (LOG_ring[(tail + 1) & LOG_RING_MASK] >> 28);
+    if (n + len > max) break;
+
+    for (uint32_t i = 0; i < len; i++) {
+      buf[n++] = LOG_ring[(tail + i) & LOG_RING_MASK];
+    }
+    tail += len;
+  }
+  LOG_tail = tail;                              // Misto se uvolni az po zkopirovani
+
+  return n;
+}
+
+#if LOG_UART
+/**
+ * @brief  Odeslani cekajicich zaznamu v paketech, jen dokud je misto ve vysilacim
+ *         bufferu UART (neblokuje). Vola se z hlavni smycky, ne z preruseni.
+ *
+ */
+void LOG_drain(void) {
+  static uint32_t packet[PKT_MAX / 4];
+
+  while ((LOG_pending() || LOG_dropped != LOG_reported) && UART_tx_space() >= PKT_FRAME(PKT_MAX)) {
+    const uint32_t n = LOG_read(packet, PKT_MAX / 4);
+    if (!n) break;
+    PKT_send(packet, (uint16_t)(n * 4));
+  }
+}
+#endif
+
+#endif /* STM32_KIT_LOG */
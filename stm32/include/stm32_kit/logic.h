@@ -0,0 +1,339 @@
+/**
+ * @file       logic.h
+ * @brief      Logicky analyzator - vzorkovani vstupu portu (IDR) casovacem a DMA do RAM.
+ *
+ *             Az 3 porty se vzorkuji soucasne (pozadavky UP, CC1 a CC2 jednoho casovace
+ *             pri CNT = 0), kazdy port do sve casti bufferu. Vzorkovani bezi bez ucasti
+ *             CPU, rychlost je omezena jen propustnosti DMA (jednotky MHz).
+ *
+ *             Spoustec (trigger): prvni vzorek prvniho portu, pro ktery plati
+ *             (vzorek & mask) == value. Buffer se plni kruhove, po spousteci se zachyti
+ *             jeste @p post vzorku, zbytek bufferu obsahuje historii pred spoustecim.
+ *             Zaznam se zastavi az na hranici poloviny bufferu, vzorky nad @p post
+ *             prepsaly nejstarsi historii a export je vynecha (samples= je pak mensi).
+ *             Bez spoustece (mask = 0) se buffer naplni jednou od startu.
+ *
+ *             Export (LA_export) je textovy a komprimovany delkou behu (RLE):
+ *               LA rate=1000000 ports=2 samples=1024 trigger=512
+ *               00F0,0001 37        <- hodnoty portu (hex) a pocet opakovani
+ *               ...
+ *               END
+ *
+ *             Smerovani: F4 - pozadavky TIM8 (UP, CH1, CH2), F401/F411 (bez TIM8) - TIM1
+ *                        (stejny casovac jako wave.h), G0 - TIM15 (UP, CH1, CH2),
+ *                        streamy/kanaly DMA prideli dma_alloc(). Na F4 ma pristup
+ *                        ke GPIO jen DMA2, pripadaji tedy v uvahu jen TIM1 a TIM8.
+ *
+ * @code
+ *     static uint16_t samples[2 * 1024];
+ *     LA_setup(1000000, samples, 1024, PD0, PE0, P_INVALID); // KeyPad (port D) a LCD (port E), 1MHz
+ *     LA_trigger(1UL << 6, 0, 512);                         // PD6 (radek klavesnice) v log. 0
+ *     LA_start();
+ *     while (!LA_done()) {}
+ *     LA_export(UART_putc);
+ * @endcode
+ *
+ * @author     Petr Madecki (petr.madecki@spsehavirov.cz)
+ * @author     Tomas Michalek (tomas.michalek@spsehavirov.cz)
+ *
+ * @date       2026-10-19
+ * @copyright  Copyright SPSE Havirov (c) 2026
+ */
+#ifndef STM32_KIT_LOGIC
+#define STM32_KIT_LOGIC
+
+#include "platform.h"
+#include "gpio.h"
+#include "timers.h"
+#include "dma.h"
+#include "format.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LA_PORTS 3    // Maximalni pocet soucasne vzorkovanych portu
+
+//#========================================================================
+//#=== Smerovani casovac -> DMA - ZACATEK
+#ifndef LA_TIM
+# if defined(STM32F4) && defined(TIM8)
+#  define LA_TIM  8   // TIM8
+#  define LA_REQ  { DMA_REQ_TIM8_UP, DMA_REQ_TIM8_CH1, DMA_REQ_TIM8_CH2 }
+# elif defined(STM32F4)
+#  define LA_TIM  1   // TIM1 (F401/F411 nemaji TIM8)
+#  define LA_REQ  { DMA_REQ_TIM1_UP, DMA_REQ_TIM1_CH1, DMA_REQ_TIM1_CH2 }
+# elif defined(STM32G0)
+#  define LA_TIM  15  // TIM15
+#  define LA_REQ  { DMA_REQ_TIM15_UP, DMA_REQ_TIM15_CH1, DMA_REQ_TIM15_CH2 }
+# endif
+#endif
+
+#ifndef LA_REQ
+# error "logic.h: LA_TIM bez LA_REQ (pozadavky DMA pro UP, CH1 a CH2 casovace)"
+#endif
+//#=== Smerovani casovac -> DMA - KONEC
+//#========================================================================
+
+static const dma_t *LA_dma[LA_PORTS];
+static const tim_t *LA_tim;
+
+typedef enum {
+  LA_IDLE = 0,
+  LA_ARMED,         // Vzorkuje se, ceka se na spoustec
+  LA_TRIGGERED,     // Spoustec nastal, dobiha se @p post vzorku
+  LA_DONE
+} la_state_t;
+
+static GPIO_TypeDef        *LA_port[LA_PORTS];
+static int                  LA_ports;
+static uint16_t            *LA_buffer;
+static uint16_t             LA_samples;
+static uint32_t             LA_rate;
+static uint16_t             LA_mask, LA_value, LA_post;
+static volatile la_state_t  LA_state;
+static volatile uint32_t    LA_total;         // Pocet vzorku zpracovanych v preruseni
+static volatile uint32_t    LA_trigger_total; // Poradi vzorku se spoustecem
+static uint16_t             LA_end[LA_PORTS]; // Pozice nejstarsiho vzorku po zastaveni
+static uint16_t             LA_count;         // Pocet platnych vzorku od nejstarsiho (bez dobehu za post)
+static uint16_t             LA_trigger_index; // Spoustec od nejstarsiho vzorku
+
+void LA_dma_event(void *ctx, uint32_t flags);
+
+/**
+ * @brief  Pocatecni inicializace analyzatoru.
+ *         Piny portu se nemeni (analyzator jen cte IDR), port musi mit zapnute hodiny.
+ *
+ * @param  rate_hz Vzorkovaci frekvence.
+ * @param  buffer  Buffer pro ports * samples vzorku (port 0, port 1, ...).
+ * @param  samples Pocet vzorku na port (sude cislo).
+ * @param  port0   Libovolny pin prvniho portu (spoustec se vyhodnocuje na nem).
+ * @param  port1   Pin druheho portu, nebo P_INVALID.
+ * @param  port2   Pin tretiho portu, nebo P_INVALID.
+ *
+ * @return Skutecna vzorkovaci frekvence, 0 = neni volny kanal DMA.
+ */
+uint32_t LA_setup(uint32_t rate_hz, uint16_t *buffer, uint16_t samples, enum pin port0, enum pin port1, enum pin port2) {
+  const enum pin ports[LA_PORTS] = { port0, port1, port2 };
+
+  LA_ports = 0;
+  for (int i = 0; i < LA_PORTS && ports[i] != P_INVALID && ports[i] != NC; i++) {
+    LA_port[LA_ports++] = io_port(ports[i]);
+  }
+  LA_buffer  = buffer;
+  LA_samples = samples & ~1U;
+  LA_mask    = 0;
+  LA_state   = LA_IDLE;
+
+  static const dma_request_t requests[LA_PORTS] = LA_REQ;
+  for (int i = 0; i < LA_ports; i++) {
+    if (!LA_dma[i]) LA_dma[i] = dma_alloc(requests[i]);
+    if (!LA_dma[i]) {                         // Stream/kanal DMA obsazen jinym ovladacem
+      for (int k = 0; k < i; k++) {           //  - uvolnit i uz pridelene
+        dma_free(LA_dma[k]);
+        LA_dma[k] = 0;
+      }
+      return 0;
+    }
+  }
+  if (LA_ports) dma_callback(LA_dma[0], LA_dma_event, 0); // Preruseni jen od prvniho portu (spoustec)
+
+  LA_tim = TIM_get(LA_TIM);
+  TIM_enable(LA_tim);
+
+  LA_tim->tim->CCR1 = 0;                      // CC1 a CC2 ve stejnem okamziku jako UP
+  LA_tim->tim->CCR2 = 0;
+  LA_rate = TIM_set_rate(LA_tim, rate_hz);
+  return LA_rate;
+}
+
+/**
+ * @brief  Nastaveni spoustece.
+ *
+ * @param  mask  Sledovane piny prvniho portu (0 = bez spoustece, buffer se naplni od startu).
+ * @param  value Hodnota sledovanych pinu.
+ * @param  post  Pocet vzorku po spousteci (nejvyse samples / 2, aby spoustec nebyl prepsan).
+ *
+ */
+void LA_trigger(uint16_t mask, uint16_t value, uint16_t post) {
+  LA_mask  = mask;
+  LA_value = value & mask;
+  LA_post  = (post > LA_samples / 2) ? LA_samples / 2 : post;
+}
+
+/**
+ * @brief  Zastaveni vzorkovani a ulozeni pozice nejstarsiho vzorku kazdeho portu.
+ *
+ */
+void LA_stop(void) {
+  if (!LA_dma[0]) return;                     // LA_setup() neuspel
+
+  TIM_stop(LA_tim);
+  LA_tim->tim->DIER &= ~(TIM_DIER_UDE | TIM_DIER_CC1DE | TIM_DIER_CC2DE);
+
+  for (int i = 0; i < LA_ports; i++) {
+    const uint16_t left = dma_remaining(LA_dma[i]);
+    LA_end[i] = (left >= LA_samples) ? 0 : LA_samples - left; // Dalsi zapis = nejstarsi vzorek
+    dma_stop(LA_dma[i]);
+  }
+}
+
+/**
+ * @brief  Spusteni vzorkovani.
+ *
+ */
+void LA_start(void) {
+  static const uint32_t requests[LA_PORTS] = { TIM_DIER_UDE, TIM_DIER_CC1DE, TIM_DIER_CC2DE };
+  const uint32_t mode = DMA_PERIPH_TO_MEM | DMA_SIZE_16 | (LA_mask ? DMA_CIRCULAR : 0);
+  uint32_t dier = 0;
+
+  if (!LA_dma[0]) return;                     // LA_setup() neuspel
+
+  LA_stop();
+  LA_total = 0;
+  LA_state = LA_ARMED;
+
+  for (int i = 0; i < LA_ports; i++) {
+    dma_start(LA_dma[i], &LA_port[i]->IDR, LA_buffer + i * LA_samples, LA_samples,
+              mode | (i == 0 ? DMA_IRQ : 0));  // Preruseni jen od prvniho portu (spoustec)
+    dier |= requests[i];
+  }
+
+  LA_tim->tim->SR    = 0;
+  LA_tim->tim->DIER |= dier;
+  TIM_start(LA_tim);
+}
+
+/**
+ * @brief  Je zaznam hotovy?
+ *
+ */
+INLINE_STM32 int LA_done(void) {
+  return LA_state == LA_DONE;
+}
+
+/**
+ * @brief  Vyhledani spoustece v prave zapsane polovine bufferu a kontrola konce zaznamu.
+ *
+ */
+INLINE_STM32 void LA_process_half(uint16_t first) {
+  const uint16_t half = LA_samples / 2;
+
+  if (LA_state == LA_ARMED) {
+    const uint16_t *s = LA_buffer + first;
+    for (uint16_t i = 0; i < half; i++) {
+      if ((s[i] & LA_mask) == LA_value) {
+        LA_trigger_total = LA_total + i;
+        LA_state = LA_TRIGGERED;
+        break;
+      }
+    }
+  }
+
+  LA_total += half;
+
+  if (LA_state == LA_TRIGGERED && LA_total >= LA_trigger_total + LA_post) {
+    LA_stop();
+
+    // DMA dobehlo za spoustec + post (konec poloviny, latence preruseni) a prepsalo
+    // tolik nejstarsich vzorku - zaznam konci presne @p post vzorku za spoustecem
+    const uint16_t last = (uint16_t)((LA_trigger_total + LA_post) % LA_samples);
+    uint16_t overrun = (uint16_t)((LA_end[0] + LA_samples - 1 - last) % LA_samples);
+    if (overrun > LA_samples - 1 - LA_post) overrun = LA_samples - 1 - LA_post; // Spoustec uz prepsan
+    LA_count = LA_samples - overrun;
+    LA_trigger_index = LA_count - 1 - LA_post;
+    LA_state = LA_DONE;
+  }
+}
+
+/**
+ * @brief  Udalost DMA prvniho portu (z preruseni DMA).
+ *
+ */
+void LA_dma_event(void *ctx, uint32_t flags) {
+  (void)ctx;
+
+  if (flags & DMA_FLAG_ERROR) {
+    LA_stop();
+    LA_state = LA_IDLE;
+    return;
+  }
+  if (!LA_mask) {                             // Bez spoustece: jeden pruchod bufferem
+    if (flags & DMA_FLAG_COMPLETE) {
+      LA_stop();
+      LA_end[0] = 0;
+      for (int i = 1; i < LA_ports; i++) LA_end[i] = 0;
+      LA_trigger_total = 0;
+      LA_total = LA_samples;
+      LA_count = LA_samples;
+      LA_trigger_index = 0;
+      LA_state = LA_DONE;
+    }
+    return;
+  }
+
+  if (flags & DMA_FLAG_HALF) LA_process_half(0);
+  if ((flags & DMA_FLAG_COMPLETE) && LA_state != LA_DONE) LA_process_half(LA_samples / 2);
+}
+
+/**
+ * @brief  Vzorek @p k (0 = nejstarsi) portu @p port.
+ *
+ */
+INLINE_STM32 uint16_t LA_sample(int port, uint16_t k) {
+  uint32_t index = (uint32_t)LA_end[port] + k;
+  if (index >= LA_samples) index -= LA_samples;
+  return LA_buffer[port * LA_samples + index];
+}
+
+/**
+ * @brief  Export zaznamu komprimovaneho delkou behu (viz popis souboru).
+ *         Vzorky zachycene po spousteci nad @p post se vynechaji, trigger= je
+ *         presna pozice vzorku se spoustecem.
+ *
+ * @param  sink Vystupni funkce (napr. UART_putc).
+ *
+ */
+void LA_export(fmt_sink_t sink) {
+  fmt_str(sink, "LA rate=");
+  fmt_uint(sink, LA_rate, 0, ' ');
+  fmt_str(sink, " ports=");
+  fmt_uint(sink, LA_ports, 0, ' ');
+  fmt_str(sink, " samples=");
+  fmt_uint(sink, LA_count, 0, ' ');
+  fmt_str(sink, " trigger=");
+  fmt_uint(sink, LA_trigger_index, 0, ' ');
+  sink('\n');
+
+  uint16_t k = 0;
+  while (k < LA_count) {
+    uint16_t run = 1;
+
+    while (k + run < LA_count) {            // Delka behu stejnych hodnot vsech portu
+      int same = 1;
+      for (int p = 0; p < LA_ports && same; p++) {
+        same = LA_sample(p, k + run) == LA_sample(p, k);
+      }
+      if (!same) break;
+      run++;
+    }
+
+    for (int p = 0; p < LA_ports; p++) {
+      if (p) sink(',');
+      fmt_hex(sink, LA_sample(p, k), 4);
+    }
+    sink(' ');
+    fmt_uint(sink, run, 0, ' ');
+    sink('\n');
+
+    k += run;
+  }
+
+  fmt_str(sink, "END\n");
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STM32_KIT_LOGIC */
@@ -0,0 +1,234 @@
+/**
+ * @file       packet.h
+ * @brief      Binarni pakety pres UART: COBS ramce s CRC-32, prijem bez kopirovani.
+ *
+ *             Ramec = COBS(data + CRC-32 data, little endian) + 0x00.
+ *             COBS nahradi vsechny nulove bajty, takze 0x00 jednoznacne oddeluje
+ *             ramce a prijemce se po chybe zasynchronizuje na dalsim ramci. Rezie je
+ *             6 bajtu na ramec (+1 na kazdych 254 bajtu), binarni telemetrie je
+ *             tak zhruba trikrat kratsi nez stejne hodnoty vypsane textem.
+ *
+ *             PKT_send() koduje data primo do vysilaciho bufferu UART (UART_tx_ring)
+ *             a CRC pripoji na konec, ramec zverejni az cely (DMA nikdy nevysle
+ *             rozpracovany ramec). PKT_receive() hleda oddelovac v prijimacim bufferu
+ *             (UART_rx_ring) a dekoduje ramec na miste - vystup COBS je vzdy kratsi
+ *             nez vstup, data se tedy jen posunou k zacatku ramce. Vraci ukazatel do
+ *             bufferu, ktery plati do dalsiho PKT_receive() (a dokud ho DMA neprepise
+ *             dalsim obehem). Jen ramec, ktery prechazi pres konec bufferu, se dekoduje
+ *             do pomocneho bufferu PKT_spill.
+ *
+ *             Protistrana v Pythonu (cobs z PyPI):
+ *               frame = cobs.decode(raw[:-1]); data, crc = frame[:-4], frame[-4:]
+ *               ok = zlib.crc32(data) == int.from_bytes(crc, "little")
+ *
+ * @code
+ *     UART_setup();
+ *     UART_dma_setup();
+ *
+ *     PKT_send(&sample, sizeof(sample));            // Telemetrie
+ *
+ *     uint16_t len;
+ *     const uint8_t *cmd = PKT_receive(&len);       // 0 = neni cely platny ramec
+ *     if (cmd) { ... }
+ * @endcode
+ *
+ * @author     Petr Madecki (petr.madecki@spsehavirov.cz)
+ * @author     Tomas Michalek (tomas.michalek@spsehavirov.cz)
+ *
+ * @date       2026-10-19
+ * @copyright  Copyright SPSE Havirov (c) 2026
+ */
+#ifndef STM32_KIT_PACKET
+#define STM32_KIT_PACKET
+
+#include <string.h>
+
+#include "platform.h"
+#include "uart.h"
+#include "crc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if !UART_DMA
+# error "packet.h vyzaduje kruhove buffery UART s DMA (UART_DMA 1 v config.h, jen F4)."
+#endif
+
+#ifndef PKT_MAX
+# define PKT_MAX  256               // Nejvetsi delka dat jednoho paketu
+#endif
+
+#define PKT_CRC_LEN      4
+#define PKT_FRAME(len)   ((len) + PKT_CRC_LEN + ((len) + PKT_CRC_LEN) / 254 + 2) // Nejdelsi ramec vcetne oddelovace
+
+#if PKT_FRAME(PKT_MAX) >= UART_RX_RING || PKT_FRAME(PKT_MAX) >= UART_TX_RING
+# error "PKT_MAX je pro UART_RX_RING/UART_TX_RING prilis velke!"
+#endif
+
+/**
+ * @brief Statistika prijmu.
+ */
+typedef struct {
+  uint32_t frames;    // Platne pakety
+  uint32_t crc;       // Chybny CRC
+  uint32_t format;    // Chybne kodovani COBS, prilis kratky nebo dlouhy ramec
+  uint32_t overrun;   // Prijimaci buffer prepsan driv, nez se precetl
+} pkt_stats_t;
+
+static pkt_stats_t PKT_stats;
+static uint32_t    PKT_rx_read;                   // Zacatek dalsiho ramce (index do UART_rx_ring, volne bezici)
+static uint32_t    PKT_rx_scan;                   // Dosud prohledano (oddelovac nenalezen)
+static uint8_t     PKT_rx_skip;                   // Zahazovani do dalsiho oddelovace (prilis dlouhy ramec)
+static uint8_t     PKT_spill[PKT_FRAME(PKT_MAX)]; // Ramec pres konec prijimaciho bufferu
+
+/**
+ * @brief  Odeslani paketu - kodovani COBS a CRC primo do vysilaciho bufferu.
+ *         Ceka jen na misto v bufferu, vysila DMA na pozadi.
+ *
+ * @param  data Data paketu.
+ * @param  len  Delka (0 az PKT_MAX).
+ *
+ * @return 1 = zarazeno k odeslani, 0 = data jsou delsi nez PKT_MAX.
+ */
+int PKT_send(const void *data, uint16_t len) {
+  if (len > PKT_MAX) return 0;
+
+  const uint8_t *src = (const uint8_t *)data;
+  const uint32_t crc = crc32(0, data, len);
+  const uint16_t need = PKT_FRAME(len);
+
+  while (UART_tx_space() < need) {
+    CHRONO_IDLE();
+  }
+
+  uint16_t pos  = UART_tx_head;
+  uint16_t code_pos = pos++;                      // Misto pro kod bloku (doplni se na konci bloku)
+  uint8_t  code = 1;
+
+  for (uint16_t i = 0; i < len + PKT_CRC_LEN; i++) {
+    const uint8_t b = (i < len) ? src[i] : (uint8_t)(crc >> (8 * (i - len)));
+
+    if (b) {
+      UART_tx_ring[pos++ & UART_TX_MASK] = b;
+      if (++code < 0xFF) continue;
+    }
+    UART_tx_ring[code_pos & UART_TX_MASK] = code; // Nula nebo 254 bajtu bez nuly: konec bloku
+    code_pos = pos++;
+    code = 1;
+  }
+  UART_tx_ring[code_pos & UART_TX_MASK] = code;
+  UART_tx_ring[pos++ & UART_TX_MASK] = 0;         // Oddelovac
+
+  UART_tx_commit(pos);
+  return 1;
+}
+
+/**
+ * @brief  Dekodovani COBS ramce z prijimaciho bufferu.
+ *         Zapisuje se vzdy na pozici, ktera uz byla prectena, takze @p dst
+ *         muze byt i zacatek ramce (dekodovani na miste).
+ *
+ * @param  start Index prvniho bajtu ramce v UART_rx_ring (volne bezici).
+ * @param  len   Delka ramce bez oddelovace.
+ *
+ * @return Delka dekodovanych dat, -1 = chybne kodovani.
+ */
+INLINE_STM32 int PKT_decode(uint32_t start, uint16_t len, uint8_t *dst) {
+  uint16_t in = 0, out = 0;
+
+  while (in < len) {
+    const uint8_t code = UART_rx_ring[(start + in++) & UART_RX_MASK];
+    if (!code || in + code - 1 > len) return -1;
+
+    for (uint8_t k = 1; k < code; k++) {
+      dst[out++] = UART_rx_ring[(start + in++) & UART_RX_MASK];
+    }
+    if (code < 0xFF && in < len) dst[out++] = 0; // Nula zakodovana koncem bloku (ne za poslednim)
+  }
+  return out;
+}
+
+/**
+ * @brief  Dalsi platny paket z prijimaciho bufferu (neblokujici).
+ *         Ramce s chybnym CRC nebo kodovanim se preskoci (viz PKT_stats).
+ *
+ * @param  len Delka dat paketu.
+ *
+ * @return Ukazatel na data (platny do dalsiho volani), 0 = zadny cely paket.
+ */
+const uint8_t *PKT_receive(uint16_t *len) {
+  for (;;) {
+    const uint32_t count = UART_rx_count();
+
+    if (count - PKT_rx_read > UART_RX_RING) {     // DMA prepsal neprectena data
+      PKT_stats.overrun++;
+      PKT_rx_read = PKT_rx_scan = count;
+      PKT_rx_skip = 1;                            // Ramec se ztracenym zacatkem zahodit
+      continue;
+    }
+
+    while (PKT_rx_scan != count) {                // Hledani oddelovace po souvislych usecich
+      const uint32_t pos = PKT_rx_scan & UART_RX_MASK;
+      uint32_t n = count - PKT_rx_scan;
+      if (n > UART_RX_RING - pos) n = UART_RX_RING - pos;
+
+      const uint8_t *zero = (const uint8_t *)memchr(&UART_rx_ring[pos], 0, n);
+      PKT_rx_scan += zero ? (uint32_t)(zero - &UART_rx_ring[pos]) : n;
+      if (zero) break;
+    }
+
+    const uint32_t start = PKT_rx_read;
+    const uint32_t frame = PKT_rx_scan - start;
+    if (PKT_rx_scan == count) {                   // Oddelovac zatim neprisel
+      if (frame > PKT_FRAME(PKT_MAX)) {
+        if (!PKT_rx_skip) PKT_stats.format++;
+        PKT_rx_read = PKT_rx_scan;                // Prilis dlouhy ramec: zbytek zahodit az po oddelovac
+        PKT_rx_skip = 1;
+      }
+      return 0;
+    }
+
+    PKT_rx_read = ++PKT_rx_scan;                  // Za oddelovac
+    if (PKT_rx_skip) {
+      PKT_rx_skip = 0;
+      continue;
+    }
+    if (!frame) continue;                         // Prazdny ramec (opakovany oddelovac)
+    if (frame > PKT_FRAME(PKT_MAX) - 1) {
+      PKT_stats.format++;
+      continue;
+    }
+
+    const uint32_t offset = start & UART_RX_MASK;
+    uint8_t *dst = (offset + frame <= UART_RX_RING) ? &UART_rx_ring[offset] : PKT_spill;
+    const int n = PKT_decode(start, (uint16_t)frame, dst);
+
+    if (UART_rx_count() - start > UART_RX_RING) { // Ramec se behem dekodovani prepsal
+      PKT_stats.overrun++;
+      continue;
+    }
+    if (n < PKT_CRC_LEN || n > PKT_MAX + PKT_CRC_LEN) {
+      PKT_stats.format++;
+      continue;
+    }
+
+    const uint16_t data_len = (uint16_t)(n - PKT_CRC_LEN);
+    const uint32_t crc = dst[data_len] | ((uint32_t)dst[data_len + 1] << 8)
+                       | ((uint32_t)dst[data_len + 2] << 16) | ((uint32_t)dst[data_len + 3] << 24);
+    if (crc32(0, dst, data_len) != crc) {
+      PKT_stats.crc++;
+      continue;
+    }
+
+    PKT_stats.frames++;
+    *len = data_len;
+    return dst;
+  }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STM32_KIT_PACKET */
@@ -7,12 +7,22 @@
 #include "chrono.h"
 #include "gpio.h"
 
+// Zapisy do registru portu jsou atomicke (atomic.h), konfigurace pinu
+// tak nevyzaduje zakazani preruseni ani pri soubezne praci s jinymi piny portu.
+// Hodiny portu jsou pocitany po pinech (GPIO_clock_enable/disable, kratka
+// kriticka sekce), vypnou se az po uvolneni posledniho pinu portu.
+
 INLINE_STM32 void pin_enable(enum pin pin) {
-  SET_BIT(RCC->IO_ENABLE, (1UL << io_port_source(io_port(pin))));
+  GPIO_clock_enable(pin);
 }
 
+/**
+ * @brief  Uvolneni pinu: pin prejde do analogoveho rezimu (MODER = 11, vystup
+ *         a pull-up/down prestanou pusobit), hodiny portu se vypnou s poslednim pinem.
+ *
+ */
 INLINE_STM32 void pin_disable(enum pin pin) {
-  CLEAR_BIT(RCC->IO_ENABLE, (1UL << io_port_source(io_port(pin))));
+  GPIO_clock_disable(pin);
 }
 
 typedef enum  {
@@ -72,22 +82,22 @@ typedef enum {
 
 INLINE_STM32 void pin_mode(enum pin pin, pin_mode_t mode) {
   if (PIN_MODE_DEFAULT == mode) return;
-  MODIFY_REG(io_port(pin)->MODER, (PIN_MODE_MASK << (2 * io_pin(pin))), (mode << 2 * io_pin(pin)));
+  atomic_modify(&io_port(pin)->MODER, (PIN_MODE_MASK << (2 * io_pin(pin))), (mode << 2 * io_pin(pin)));
 }
 
 INLINE_STM32 void pin_pull(enum pin pin, pin_pull_t pull) {
   if (PIN_PULL_DEFAULT == pull) return;
-  MODIFY_REG(io_port(pin)->PUPDR, (PIN_PULL_MASK << (2 * io_pin(pin))), (pull << 2 * io_pin(pin)));
+  atomic_modify(&io_port(pin)->PUPDR, (PIN_PULL_MASK << (2 * io_pin(pin))), (pull << 2 * io_pin(pin)));
 }
 
 INLINE_STM32 void pin_output_speed(enum pin pin, pin_speed_t speed) {
   if (PIN_SPEED_DEFAULT == speed) return;
-  MODIFY_REG(io_port(pin)->OSPEEDR, (PIN_SPEED_MASK << (2 * io_pin(pin))), (speed << 2 * io_pin(pin)));
+  atomic_modify(&io_port(pin)->OSPEEDR, (PIN_SPEED_MASK << (2 * io_pin(pin))), (speed << 2 * io_pin(pin)));
 }
 
 INLINE_STM32 void pin_output_type(enum pin pin, pin_type_t type) {
   if (PIN_TYPE_DEFAULT == type) return;
-  MODIFY_REG(io_port(pin)->OTYPER, (PIN_TYPE_MASK << (io_pin(pin))), (type << io_pin(pin)));
+  atomic_bit_write(&io_port(pin)->OTYPER, io_pin(pin), type);
 }
 
 INLINE_STM32 void pin_af(enum pin pin, pin_af_t func) {
@@ -95,7 +105,7 @@ INLINE_STM32 void pin_af(enum pin pin, pin_af_t func) {
   
   const int bank = io_pin(pin) > 7;
   const int offset_pin =  io_pin(pin) & ~(1 << 3);
-  MODIFY_REG(io_port(pin)->AFR[bank],  (PIN_AF_MASK << (4 * offset_pin)),  (func << 4 * offset_pin));  // AF7 - UART
+  atomic_modify(&io_port(pin)->AFR[bank], (PIN_AF_MASK << (4 * offset_pin)), (func << 4 * offset_pin));
 }
 
 INLINE_STM32 void pin_setup(enum pin pin, pin_mode_t mode, pin_pull_t pull, pin_speed_t speed, pin_type_t type) {
@@ -110,5 +120,134 @@ INLINE_STM32 void pin_setup_af(enum pin pin, pin_mode_t mode, pin_pull_t pull, p
   pin_setup(pin, mode, pull, speed, type);
   pin_af(pin, func);
 }
+
+//#========================================================================
+//#=== Hromadna konfigurace pinu (tabulka) - ZACATEK
+
+typedef enum {
+  PIN_LEVEL_DEFAULT = -1,
+  PIN_LEVEL_LOW     = 0,
+  PIN_LEVEL_HIGH    = 1
+} pin_level_t;
+
+/**
+ * @brief Radek konfiguracni tabulky pro pin_setup_table().
+ *        Polozky s hodnotou *_DEFAULT (PIN_AF_NONE) se na pinu nemeni.
+ */
+typedef struct {
+  enum pin    pin;
+  pin_mode_t  mode;
+  pin_pull_t  pull;
+  pin_speed_t speed;
+  pin_type_t  type;
+  pin_af_t    af;
+  pin_level_t level; // Uroven vystupu nastavena jeste pred prepnutim pinu na vystup
+} pin_config_t;
+
+#define PIN_TABLE_SIZE(table) ((int)(sizeof(table) / sizeof((table)[0])))
+
+/**
+ * @brief Slouceni 2bitove polozky (MODER, PUPDR, OSPEEDR) do masky a hodnoty registru.
+ */
+INLINE_STM32 void pin_table_merge2(uint32_t *mask, uint32_t *value, int pin, int field) {
+  if (field < 0) return;
+  *mask |= 3UL << (2 * pin);
+  *value = (*value & ~(3UL << (2 * pin))) | ((uint32_t)field << (2 * pin));
+}
+
+/**
+ * @brief  Uvolneni vsech pinu tabulky (analogovy rezim, hodiny portu se vypnou
+ *         s poslednim pouzivanym pinem portu).
+ *
+ */
+INLINE_STM32 void pin_release_table(const pin_config_t *table, int count) {
+  for (int i = 0; i < count; i++) {
+    if (table[i].pin == P_INVALID || table[i].pin == NC) continue;
+    GPIO_clock_disable(table[i].pin);
+  }
+}
+
+/**
+ * @brief  Hromadna konfigurace pinu podle tabulky.
+ *
+ *         Nastaveni vsech pinu jednoho portu se slouci, takze se kazdy registr portu
+ *         (BSRR, OTYPER, OSPEEDR, PUPDR, AFR, MODER) zapise nejvyse jednou a hodiny
+ *         vsech pouzitych portu se zapnou jedinym zapisem do RCC.
+ *         MODER se zapisuje posledni, pin se tak prepne na vystup az s platnou
+ *         urovni a typem vystupu.
+ *
+ * @code
+ *     static const pin_config_t pins[] = {
+ *       { PD12, PIN_MODE_OUTPUT, PIN_PULL_DEFAULT, PIN_SPEED_HIGH, PIN_TYPE_PUSHPULL, PIN_AF_NONE, PIN_LEVEL_LOW },
+ *       { PA0,  PIN_MODE_INPUT,  PIN_PULL_UP,      PIN_SPEED_DEFAULT, PIN_TYPE_DEFAULT, PIN_AF_NONE, PIN_LEVEL_DEFAULT },
+ *     };
+ *     pin_setup_table(pins, PIN_TABLE_SIZE(pins));
+ * @endcode
+ *
+ * @param  table Tabulka konfigurace pinu (polozky s P_INVALID a NC se preskoci).
+ * @param  count Pocet polozek tabulky.
+ *
+ */
+void pin_setup_table(const pin_config_t *table, int count) {
+  uint32_t ports = 0;
+  uint32_t enable = 0;
+
+  const uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  for (int i = 0; i < count; i++) {
+    if (table[i].pin == P_INVALID || table[i].pin == NC) continue;
+    ports |= 1UL << io_port_source(io_port(table[i].pin));
+    enable |= GPIO_pin_claim(table[i].pin); // Zapocitani pinu (hodiny portu)
+  }
+  if (enable) RCC->IO_ENABLE |= enable;       // V kriticke sekci spolu se zapocitanim (viz gpio.h)
+  __set_PRIMASK(primask);
+
+  for (uint32_t index = 0; (ports >> index) != 0; index++) {
+    if (!(ports & (1UL << index))) continue;
+
+    GPIO_TypeDef *port = (GPIO_TypeDef *)(GPIOA_BASE + index * ((GPIOB_BASE) - (GPIOA_BASE)));
+    uint32_t bsrr = 0;
+    uint32_t otype_mask = 0, otype = 0;
+    uint32_t speed_mask = 0, speed = 0;
+    uint32_t pull_mask = 0, pull = 0;
+    uint32_t mode_mask = 0, mode = 0;
+    uint32_t af_mask[2] = { 0, 0 }, af[2] = { 0, 0 };
+
+    for (int i = 0; i < count; i++) {
+      const pin_config_t *cfg = &table[i];
+      if (cfg->pin == P_INVALID || cfg->pin == NC || io_port(cfg->pin) != port) continue;
+
+      const int pin = io_pin(cfg->pin);
+
+      if (cfg->level != PIN_LEVEL_DEFAULT) {
+        bsrr = (bsrr & ~(IO_PIN_SET(pin) | IO_PIN_RESET(pin))) | IO_PIN_BSRR(pin, cfg->level);
+      }
+      if (cfg->type != PIN_TYPE_DEFAULT) {
+        otype_mask |= 1UL << pin;
+        otype = (otype & ~(1UL << pin)) | ((uint32_t)cfg->type << pin);
+      }
+      if (cfg->af != PIN_AF_NONE) {
+        const int bank = pin > 7;
+        const int shift = 4 * (pin & 0x7);
+        af_mask[bank] |= PIN_AF_MASK << shift;
+        af[bank] = (af[bank] & ~(PIN_AF_MASK << shift)) | ((uint32_t)cfg->af << shift);
+      }
+      pin_table_merge2(&speed_mask, &speed, pin, cfg->speed);
+      pin_table_merge2(&pull_mask, &pull, pin, cfg->pull);
+      pin_table_merge2(&mode_mask, &mode, pin, cfg->mode);
+    }
+
+    if (bsrr) WRITE_REG(port->BSRR, bsrr);
+    if (otype_mask) atomic_modify(&port->OTYPER, otype_mask, otype);
+    if (speed_mask) atomic_modify(&port->OSPEEDR, speed_mask, speed);
+    if (pull_mask) atomic_modify(&port->PUPDR, pull_mask, pull);
+    if (af_mask[0]) atomic_modify(&port->AFR[0], af_mask[0], af[0]);
+    if (af_mask[1]) atomic_modify(&port->AFR[1], af_mask[1], af[1]);
+    if (mode_mask) atomic_modify(&port->MODER, mode_mask, mode);
+  }
+}
+
+//#=== Hromadna konfigurace pinu (tabulka) - KONEC
+//#========================================================================
   
 #endif /* STM32_KIT_GPIO_SETUP */
@@ -0,0 +1,191 @@
+/**
+ * @file       pulse.h
+ * @brief      Presny jednorazovy pulz se zpozdenim (one-pulse mode casovace).
+ *
+ *             Po spousteci (softwarove PULSE_fire() nebo hrana na vstupu casovace)
+ *             ceka casovac @p delay a pak nastavi vystup na dobu @p width, vse bez
+ *             ucasti CPU. Rozliseni je takt hodin casovace (F4 TIM9 168 MHz = 6 ns,
+ *             G0 TIM15 64 MHz = 16 ns), delka celeho pulzu az 65536 taktu delicky.
+ *
+ *             Kanal 1 je vystup v rezimu PWM 2 (aktivni pri CNT >= CCR1 = delay,
+ *             ARR = delay + width - 1), citac se po preteceni sam zastavi (OPM).
+ *             Kanal 2 je vstup spoustece (TI2FP2, slave mode trigger).
+ *
+ *             Opakovane spusteni behem pulzu:
+ *               - PULSE_fire() zacne znovu od zacatku zpozdeni,
+ *               - hrana na vstupu na F4 se ignoruje (citac uz bezi), na G0 s
+ *                 PULSE_RETRIGGER = 1 restartuje citac stejne jako PULSE_fire().
+ *
+ *             Smerovani: F407 - TIM9: vystup PE5 (LCD_EN), spoustec PE6 (AF3),
+ *                        F401/F411 (Nucleo 64 pinu nema PE5/PE6) - TIM9: vystup PA2, spoustec PA3
+ *                        (AF3, na Nucleo spojene s virtualnim COM portem ST-LINK),
+ *                        G0 - TIM15: vystup PB14, spoustec PB15 (AF5, na Nucleo sloupec klavesnice).
+ *
+ * @code
+ *     PULSE_setup();
+ *     PULSE_set(1000, 250);                 // 250 ns pulz se zpozdenim 1 us
+ *     PULSE_trigger(PULSE_RISING);          // ... po kazde nabezne hrane na vstupu
+ *     PULSE_fire();                         // ... nebo hned ze software
+ * @endcode
+ *
+ * @author     Petr Madecki (petr.madecki@spsehavirov.cz)
+ * @author     Tomas Michalek (tomas.michalek@spsehavirov.cz)
+ *
+ * @date       2026-10-19
+ * @copyright  Copyright SPSE Havirov (c) 2026
+ */
+#ifndef STM32_KIT_PULSE
+#define STM32_KIT_PULSE
+
+#include "platform.h"
+#include "gpio.h"
+#include "pin.h"
+#include "timers.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef PULSE_INVERT
+# define PULSE_INVERT     0   // 1 = pulz v log. 0 (klidova uroven log. 1)
+#endif
+#ifndef PULSE_RETRIGGER
+# define PULSE_RETRIGGER  0   // 1 = hrana behem pulzu restartuje citac (pouze G0)
+#endif
+
+//#========================================================================
+//#=== Smerovani casovac -> piny - ZACATEK
+#ifndef PULSE_TIM
+# if (STM32_TYPE == 401) || (STM32_TYPE == 411)
+#  define PULSE_TIM        9   // TIM9 (APB2, plne hodiny jadra)
+#  define PULSE_PIN_OUT    PA2 // TIM9_CH1 (pouzdro LQFP64 nema port E)
+#  define PULSE_PIN_TRIG   PA3 // TIM9_CH2
+#  define PULSE_AF         PIN_AF3
+# elif defined(STM32F4)
+#  define PULSE_TIM        9   // TIM9 (APB2, plne hodiny jadra)
+#  define PULSE_PIN_OUT    PE5
+#  define PULSE_PIN_TRIG   PE6
+#  define PULSE_AF         PIN_AF3
+# elif defined(STM32G0)
+#  define PULSE_TIM        15  // TIM15
+#  define PULSE_PIN_OUT    PB14
+#  define PULSE_PIN_TRIG   PB15
+#  define PULSE_AF         PIN_AF5
+# endif
+#endif
+//#=== Smerovani casovac -> piny - KONEC
+//#========================================================================
+
+typedef enum {
+  PULSE_OFF = 0,      // Pouze PULSE_fire()
+  PULSE_RISING,       // Nabezna hrana na PULSE_PIN_TRIG
+  PULSE_FALLING,      // Sestupna hrana na PULSE_PIN_TRIG
+} pulse_edge_t;
+
+static const tim_t *PULSE_tim;
+
+/**
+ * @brief  Pocatecni inicializace pinu a casovace (OPM, kanal 1 vystup, kanal 2 vstup).
+ *
+ */
+void PULSE_setup(void) {
+  PULSE_tim = TIM_get(PULSE_TIM);
+  TIM_enable(PULSE_tim);
+
+  TIM_TypeDef *tim = PULSE_tim->tim;
+  tim->CR1   = TIM_CR1_OPM | TIM_CR1_ARPE;
+  tim->CCMR1 = (7UL << 4) | (1UL << 3)        // OC1M = 111: PWM 2, OC1PE: preload CCR1
+             | (1UL << 8);                    // CC2S = 01: IC2 <- TI2 (spoustec)
+  tim->CCER  = (1UL << 0) | (PULSE_INVERT ? (1UL << 1) : 0); // CC1E, CC1P
+  if (PULSE_tim->advanced) tim->BDTR |= TIM_BDTR_MOE;
+
+  pin_setup_af(PULSE_PIN_OUT, PIN_MODE_AF, PIN_PULL_DEFAULT, PIN_SPEED_VERYHIGH, PIN_TYPE_PUSHPULL, PULSE_AF);
+  pin_setup_af(PULSE_PIN_TRIG, PIN_MODE_AF, PIN_PULL_DEFAULT, PIN_SPEED_DEFAULT, PIN_TYPE_DEFAULT, PULSE_AF);
+}
+
+/**
+ * @brief  Nastaveni zpozdeni a delky pulzu (plati od pristiho spusteni).
+ *         Delicka je nejmensi mozna, aby se zpozdeni i pulz vesly do 16 bitu.
+ *
+ * @param  delay_ns Zpozdeni od spousteni (nejmene 1 takt - pri 0 by vystup byl aktivni i v klidu).
+ * @param  width_ns Delka pulzu (nejmene 1 takt).
+ *
+ * @return Skutecna delka pulzu v ns.
+ */
+uint32_t PULSE_set(uint32_t delay_ns, uint32_t width_ns) {
+  const uint64_t clock = TIM_clock(PULSE_tim);
+  const uint64_t delay = (clock * delay_ns + 500000000ULL) / 1000000000ULL;
+  const uint64_t width = (clock * width_ns + 500000000ULL) / 1000000000ULL;
+
+  uint64_t psc = (delay + width + 0xFFFF) / 0x10000;
+  if (psc < 1) psc = 1;
+  if (psc > 0x10000) psc = 0x10000;
+
+  uint64_t d = (delay + psc / 2) / psc;
+  uint64_t w = (width + psc / 2) / psc;
+  if (d < 1) d = 1;
+  if (w < 1) w = 1;
+  if (d > 0xFFFF) d = 0xFFFF;
+  if (d + w > 0x10000) w = 0x10000 - d;
+
+  TIM_TypeDef *tim = PULSE_tim->tim;
+  tim->PSC  = (uint32_t)(psc - 1);
+  tim->ARR  = (uint32_t)(d + w - 1);
+  tim->CCR1 = (uint32_t)d;
+  if (!(tim->CR1 & TIM_CR1_CEN)) {            // Nahrani stinovych registru (UG) jen v klidu
+    tim->EGR = TIM_EGR_UG;
+    tim->SR &= ~(TIM_SR_UIF);
+  }
+
+  return (uint32_t)((w * psc * 1000000000ULL + clock / 2) / clock);
+}
+
+/**
+ * @brief  Spousteni pulzu hranou na vstupu PULSE_PIN_TRIG.
+ *
+ */
+void PULSE_trigger(pulse_edge_t edge) {
+  TIM_TypeDef *tim = PULSE_tim->tim;
+
+  tim->SMCR = 0;
+  tim->CCER = (tim->CCER & ~((1UL << 4) | (1UL << 5))) | (edge == PULSE_FALLING ? (1UL << 5) : 0); // CC2P
+  if (edge == PULSE_OFF) return;
+
+#if defined(STM32G0) && PULSE_RETRIGGER
+  tim->SMCR = (6UL << 4) | (1UL << 16);       // TS = TI2FP2, SMS = 1000: reset + trigger
+#else
+  tim->SMCR = (6UL << 4) | 6UL;               // TS = TI2FP2, SMS = 110: trigger (spusti citac)
+#endif
+}
+
+/**
+ * @brief  Softwarove spusteni pulzu (behem pulzu zacne znovu od zacatku zpozdeni).
+ *
+ */
+INLINE_STM32 void PULSE_fire(void) {
+  PULSE_tim->tim->CNT  = 0;
+  PULSE_tim->tim->CR1 |= TIM_CR1_CEN;
+}
+
+/**
+ * @brief  Probiha zpozdeni nebo pulz.
+ *
+ */
+INLINE_STM32 int PULSE_busy(void) {
+  return (PULSE_tim->tim->CR1 & TIM_CR1_CEN) != 0;
+}
+
+/**
+ * @brief  Preruseni probihajiciho pulzu (vystup do klidove urovne).
+ *
+ */
+INLINE_STM32 void PULSE_abort(void) {
+  PULSE_tim->tim->CR1 &= ~TIM_CR1_CEN;
+  PULSE_tim->tim->CNT  = 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STM32_KIT_PULSE */
@@ -0,0 +1,390 @@
+/**
+ * @file       spi.h
+ * @brief      SPI master s prenosy pres DMA (plny duplex i jen vysilani) a frontou transakci.
+ *
+ *             Transakce (spi_xfer_t) popisuje jeden prenos: pin CS (aktivni v log. 0),
+ *             data k odeslani a buffer pro prijem. SPI_submit() ji zaradi do fronty
+ *             a hned se vrati, prenos bezi na pozadi a dalsi transakci ve fronte
+ *             spusti preruseni DMA po dokonceni predchozi.
+ *               - bez bufferu pro prijem (rx = 0) se prijata data zahazuji (jen vysilani),
+ *               - bez dat k odeslani (tx = 0) se vysila SPI_FILL (jen prijem),
+ *               - SPI_KEEP_CS ponecha CS aktivni i pro dalsi transakci (prikaz + data).
+ *
+ *             Konec prenosu hlasi vzdy DMA prijmu: posledni bajt je prijaty az po
+ *             jeho odvysilani, CS lze tedy uvolnit hned (DMA vysilani konci drive,
+ *             kdy je v posuvnem registru jeste posledni bajt).
+ *
+ *             Rychlost: SCK = PCLK / 2 az PCLK / 256 (F407 SPI1 na APB2 84 MHz -> 42 MHz).
+ *             Mezi transakcemi je prodleva obsluhy preruseni (jednotky us), dlouhe
+ *             bloky tak dosahuji temer SCK / 8 bajtu za sekundu, viz SPI_bytes().
+ *
+ *             Smerovani: SPI_BUS 1 - SPI1: SCK PB3, MISO PB4, MOSI PB5 (F4 AF5, G0 AF0),
+ *                        SPI_BUS 2 - SPI2: SCK PB13, MISO PB14, MOSI PB15 (F4 AF5, G0 AF0),
+ *                        pozadavky DMA SPIx_RX/TX, streamy/kanaly prideli dma_alloc().
+ *
+ * @code
+ *     SPI_setup(10000000, SPI_MODE0);                // Nejvyse 10 MHz
+ *     SPI_device(PE3);                               // CS v log. 1
+ *
+ *     static const uint8_t cmd[4] = { 0x9F };        // JEDEC ID
+ *     static uint8_t id[4];
+ *     SPI_transfer(PE3, cmd, id, sizeof(cmd));       // Blokujici prenos
+ *
+ *     static spi_xfer_t x = { .cs = PE3, .tx = data, .len = 256 };
+ *     SPI_submit(&x);                                // Na pozadi (SPI_wait(&x) nebo x.done)
+ * @endcode
+ *
+ * @author     Petr Madecki (petr.madecki@spsehavirov.cz)
+ * @author     Tomas Michalek (tomas.michalek@spsehavirov.cz)
+ *
+ * @date       2026-10-19
+ * @copyright  Copyright SPSE Havirov (c) 2026
+ */
+#ifndef STM32_KIT_SPI
+#define STM32_KIT_SPI
+
+#include "platform.h"
+#include "chrono.h"
+#include "gpio.h"
+#include "pin.h"
+#include "atomic.h"
+#include "dma.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef SPI_QUEUE
+# define SPI_QUEUE  8       // Delka fronty transakci (mocnina 2)
+#endif
+#ifndef SPI_FILL
+# define SPI_FILL   0xFF    // Vysilany bajt pri prenosu bez dat (tx = 0)
+#endif
+#define SPI_QUEUE_MASK  (SPI_QUEUE - 1)
+
+//#========================================================================
+//#=== Smerovani SPI -> piny, DMA - ZACATEK
+#ifndef SPI_BUS
+# define SPI_BUS  1
+#endif
+
+#if SPI_BUS == 1
+# define SPI_DEV          SPI1
+# define SPI_PIN_SCK      PB3
+# define SPI_PIN_MISO     PB4
+# define SPI_PIN_MOSI     PB5
+# define SPI_REQ_RX       DMA_REQ_SPI1_RX
+# define SPI_REQ_TX       DMA_REQ_SPI1_TX
+# if defined(STM32F4)
+#  define SPI_AF          PIN_AF5
+#  define SPI_APB         2
+#  define SPI_ENR         RCC->APB2ENR
+#  define SPI_EN_Pos      RCC_APB2ENR_SPI1EN_Pos
+# elif defined(STM32G0)
+#  define SPI_AF          PIN_AF0
+#  define SPI_ENR         RCC->APBENR2
+#  define SPI_EN_Pos      RCC_APBENR2_SPI1EN_Pos
+# endif
+#elif SPI_BUS == 2
+# define SPI_DEV          SPI2
+# define SPI_PIN_SCK      PB13
+# define SPI_PIN_MISO     PB14
+# define SPI_PIN_MOSI     PB15
+# define SPI_REQ_RX       DMA_REQ_SPI2_RX
+# define SPI_REQ_TX       DMA_REQ_SPI2_TX
+# if defined(STM32F4)
+#  define SPI_AF          PIN_AF5
+#  define SPI_APB         1
+#  define SPI_ENR         RCC->APB1ENR
+#  define SPI_EN_Pos      RCC_APB1ENR_SPI2EN_Pos
+# elif defined(STM32G0)
+#  define SPI_AF          PIN_AF0
+#  define SPI_ENR         RCC->APBENR1
+#  define SPI_EN_Pos      RCC_APBENR1_SPI2EN_Pos
+# endif
+#else
+# error "SPI_BUS musi byt 1 nebo 2."
+#endif
+#define SPI_DR8  (*(volatile uint8_t *)&SPI_DEV->DR) // 8bit pristup (G0: jinak dva bajty v FIFO)
+//#=== Smerovani SPI -> piny, DMA - KONEC
+//#========================================================================
+
+typedef enum {
+  SPI_MODE0 = 0,      // CPOL = 0, CPHA = 0
+  SPI_MODE1 = 1,      // CPOL = 0, CPHA = 1
+  SPI_MODE2 = 2,      // CPOL = 1, CPHA = 0
+  SPI_MODE3 = 3,      // CPOL = 1, CPHA = 1
+} spi_mode_t;
+
+// Stav transakce (spi_xfer_t.status)
+#define SPI_DONE     0
+#define SPI_QUEUED   1
+#define SPI_ACTIVE   2
+#define SPI_ERROR   -1
+
+// Priznaky transakce (spi_xfer_t.flags)
+#define SPI_KEEP_CS  0x01   // CS zustane po prenosu aktivni (dalsi transakce na stejne zarizeni)
+
+typedef struct spi_xfer spi_xfer_t;
+
+/**
+ * @brief Dokonceni transakce (volano z preruseni DMA, muze zaradit dalsi transakci).
+ */
+typedef void (*spi_done_t)(spi_xfer_t *x);
+
+struct spi_xfer {
+  enum pin         cs;      // Chip select (aktivni v log. 0), NC = bez CS
+  const uint8_t   *tx;      // Data k odeslani, 0 = vysila se SPI_FILL
+  uint8_t         *rx;      // Buffer pro prijem, 0 = prijata data se zahodi
+  uint16_t         len;     // Pocet bajtu
+  uint8_t          flags;   // SPI_KEEP_CS
+  volatile int8_t  status;  // SPI_QUEUED, SPI_ACTIVE, SPI_DONE, SPI_ERROR
+  spi_done_t       done;    // 0 = bez oznameni
+  void            *ctx;     // Libovolna data pro @p done
+};
+
+static const dma_t       *SPI_rx_dma, *SPI_tx_dma;
+static spi_xfer_t *volatile SPI_queue[SPI_QUEUE];
+static volatile uint16_t  SPI_head;     // Zapis (SPI_submit), index bezi volne a maskuje se
+static volatile uint16_t  SPI_tail;     // Probihajici transakce
+static volatile uint8_t   SPI_running;
+static enum pin           SPI_held = NC; // CS ponechany aktivni (SPI_KEEP_CS)
+static volatile uint32_t  SPI_total;    // Pocet prenesenych bajtu
+static uint8_t            SPI_sink;     // Cil prijmu bez bufferu
+static const uint8_t      SPI_fill = SPI_FILL;
+
+void SPI_dma_event(void *ctx, uint32_t flags);
+
+/**
+ * @brief  Frekvence hodin periferie SPI (PCLK).
+ *
+ */
+INLINE_STM32 uint32_t SPI_pclk(void) {
+#if defined(STM32F4)
+  const uint32_t ppre = (SPI_APB == 2) ? (RCC->CFGR & RCC_CFGR_PPRE2) >> RCC_CFGR_PPRE2_Pos
+                                       : (RCC->CFGR & RCC_CFGR_PPRE1) >> RCC_CFGR_PPRE1_Pos;
+#else
+  const uint32_t ppre = (RCC->CFGR & RCC_CFGR_PPRE) >> RCC_CFGR_PPRE_Pos;
+#endif
+  return (ppre & 4) ? (SystemCoreClock >> ((ppre & 3) + 1)) : SystemCoreClock; // 1xx = deleni 2^(xx + 1)
+}
+
+/**
+ * @brief  Nastaveni rychlosti a rezimu (jen pokud neprobiha prenos).
+ *         Vybere nejvyssi SCK = PCLK / 2^(BR + 1), ktera neprekroci @p hz.
+ *
+ * @return Skutecna frekvence SCK.
+ */
+uint32_t SPI_set_clock(uint32_t hz, spi_mode_t mode) {
+  const uint32_t pclk = SPI_pclk();
+  uint32_t br = 0;
+  while (br < 7 && (pclk >> (br + 1)) > hz) br++;
+
+  SPI_DEV->CR1 = 0;
+#if defined(STM32G0)
+  SPI_DEV->CR2 = (7UL << SPI_CR2_DS_Pos) | SPI_CR2_FRXTH;  // 8 bitu, RXNE po kazdem bajtu
+#else
+  SPI_DEV->CR2 = 0;
+#endif
+  SPI_DEV->CR1 = (br << SPI_CR1_BR_Pos) | (uint32_t)mode
+               | SPI_CR1_MSTR | SPI_CR1_SSM | SPI_CR1_SSI; // Master, NSS ovlada software
+  SPI_DEV->CR1 |= SPI_CR1_SPE;
+  return pclk >> (br + 1);
+}
+
+/**
+ * @brief  Pocatecni inicializace pinu, SPI a kanalu DMA.
+ *
+ * @param  hz   Nejvyssi frekvence SCK.
+ * @param  mode Polarita a faze hodin (SPI_MODE0 - SPI_MODE3).
+ *
+ * @return Skutecna frekvence SCK, 0 = neni volny kanal DMA.
+ */
+uint32_t SPI_setup(uint32_t hz, spi_mode_t mode) {
+  if (!SPI_rx_dma) SPI_rx_dma = dma_alloc(SPI_REQ_RX);
+  if (!SPI_tx_dma) SPI_tx_dma = dma_alloc(SPI_REQ_TX);
+  if (!SPI_rx_dma || !SPI_tx_dma) {          // Stream/kanal DMA obsazen jinym ovladacem
+    dma_free(SPI_rx_dma);                     //  - uvolnit i ten prideleny
+    dma_free(SPI_tx_dma);
+    SPI_rx_dma = SPI_tx_dma = 0;
+    return 0;
+  }
+  dma_callback(SPI_rx_dma, SPI_dma_event, 0);
+
+  pin_setup_af(SPI_PIN_SCK,  PIN_MODE_AF, PIN_PULL_NONE, PIN_SPEED_VERYHIGH, PIN_TYPE_PUSHPULL, SPI_AF);
+  pin_setup_af(SPI_PIN_MOSI, PIN_MODE_AF, PIN_PULL_NONE, PIN_SPEED_VERYHIGH, PIN_TYPE_PUSHPULL, SPI_AF);
+  pin_setup_af(SPI_PIN_MISO, PIN_MODE_AF, PIN_PULL_UP,   PIN_SPEED_VERYHIGH, PIN_TYPE_DEFAULT,  SPI_AF);
+
+  atomic_bit_set(&SPI_ENR, SPI_EN_Pos);
+  return SPI_set_clock(hz, mode);
+}
+
+/**
+ * @brief  Nastaveni pinu CS zarizeni (vystup, neaktivni v log. 1).
+ *
+ */
+INLINE_STM32 void SPI_device(enum pin cs) {
+  io_set(cs, 1);
+  pin_setup(cs, PIN_MODE_OUTPUT, PIN_PULL_NONE, PIN_SPEED_HIGH, PIN_TYPE_PUSHPULL);
+}
+
+/**
+ * @brief  Aktivace CS dalsi transakce (uvolni CS ponechany pro jine zarizeni).
+ *
+ */
+INLINE_STM32 void SPI_select(enum pin cs) {
+  if (SPI_held == cs) return;
+  if (SPI_held != NC) io_set(SPI_held, 1);
+  if (cs != NC) io_set(cs, 0);
+  SPI_held = cs;
+}
+
+/**
+ * @brief  Spusteni DMA prijmu i vysilani jedne transakce.
+ *
+ */
+INLINE_STM32 void SPI_start(spi_xfer_t *x) {
+  while (SPI_DEV->SR & SPI_SR_RXNE) (void)SPI_DR8; // Zbytky v prijimaci, nulovani OVR (DR a pak SR)
+  (void)SPI_DEV->SR;
+
+  x->status = SPI_ACTIVE;
+  dma_start(SPI_rx_dma, &SPI_DR8, x->rx ? x->rx : &SPI_sink, x->len,
+            DMA_PERIPH_TO_MEM | DMA_SIZE_8 | DMA_IRQ | (x->rx ? 0 : DMA_FIXED));
+  dma_start(SPI_tx_dma, &SPI_DR8, x->tx ? x->tx : &SPI_fill, x->len,
+            DMA_MEM_TO_PERIPH | DMA_SIZE_8 | (x->tx ? 0 : DMA_FIXED));
+  SPI_DEV->CR2 |= SPI_CR2_RXDMAEN;            // Poradi dle RM: RXDMAEN, streamy, TXDMAEN
+  SPI_DEV->CR2 |= SPI_CR2_TXDMAEN;
+}
+
+/**
+ * @brief  Dokonceni transakce na konci fronty: CS, stav, oznameni.
+ *
+ */
+INLINE_STM32 void SPI_finish(spi_xfer_t *x, int8_t status) {
+  if (status != SPI_DONE || !(x->flags & SPI_KEEP_CS)) SPI_select(NC);
+  SPI_tail++;
+  if (status == SPI_DONE) SPI_total += x->len;
+  x->status = status;
+  if (x->done) x->done(x);
+}
+
+/**
+ * @brief  Spusteni dalsi transakce z fronty (prazdne transakce se dokonci hned).
+ *
+ */
+void SPI_next(void) {
+  while (SPI_tail != SPI_head) {
+    spi_xfer_t *x = SPI_queue[SPI_tail & SPI_QUEUE_MASK];
+    SPI_select(x->cs);
+    if (x->len) {
+      SPI_start(x);
+      return;
+    }
+    SPI_finish(x, SPI_DONE);
+  }
+  SPI_running = 0;
+}
+
+/**
+ * @brief  Udalost DMA prijmu (z preruseni DMA) - konec transakce.
+ *
+ */
+void SPI_dma_event(void *ctx, uint32_t flags) {
+  (void)ctx;
+  if (!(flags & (DMA_FLAG_COMPLETE | DMA_FLAG_ERROR))) return;   // Polovina prenosu
+
+  SPI_DEV->CR2 &= ~(SPI_CR2_RXDMAEN | SPI_CR2_TXDMAEN);
+  dma_stop(SPI_tx_dma);                       // Po chybe prijmu muze vysilani jeste bezet
+  SPI_finish(SPI_queue[SPI_tail & SPI_QUEUE_MASK], (flags & DMA_FLAG_ERROR) ? SPI_ERROR : SPI_DONE);
+  SPI_next();
+}
+
+/**
+ * @brief  Zarazeni transakce do fronty (lze volat i z @p done jine transakce).
+ *         Transakce musi existovat az do dokonceni (status SPI_DONE / SPI_ERROR).
+ *
+ * @return 1 = zarazeno, 0 = fronta je plna.
+ */
+int SPI_submit(spi_xfer_t *x) {
+  const uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+
+  if ((uint16_t)(SPI_head - SPI_tail) >= SPI_QUEUE) {
+    __set_PRIMASK(primask);
+    return 0;
+  }
+  x->status = SPI_QUEUED;
+  SPI_queue[SPI_head & SPI_QUEUE_MASK] = x;
+  SPI_head++;
+  if (!SPI_running) {
+    SPI_running = 1;
+    SPI_next();
+  }
+
+  __set_PRIMASK(primask);
+  return 1;
+}
+
+/**
+ * @brief  Cekani na dokonceni transakce.
+ *
+ * @return SPI_DONE nebo SPI_ERROR.
+ */
+INLINE_STM32 int SPI_wait(const spi_xfer_t *x) {
+  while (x->status > 0) {
+    CHRONO_IDLE();
+  }
+  return x->status;
+}
+
+/**
+ * @brief  Blokujici prenos (ve fronte za ostatnimi transakcemi, nevolat z preruseni).
+ *
+ * @param  cs  Chip select, nebo NC.
+ * @param  tx  Data k odeslani, nebo 0.
+ * @param  rx  Buffer pro prijem, nebo 0.
+ * @param  len Pocet bajtu.
+ *
+ * @return SPI_DONE nebo SPI_ERROR.
+ */
+int SPI_transfer(enum pin cs, const void *tx, void *rx, uint16_t len) {
+  spi_xfer_t x = { cs, (const uint8_t *)tx, (uint8_t *)rx, len, 0, SPI_DONE, 0, 0 };
+
+  while (!SPI_submit(&x)) {
+    CHRONO_IDLE();
+  }
+  return SPI_wait(&x);
+}
+
+/**
+ * @brief  Prenos jednoho bajtu bez DMA (jen pokud je fronta prazdna, CS ridi aplikace).
+ *
+ */
+INLINE_STM32 uint8_t SPI_byte(uint8_t value) {
+  while (!(SPI_DEV->SR & SPI_SR_TXE)) {}
+  SPI_DR8 = value;
+  while (!(SPI_DEV->SR & SPI_SR_RXNE)) {}
+  return SPI_DR8;
+}
+
+/**
+ * @brief  Probiha prenos (fronta neni prazdna)?
+ *
+ */
+INLINE_STM32 int SPI_busy(void) {
+  return SPI_running;
+}
+
+/**
+ * @brief  Pocet bajtu prenesenych od spusteni (pro mereni propustnosti).
+ *
+ */
+INLINE_STM32 uint32_t SPI_bytes(void) {
+  return SPI_total;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STM32_KIT_SPI */
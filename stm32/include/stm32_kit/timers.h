@@ -6,6 +6,14 @@
   * @date     13-June-2022 [v1.0]
   * @brief    Driver pro ovladani internich casovacu.
   *
+  *           Vsechny casovace (F4: TIM1 - TIM14, G0: TIM1 - TIM17) popisuje tim_t
+  *           (hodiny, sirka, kanaly, preruseni), nezavisle casove zakladny:
+  *             const tim_t *t = TIM_get(3);
+  *             TIM_enable(t);
+  *             TIM_set_period_ns(t, 20000000);   // 20 ms, PSC/ARR s nejmensi chybou
+  *             TIM_irq_enable(t);                // Obsluha TIM3_IRQHandler()
+  *             TIM_start(t);
+  *
   *           Podporovane desky:
   *             STM32F4-DISCOVERY (STM32F407VGTx)   -   skolni pripravek
   *               Kod pro makro STM32_TYPE:
@@ -14,6 +22,7 @@
   *                                               16MHz   HSI
   *               Casovace zakladni (16bit):
   *                                               TIM6, TIM7
+  *               (F401, F411 nemaji TIM6/TIM7, TIM7_setup() pouziva TIM5)
   *
   *             STM32NUCLEO-G071RB (STM32G071RBTx)
   *               Kod pro STM32_TYPE:
@@ -41,6 +50,7 @@
 #include "chrono.h"   /* Podpora pro casovani a delay smycky */
 #include "gpio.h"     /* Podpora pro zjednodusene pinovani */
 #include "pin.h"
+#include "atomic.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -72,6 +82,300 @@ extern "C" {
 # define TIM6_EN  RCC_APB1ENR_TIM6EN
 #endif
 
+#if (STM32_TYPE == 71)
+# define TIM7_NUMBER      7
+# define TIM7_TIM         TIM7
+# define TIM7_IRQ_HANDLER TIM7_LPTIM2_IRQHandler
+#elif defined(TIM7)
+# define TIM7_NUMBER      7
+# define TIM7_TIM         TIM7
+# define TIM7_IRQ_HANDLER TIM7_IRQHandler
+#else                                         // F401, F411 nemaji TIM6/TIM7 - periodicke preruseni z TIM5
+# define TIM7_NUMBER      5
+# define TIM7_TIM         TIM5
+# define TIM7_IRQ_HANDLER TIM5_IRQHandler
+#endif
+
+//#=========================================================================
+//#=== Popis casovacu (instance TIMx) - ZACATEK
+#if defined(STM32F4) || defined(STM32G0)
+/**
+ * @brief Popis casovace: hodiny, sirka citace, pocet kanalu a preruseni.
+ *        Bity resetu (RCC_xRSTR) lezi na stejnych pozicich jako bity povoleni (RCC_xENR).
+ */
+typedef struct {
+  TIM_TypeDef       *tim;
+  volatile uint32_t *enr;       // Registr RCC s povolenim hodin
+  volatile uint32_t *rstr;      // Registr RCC s resetem
+  uint32_t           en;        // Bit povoleni (a resetu) casovace
+  uint8_t            number;    // Cislo casovace (TIMx)
+  uint8_t            apb;       // Sbernice (1 = APB1, 2 = APB2), urcuje hodiny casovace
+  uint8_t            width;     // Sirka citace (16 nebo 32 bitu)
+  uint8_t            channels;  // Pocet kanalu capture/compare (0 = zakladni casovac)
+  uint8_t            advanced;  // Registr BDTR (vystupy povoluje MOE)
+  IRQn_Type          irq;       // Preruseni pri preteceni
+} tim_t;
+
+#if defined(STM32F4)
+# define TIM_APB1(n, w, ch, irq)      { TIM##n, &RCC->APB1ENR, &RCC->APB1RSTR, RCC_APB1ENR_TIM##n##EN, n, 1, w, ch, 0, irq }
+# define TIM_APB2(n, w, ch, adv, irq) { TIM##n, &RCC->APB2ENR, &RCC->APB2RSTR, RCC_APB2ENR_TIM##n##EN, n, 2, w, ch, adv, irq }
+
+static const tim_t TIM_table[] = {
+  TIM_APB2( 1, 16, 4, 1, TIM1_UP_TIM10_IRQn),
+  TIM_APB1( 2, 32, 4,    TIM2_IRQn),
+  TIM_APB1( 3, 16, 4,    TIM3_IRQn),
+  TIM_APB1( 4, 16, 4,    TIM4_IRQn),
+  TIM_APB1( 5, 32, 4,    TIM5_IRQn),
+# ifdef TIM6
+  TIM_APB1( 6, 16, 0,    TIM6_DAC_IRQn),
+  TIM_APB1( 7, 16, 0,    TIM7_IRQn),
+# endif
+# ifdef TIM8
+  TIM_APB2( 8, 16, 4, 1, TIM8_UP_TIM13_IRQn),
+# endif
+# ifdef TIM9
+  TIM_APB2( 9, 16, 2, 0, TIM1_BRK_TIM9_IRQn),
+  TIM_APB2(10, 16, 1, 0, TIM1_UP_TIM10_IRQn),
+  TIM_APB2(11, 16, 1, 0, TIM1_TRG_COM_TIM11_IRQn),
+# endif
+# ifdef TIM12
+  TIM_APB1(12, 16, 2,    TIM8_BRK_TIM12_IRQn),
+  TIM_APB1(13, 16, 1,    TIM8_UP_TIM13_IRQn),
+  TIM_APB1(14, 16, 1,    TIM8_TRG_COM_TIM14_IRQn),
+# endif
+};
+#else
+# define TIM_APB1(n, w, ch, irq)      { TIM##n, &RCC->APBENR1, &RCC->APBRSTR1, RCC_APBENR1_TIM##n##EN, n, 1, w, ch, 0, irq }
+# define TIM_APB2(n, w, ch, adv, irq) { TIM##n, &RCC->APBENR2, &RCC->APBRSTR2, RCC_APBENR2_TIM##n##EN, n, 1, w, ch, adv, irq }
+
+static const tim_t TIM_table[] = {             // G0 ma jedinou sbernici APB (dva registry povoleni)
+  TIM_APB2( 1, 16, 4, 1, TIM1_BRK_UP_TRG_COM_IRQn),
+  TIM_APB1( 2, 32, 4,    TIM2_IRQn),
+  TIM_APB1( 3, 16, 4,    TIM3_IRQn),
+  TIM_APB1( 6, 16, 0,    TIM6_DAC_LPTIM1_IRQn),
+  TIM_APB1( 7, 16, 0,    TIM7_LPTIM2_IRQn),
+  TIM_APB2(14, 16, 1, 0, TIM14_IRQn),
+  TIM_APB2(15, 16, 2, 1, TIM15_IRQn),
+  TIM_APB2(16, 16, 1, 1, TIM16_IRQn),
+  TIM_APB2(17, 16, 1, 1, TIM17_IRQn),
+};
+#endif
+
+#ifndef TIM_PSC_SEARCH
+# define TIM_PSC_SEARCH 32  // Pocet zkousenych delicek pri hledani nejpresnejsi periody
+#endif
+
+/**
+ * @brief  Popis casovace podle cisla.
+ *
+ * @param  number Cislo casovace (TIMx).
+ *
+ * @return Popis, nebo 0, pokud mikrokontroler casovac nema.
+ */
+INLINE_STM32 const tim_t *TIM_get(int number) {
+  for (unsigned i = 0; i < sizeof(TIM_table) / sizeof(TIM_table[0]); i++) {
+    if (TIM_table[i].number == number) return &TIM_table[i];
+  }
+  return 0;
+}
+
+/**
+ * @brief  Frekvence hodin citace (pred PSC).
+ *         Pri delicce APB > 1 jsou hodiny casovacu dvojnasobne proti PCLK.
+ *
+ */
+INLINE_STM32 uint32_t TIM_clock(const tim_t *t) {
+#if defined(STM32F4)
+  const uint32_t ppre = (t->apb == 2) ? (RCC->CFGR & RCC_CFGR_PPRE2) >> RCC_CFGR_PPRE2_Pos
+                                      : (RCC->CFGR & RCC_CFGR_PPRE1) >> RCC_CFGR_PPRE1_Pos;
+#else
+  const uint32_t ppre = (RCC->CFGR & RCC_CFGR_PPRE) >> RCC_CFGR_PPRE_Pos;
+  (void)t;
+#endif
+  return (ppre & 4) ? (SystemCoreClock >> (ppre & 3)) : SystemCoreClock; // 1xx = deleni 2^(xx + 1), x2
+}
+
+/**
+ * @brief  Reset casovace a povoleni jeho hodin.
+ *
+ */
+void TIM_enable(const tim_t *t) {
+  atomic_modify(t->rstr, t->en, t->en);       // Reset
+  atomic_modify(t->rstr, t->en, 0);           //  casovace
+  atomic_modify(t->enr, t->en, t->en);        // Povoleni CLK pro casovac
+}
+
+/**
+ * @brief  Vektor preruseni sdileny s jinou periferii (F4: TIM1 s TIM9 - TIM11, TIM8
+ *         s TIM12 - TIM14, TIM6 s DAC; G0: TIM6 a TIM7 s DAC a LPTIM).
+ *
+ */
+INLINE_STM32 int TIM_irq_shared(const tim_t *t) {
+#if defined(STM32F4)
+  int shared = t->irq == TIM1_BRK_TIM9_IRQn || t->irq == TIM1_UP_TIM10_IRQn || t->irq == TIM1_TRG_COM_TIM11_IRQn;
+# ifdef TIM6
+  shared |= t->irq == TIM6_DAC_IRQn;
+# endif
+# ifdef TIM8
+  shared |= t->irq == TIM8_UP_TIM13_IRQn;
+# endif
+# ifdef TIM12
+  shared |= t->irq == TIM8_BRK_TIM12_IRQn || t->irq == TIM8_TRG_COM_TIM14_IRQn;
+# endif
+  return shared;
+#else
+  return t->irq == TIM6_DAC_LPTIM1_IRQn || t->irq == TIM7_LPTIM2_IRQn;
+#endif
+}
+
+/**
+ * @brief  Zastaveni casovace a vypnuti jeho hodin.
+ *         Sdileny vektor preruseni zustava v NVIC povoleny (muze ho pouzivat jina periferie),
+ *         casovac sam uz zadne preruseni nevyvola (DIER = 0).
+ *
+ */
+void TIM_disable(const tim_t *t) {
+  t->tim->DIER = 0;
+  t->tim->CR1 &= ~TIM_CR1_CEN;
+  if (!TIM_irq_shared(t)) NVIC_DisableIRQ(t->irq);
+  atomic_modify(t->enr, t->en, 0);
+}
+
+/**
+ * @brief  Nastaveni PSC a ARR na periodu @p ticks taktu hodin citace.
+ *         Nejmensi mozna delicka dava nejjemnejsi krok ARR. Je-li presto perioda
+ *         nepresna, zkousi se dalsich TIM_PSC_SEARCH delicek (soucin PSC * ARR muze
+ *         periodu trefit presne).
+ *
+ * @return Skutecna perioda v taktech.
+ */
+uint64_t TIM_set_ticks(const tim_t *t, uint64_t ticks) {
+  const uint64_t arr_limit = (t->width == 32) ? 0x100000000ULL : 0x10000ULL;
+  if (ticks < 2) ticks = 2;                   // ARR = 0 casovac zastavi
+
+  uint64_t psc = (ticks - 1) / arr_limit;     // Nejmensi delicka
+  if (psc > 0xFFFF) psc = 0xFFFF;
+
+  uint64_t best_psc = psc, best_arr = arr_limit, best_err = UINT64_MAX;
+  for (uint64_t p = psc; p <= 0xFFFF && p < psc + TIM_PSC_SEARCH; p++) {
+    uint64_t arr = (ticks + p / 2) / (p + 1);
+    if (arr > arr_limit) arr = arr_limit;
+    if (arr < 2) break;
+
+    const uint64_t real = arr * (p + 1);
+    const uint64_t err = (real > ticks) ? real - ticks : ticks - real;
+    if (err < best_err) {
+      best_err = err;
+      best_psc = p;
+      best_arr = arr;
+    }
+    if (err == 0 || psc == 0) break;          // Bez delicky je krok 1 takt, presneji to nejde
+  }
+
+  t->tim->PSC = (uint32_t)best_psc;
+  t->tim->ARR = (uint32_t)(best_arr - 1);
+  t->tim->EGR = TIM_EGR_UG;                   // Nahrani PSC do stinoveho registru
+  t->tim->SR &= ~(TIM_SR_UIF);                //  (UG nastavi i UIF, proto nulovani)
+
+  return best_arr * (best_psc + 1);
+}
+
+/**
+ * @brief  Nastaveni periody preteceni v nanosekundach.
+ *
+ * @param  t         Casovac.
+ * @param  period_ns Perioda (do 4.29 s).
+ *
+ * @return Skutecna perioda v ns.
+ */
+uint32_t TIM_set_period_ns(const tim_t *t, uint32_t period_ns) {
+  const uint64_t clock = TIM_clock(t);
+  const uint64_t ticks = TIM_set_ticks(t, (clock * period_ns + 500000000ULL) / 1000000000ULL);
+
+  return (uint32_t)((ticks * 1000000000ULL + clock / 2) / clock);
+}
+
+/**
+ * @brief  Nastaveni PSC a ARR tak, aby casovac pretekal s frekvenci @p rate_hz.
+ *
+ * @param  t       Casovac.
+ * @param  rate_hz Pozadovana frekvence preteceni.
+ *
+ * @return Skutecna frekvence preteceni v Hz (0 = @p rate_hz je 0, casovac se nemeni).
+ */
+uint32_t TIM_set_rate(const tim_t *t, uint32_t rate_hz) {
+  if (!rate_hz) return 0;
+
+  const uint32_t clock = TIM_clock(t);
+  const uint64_t ticks = TIM_set_ticks(t, (clock + rate_hz / 2) / rate_hz);
+
+  return (uint32_t)(clock / ticks);
+}
+
+/**
+ * @brief  Spusteni citace od nuly.
+ *
+ */
+INLINE_STM32 void TIM_start(const tim_t *t) {
+  t->tim->CNT  = 0;
+  t->tim->CR1 |= TIM_CR1_CEN;
+}
+
+INLINE_STM32 void TIM_stop(const tim_t *t) {
+  t->tim->CR1 &= ~TIM_CR1_CEN;
+}
+
+/**
+ * @brief  Povoleni preruseni pri preteceni (obsluhu definuje aplikace).
+ *
+ */
+INLINE_STM32 void TIM_irq_enable(const tim_t *t) {
+  t->tim->SR   &= ~(TIM_SR_UIF);
+  t->tim->DIER |= TIM_DIER_UIE;
+  NVIC_EnableIRQ(t->irq);
+}
+
+/**
+ * @brief  Vystup TRGO pri kazdem preteceni (MMS = 010), spousteni DAC, ADC apod.
+ *
+ */
+INLINE_STM32 void TIM_trgo_update(const tim_t *t) {
+  t->tim->CR2 = (t->tim->CR2 & ~TIM_CR2_MMS) | TIM_CR2_MMS_1;
+}
+
+/**
+ * @brief  Registr CCRx kanalu (1 - 4).
+ *
+ */
+INLINE_STM32 volatile uint32_t *TIM_ccr(const tim_t *t, int channel) {
+  return &(&t->tim->CCR1)[channel - 1];
+}
+
+/**
+ * @brief  Nastaveni kanalu do rezimu PWM 1 (vystup aktivni pri CNT < CCRx) s preloadem CCRx.
+ *         Pin kanalu je nutne prepnout na alternativni funkci zvlast.
+ *
+ * @param  t        Casovac.
+ * @param  channel  Kanal 1 - 4.
+ * @param  inverted 1 = aktivni uroven log. 0 (CCxP).
+ *
+ */
+void TIM_pwm_channel(const tim_t *t, int channel, int inverted) {
+  const uint32_t shift = ((channel - 1) & 1) * 8;             // OC1/OC3 dolni, OC2/OC4 horni bajt
+  volatile uint32_t *ccmr = (channel <= 2) ? &t->tim->CCMR1 : &t->tim->CCMR2;
+  const uint32_t ccer = 1UL << (4 * (channel - 1));            // CCxE, CCxP o bit vys
+
+  *ccmr = (*ccmr & ~(0xFFUL << shift)) | ((6UL << 4 | 1UL << 3) << shift);
+  *TIM_ccr(t, channel) = 0;
+  t->tim->CCER = (t->tim->CCER & ~(3UL * ccer)) | ccer | (inverted ? ccer << 1 : 0);
+  if (t->advanced) t->tim->BDTR |= TIM_BDTR_MOE;
+  t->tim->CR1 |= TIM_CR1_ARPE;
+}
+#endif
+//#=== Popis casovacu (instance TIMx) - KONEC
+//#=========================================================================
+
+#ifdef TIM6
 /**
  * @brief  Pocatecni inicializace casovace.
  *
@@ -105,6 +409,47 @@ void TIM6_config(void) {
   TIM6->CNT = TIMx_CNT;                       // Prednastavena hodnota od ktere zacne pricitani. Nutno zadat pro kazde citani.*/
 }
 
+#endif
+
+/**
+ * @brief  Pocatecni inicializace casovace TIM7 s periodickym prerusenim.
+ *         Citac bezi na 1MHz (1 tick = 1us) i pri delicce APB1 > 1, preruseni nastava kazdych @p period_us.
+ *         Casovac neni spusten, spousti se nastavenim TIM_CR1_CEN v TIM7_TIM->CR1.
+ *         F401 a F411 nemaji TIM7, pouzije se TIM5 (obsluha TIM7_IRQ_HANDLER plati pro oba).
+ *
+ * @param  period_us Perioda preruseni v mikrosekundach (1 - 65536).
+ *
+ */
+void TIM7_setup(uint32_t period_us) {
+#if defined(STM32F4) || defined(STM32G0)
+  const tim_t *t = TIM_get(TIM7_NUMBER);
+  TIM_enable(t);                              // Reset a povoleni CLK pro casovac
+
+  t->tim->PSC  = TIM_clock(t) / 1000000UL - 1; // Citac na 1MHz (hodiny casovace vcetne x2 za delickou APB)
+  t->tim->ARR  = period_us - 1;
+  t->tim->CNT  = 0;
+  t->tim->EGR  = TIM_EGR_UG;                  // Nahrani PSC do stinoveho registru
+  TIM_irq_enable(t);                          // UG nastavi i UIF, TIM_irq_enable() ho nuluje
+#else                                         // L1: bez popisu tim_t
+  const uint32_t ppre = (RCC->CFGR & RCC_CFGR_PPRE1) >> 8; // PPRE1 (bity 10:8)
+  const uint32_t clock = (ppre & 4) ? (SystemCoreClock >> (ppre & 3)) : SystemCoreClock;
+
+  RCC->APB1RSTR |=  RCC_APB1RSTR_TIM7RST;     // Reset
+  RCC->APB1RSTR &= ~RCC_APB1RSTR_TIM7RST;     //  casovace
+  RCC->APB1ENR  |=  RCC_APB1ENR_TIM7EN;       // Povoleni CLK pro casovac
+
+  TIM7->PSC  = clock / 1000000UL - 1;         // Citac na 1MHz (hodiny casovace vcetne x2 za delickou APB)
+  TIM7->ARR  = period_us - 1;
+  TIM7->CNT  = 0;
+  TIM7->EGR  = TIM_EGR_UG;                    // Nahrani PSC do stinoveho registru
+  TIM7->SR  &= ~(TIM_SR_UIF);                 //  (UG nastavi i UIF, proto nulovani)
+  TIM7->DIER |= TIM_DIER_UIE;                 // Povoleni preruseni pri preteceni
+
+  NVIC_EnableIRQ(TIM7_IRQn);
+#endif
+}
+
+#ifdef TIM6
 /**
  * @brief  Casova funkce pro pozdrzeni provadeneho programu.
  *
@@ -117,11 +462,12 @@ void TIM6_delay(void) {
   TIM6->CR1 |= TIM_CR1_CEN;                   // Spusteni casovace.
 
 	while (!(TIM6->SR & TIM_SR_UIF))  {         // Kontrola, zda doslo k preteceni citace (UIF = Update Interrupt Flag).
-    /* __NOP();*/
+    CHRONO_IDLE();
   }
 
   TIM6->CR1 &= ~TIM_CR1_CEN;                  // Vypnuti casovace.
 }
+#endif
 
 #ifdef __cplusplus
 }
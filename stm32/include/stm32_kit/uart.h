@@ -2,6 +2,11 @@
  * @file       uart.h
  * @brief      Ovladac pro rozhrani UART (RS-232).
  *
+ *             UART_putc()/UART_getc() cekaji na kazdy znak. S UART_DMA = 1 (jen F4)
+ *             po UART_dma_setup() prijima DMA nepretrzite do kruhoveho bufferu
+ *             UART_rx_ring a vysila z kruhoveho bufferu UART_tx_ring (UART_send(),
+ *             packet.h), CPU na sbernici neceka.
+ *
  * @author     Petr Madecki (petr.madecki@spsehavirov.cz)
  * @author     Tomas Michalek (tomas.michalek@spsehavirov.cz)
  *
@@ -17,12 +22,18 @@
 #include "platform.h" // Podpora pro zjednodusene pinouty
 #include "chrono.h"
 #include "gpio.h"
+#include "format.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 #include "boards.h"
+
+#ifndef UART_BAUD
+# define UART_BAUD  9600            // Prenosova rychlost [Bd]
+#endif
+
 #define UART_TX_PIN    io_pin(UART_TX)
 #define UART_TX_PORT   io_port(UART_TX)
 #define UART_RX_PIN    io_pin(UART_RX)
@@ -62,7 +73,7 @@ INLINE_STM32 void UART_setup(void) {
 
     RCC->APB1ENR |= RCC_APB1ENR_USART2EN;
 
-    USART2->BRR |= UART_baudrate_calculate(SystemCoreClock, 9600, 0);
+    USART2->BRR |= UART_baudrate_calculate(SystemCoreClock, UART_BAUD, 0);
     USART2->CR1 |= USART_CR1_TE | USART_CR1_RE; // Enable Tx & Rx
     USART2->CR1 |= USART_CR1_UE; // USART Enable
 }
@@ -93,6 +104,44 @@ INLINE_STM32 size_t UART_write(const void *__restrict buf, size_t len) {
     return count;
 }
 
+/**
+ * @brief  Vypis retezce ukonceneho '\0' na UART.
+ */
+INLINE_STM32 void UART_print(const char *text) {
+    fmt_str(UART_putc, text);
+}
+
+/**
+ * @brief  Vypis celeho cisla na UART (bez sprintf).
+ *
+ * @param  value Vypisovana hodnota.
+ * @param  width Minimalni sirka (zarovnani vpravo mezerami), 0 = bez zarovnani.
+ */
+INLINE_STM32 void UART_print_int(int32_t value, int width) {
+    fmt_int(UART_putc, value, width, ' ');
+}
+
+/**
+ * @brief  Vypis cisla s pevnou desetinnou carkou na UART, napr. 2345 s decimals = 2 jako "23.45".
+ *
+ * @param  value    Hodnota vynasobena 10^decimals.
+ * @param  decimals Pocet desetinnych mist.
+ * @param  width    Minimalni sirka (zarovnani vpravo mezerami), 0 = bez zarovnani.
+ */
+INLINE_STM32 void UART_print_fixed(int32_t value, int decimals, int width) {
+    fmt_fixed(UART_putc, value, decimals, width);
+}
+
+/**
+ * @brief  Vypis cisla v sestnactkove soustave na UART.
+ *
+ * @param  value  Vypisovana hodnota.
+ * @param  digits Pocet cislic (1 - 8).
+ */
+INLINE_STM32 void UART_print_hex(uint32_t value, int digits) {
+    fmt_hex(UART_putc, value, digits);
+}
+
 INLINE_STM32 int UART_read(void *__restrict buf, size_t len) {
     uint8_t *str = (uint8_t *)buf;
     int alen = 0;
@@ -109,6 +158,177 @@ INLINE_STM32 int UART_read(void *__restrict buf, size_t len) {
     return alen;
 }
 
+#ifndef UART_DMA
+# define UART_DMA  0                // 1 = kruhove buffery s DMA (zabere 2 kanaly DMA a jejich preruseni)
+#endif
+
+#if UART_DMA && !defined(STM32F4)
+# error "UART_DMA je implementovano jen pro F4 (UART_setup() nastavuje USART2 F4)."
+#endif
+
+#if UART_DMA
+//#========================================================================
+//#=== Kruhove buffery s DMA - ZACATEK
+//
+// Prijem: DMA v kruhovem rezimu zapisuje do UART_rx_ring bez preruseni
+// na znak, preruseni na konci bufferu jen pocita obehy. UART_rx_count() tak
+// vraci celkovy pocet prijatych bajtu (index za poslednim bajtem, volne
+// bezici, maskuje se UART_RX_MASK). Buffer se musi cist driv, nez ho DMA
+// prepise dalsim obehem.
+// Vysilani: data se zapisou do UART_tx_ring od UART_tx_head a zverejni
+// UART_tx_commit(), DMA pak vysila souvisle useky az do konce bufferu.
+#include "dma.h"
+
+#ifndef UART_RX_RING
+# define UART_RX_RING  1024         // Velikost prijimaciho bufferu (mocnina 2)
+#endif
+#ifndef UART_TX_RING
+# define UART_TX_RING  1024         // Velikost vysilaciho bufferu (mocnina 2, max. 32768)
+#endif
+
+#if (UART_RX_RING & (UART_RX_RING - 1)) || (UART_TX_RING & (UART_TX_RING - 1)) || UART_TX_RING > 32768
+# error "UART_RX_RING a UART_TX_RING musi byt mocnina 2 (UART_TX_RING max. 32768)!"
+#endif
+
+#define UART_RX_MASK  (UART_RX_RING - 1)
+#define UART_TX_MASK  (UART_TX_RING - 1)
+
+#define UART_RDR  (USART2->DR)
+#define UART_TDR  (USART2->DR)
+
+static uint8_t            UART_rx_ring[UART_RX_RING];
+static uint8_t            UART_tx_ring[UART_TX_RING];
+static const dma_t       *UART_rx_dma, *UART_tx_dma;
+static volatile uint32_t  UART_rx_laps;     // Pocet obehu prijimaciho bufferu
+static uint32_t           UART_rx_last;     // Posledni hodnota UART_rx_count()
+static volatile uint16_t  UART_tx_head;     // Zapis (aplikace), index bezi volne a maskuje se
+static volatile uint16_t  UART_tx_tail;     // Odeslano (DMA)
+static volatile uint16_t  UART_tx_chunk;    // Prave vysilany usek (0 = DMA stoji)
+
+void UART_rx_event(void *ctx, uint32_t flags) {
+    (void)ctx;
+    if (flags & DMA_FLAG_COMPLETE) UART_rx_laps++;
+}
+
+/**
+ * @brief  Spusteni DMA pro dalsi souvisly usek vysilaciho bufferu (pokud DMA stoji).
+ *
+ */
+INLINE_STM32 void UART_tx_kick(void) {
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (!UART_tx_chunk && UART_tx_head != UART_tx_tail) {
+        const uint16_t start = UART_tx_tail & UART_TX_MASK;
+        uint16_t len = (uint16_t)(UART_tx_head - UART_tx_tail);
+        if (len > UART_TX_RING - start) len = UART_TX_RING - start; // Do konce bufferu, zbytek dalsim usekem
+
+        UART_tx_chunk = len;
+        dma_start(UART_tx_dma, &UART_TDR, &UART_tx_ring[start], len, DMA_MEM_TO_PERIPH | DMA_SIZE_8 | DMA_IRQ);
+    }
+
+    __set_PRIMASK(primask);
+}
+
+void UART_tx_event(void *ctx, uint32_t flags) {
+    (void)ctx;
+    if (!(flags & (DMA_FLAG_COMPLETE | DMA_FLAG_ERROR))) return;
+
+    UART_tx_tail += UART_tx_chunk;               // Pri chybe se usek zahodi
+    UART_tx_chunk = 0;
+    UART_tx_kick();
+}
+
+/**
+ * @brief  Spusteni prijmu a vysilani pres DMA (po UART_setup()).
+ *
+ * @return 1 = v poradku, 0 = neni volny kanal DMA.
+ */
+int UART_dma_setup(void) {
+    if (!UART_rx_dma) UART_rx_dma = dma_alloc(DMA_REQ_USART2_RX);
+    if (!UART_tx_dma) UART_tx_dma = dma_alloc(DMA_REQ_USART2_TX);
+    if (!UART_rx_dma || !UART_tx_dma) {          // Kanal DMA obsazen jinym ovladacem - uvolnit i ten prideleny
+        dma_free(UART_rx_dma);
+        dma_free(UART_tx_dma);
+        UART_rx_dma = UART_tx_dma = 0;
+        return 0;
+    }
+
+    dma_callback(UART_rx_dma, UART_rx_event, 0);
+    dma_callback(UART_tx_dma, UART_tx_event, 0);
+    dma_start(UART_rx_dma, &UART_RDR, UART_rx_ring, UART_RX_RING, DMA_PERIPH_TO_MEM | DMA_SIZE_8 | DMA_CIRCULAR | DMA_IRQ);
+    USART2->CR3 |= USART_CR3_DMAR | USART_CR3_DMAT;
+    return 1;
+}
+
+/**
+ * @brief  Celkovy pocet prijatych bajtu (index za poslednim bajtem v UART_rx_ring).
+ *
+ */
+uint32_t UART_rx_count(void) {
+    uint32_t laps, remaining;
+    do {
+        laps = UART_rx_laps;
+        remaining = dma_remaining(UART_rx_dma);
+    } while (laps != UART_rx_laps);
+
+    uint32_t count = laps * UART_RX_RING + (UART_RX_RING - remaining);
+    if ((int32_t)(count - UART_rx_last) < 0) {
+        count += UART_RX_RING;                   // DMA uz zacal dalsi obeh, preruseni jeste ceka
+    }
+    UART_rx_last = count;
+    return count;
+}
+
+/**
+ * @brief  Volne misto ve vysilacim bufferu.
+ *
+ */
+INLINE_STM32 uint16_t UART_tx_space(void) {
+    return (uint16_t)(UART_TX_RING - 1 - (uint16_t)(UART_tx_head - UART_tx_tail));
+}
+
+/**
+ * @brief  Zverejneni dat zapsanych do UART_tx_ring az po @p head a spusteni vysilani.
+ *
+ */
+INLINE_STM32 void UART_tx_commit(uint16_t head) {
+    UART_tx_head = head;
+    UART_tx_kick();
+}
+
+/**
+ * @brief  Zapis do vysilaciho bufferu (ceka jen na misto v bufferu, ne na vysilani).
+ *
+ * @return Pocet zapsanych bajtu (0, pokud jsou data vetsi nez buffer).
+ */
+size_t UART_send(const void *buf, size_t len) {
+    const uint8_t *src = (const uint8_t *)buf;
+    uint16_t head = UART_tx_head;
+
+    if (len >= UART_TX_RING) return 0;
+    while (UART_tx_space() < len) {
+        CHRONO_IDLE();
+    }
+    for (size_t i = 0; i < len; i++) {
+        UART_tx_ring[head++ & UART_TX_MASK] = src[i];
+    }
+    UART_tx_commit(head);
+    return len;
+}
+
+/**
+ * @brief  Probiha vysilani z bufferu?
+ *
+ */
+INLINE_STM32 int UART_tx_busy(void) {
+    return UART_tx_head != UART_tx_tail;
+}
+
+//#=== Kruhove buffery s DMA - KONEC
+//#========================================================================
+#endif
+
 #ifdef __cplusplus
 }
 #endif
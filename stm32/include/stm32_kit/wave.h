@@ -0,0 +1,207 @@
+/**
+ * @file       wave.h
+ * @brief      Generator prubehu na pinech portu (casovac + DMA do registru BSRR).
+ *
+ *             Kazdy prvek bufferu je slovo pro BSRR (horni polovina nuluje, dolni
+ *             nastavuje piny), DMA ho zapise pri kazdem preteceni casovace TIM1.
+ *             Vystup tak bezi bez ucasti CPU a bez jitteru od preruseni, rychlost
+ *             je dana jen frekvenci casovace (jednotky MHz).
+ *
+ *             Rezimy:
+ *               - wave_start(): jednorazovy nebo opakovany (kruhovy) vystup bufferu,
+ *               - wave_stream(): dvojity buffer, po odeslani kazde poloviny se vola
+ *                 funkce pro jeji doplneni (dlouhe nebo generovane sekvence).
+ *
+ *             Smerovani: pozadavek TIM1_UP, stream/kanal DMA prideli dma_alloc()
+ *                        (F4 - DMA2 Stream5 Channel6, DMA1 nema pristup ke GPIO).
+ *
+ * @code
+ *     static uint32_t steps[4];
+ *     const uint32_t mask = io_pin_pos(PD12) | io_pin_pos(PD13);
+ *     steps[0] = wave_pattern(mask, io_pin_pos(PD12));   // Krokovy motor, LED ...
+ *     steps[1] = wave_pattern(mask, mask);
+ *     steps[2] = wave_pattern(mask, io_pin_pos(PD13));
+ *     steps[3] = wave_pattern(mask, 0);
+ *
+ *     wave_setup(PD12, 1000);                // Port D, 1000 kroku za sekundu
+ *     wave_start(steps, 4, 1);               // Stale dokola
+ * @endcode
+ *
+ * @author     Petr Madecki (petr.madecki@spsehavirov.cz)
+ * @author     Tomas Michalek (tomas.michalek@spsehavirov.cz)
+ *
+ * @date       2026-10-19
+ * @copyright  Copyright SPSE Havirov (c) 2026
+ */
+#ifndef STM32_KIT_WAVE
+#define STM32_KIT_WAVE
+
+#include "platform.h"
+#include "gpio.h"
+#include "timers.h"
+#include "dma.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//#========================================================================
+//#=== Smerovani casovac -> DMA - ZACATEK
+#ifndef WAVE_TIM
+# define WAVE_TIM  1                // TIM1 (F4: jen DMA2 ma pristup ke GPIO, tedy casovac na APB2)
+# define WAVE_REQ  DMA_REQ_TIM1_UP  // Pozadavek DMA casovace (pri zmene WAVE_TIM nastavit take)
+#endif
+//#=== Smerovani casovac -> DMA - KONEC
+//#========================================================================
+
+/**
+ * @brief Doplneni poloviny bufferu pri wave_stream().
+ *
+ * @param  words Prvni slovo poloviny, ktera byla prave odeslana.
+ * @param  count Pocet slov poloviny.
+ */
+typedef void (*wave_refill_t)(uint32_t *words, uint16_t count);
+
+static const dma_t *WAVE_dma;
+static const tim_t *WAVE_tim;
+
+static GPIO_TypeDef        *WAVE_port;
+static uint32_t            *WAVE_buffer;
+static uint16_t             WAVE_count;
+static wave_refill_t        WAVE_refill;
+static volatile uint8_t     WAVE_running;
+static volatile uint32_t    WAVE_underruns; // Doplneni nestihlo odeslani (obe poloviny hotove)
+
+/**
+ * @brief  Slovo BSRR pro piny @p mask: bity z @p bits v log. 1 se nastavi, ostatni vynuluji.
+ *
+ */
+INLINE_STM32 CONSTEXPR uint32_t wave_pattern(uint32_t mask, uint32_t bits) {
+  return (bits & mask & 0xFFFFUL) | ((~bits & mask & 0xFFFFUL) << 16);
+}
+
+/**
+ * @brief  Slovo BSRR pro jeden pin.
+ *
+ */
+INLINE_STM32 CONSTEXPR uint32_t wave_pin(enum pin pin, int value) {
+  return IO_PIN_BSRR(io_pin(pin), value);
+}
+
+/**
+ * @brief  Zastaveni vystupu (piny zustanou v poslednim zapsanem stavu).
+ *
+ */
+void wave_stop(void) {
+  if (!WAVE_dma) return;                      // wave_setup() neuspel
+
+  TIM_stop(WAVE_tim);
+  WAVE_tim->tim->DIER &= ~TIM_DIER_UDE;
+  dma_stop(WAVE_dma);
+  WAVE_running = 0;
+}
+
+/**
+ * @brief  Udalost DMA generatoru (z preruseni DMA).
+ *
+ */
+void wave_dma_event(void *ctx, uint32_t flags) {
+  const uint16_t half = WAVE_count / 2;
+  (void)ctx;
+
+  if (flags & DMA_FLAG_ERROR) {
+    wave_stop();
+    return;
+  }
+
+  if (WAVE_refill) {
+    if ((flags & DMA_FLAG_HALF) && (flags & DMA_FLAG_COMPLETE)) WAVE_underruns++;
+    if (flags & DMA_FLAG_HALF) WAVE_refill(WAVE_buffer, half);
+    if (flags & DMA_FLAG_COMPLETE) WAVE_refill(WAVE_buffer + half, half);
+  } else if (flags & DMA_FLAG_COMPLETE) {
+    wave_stop();                              // Jednorazovy vystup dokoncen
+  }
+}
+
+/**
+ * @brief  Pocatecni inicializace generatoru.
+ *         Piny portu, na ktere se bude zapisovat, musi byt nastaveny jako vystupy.
+ *
+ * @param  pin     Libovolny pin ciloveho portu.
+ * @param  rate_hz Pocet slov zapsanych za sekundu.
+ *
+ * @return Skutecna frekvence (omezena rozlisenim PSC/ARR), 0 = neni volny kanal DMA.
+ */
+uint32_t wave_setup(enum pin pin, uint32_t rate_hz) {
+  WAVE_port = io_port(pin);
+  WAVE_tim  = TIM_get(WAVE_TIM);
+
+  if (!WAVE_dma) WAVE_dma = dma_alloc(WAVE_REQ);
+  if (!WAVE_dma) return 0;                    // Stream/kanal DMA obsazen jinym ovladacem
+  dma_callback(WAVE_dma, wave_dma_event, 0);
+
+  TIM_enable(WAVE_tim);
+  return TIM_set_rate(WAVE_tim, rate_hz);
+}
+
+INLINE_STM32 void wave_run(const uint32_t *words, uint16_t count, uint32_t mode) {
+  if (!WAVE_dma) return;                      // wave_setup() neuspel
+
+  wave_stop();
+
+  dma_start(WAVE_dma, &WAVE_port->BSRR, words, count, DMA_MEM_TO_PERIPH | DMA_SIZE_32 | mode);
+
+  WAVE_running = 1;
+  WAVE_tim->tim->DIER |= TIM_DIER_UDE;        // Pozadavek DMA pri kazdem preteceni
+  TIM_start(WAVE_tim);
+}
+
+/**
+ * @brief  Vystup bufferu slov BSRR.
+ *
+ * @param  words Buffer (musi existovat po celou dobu vystupu).
+ * @param  count Pocet slov.
+ * @param  loop  0 = jednou (pak se generator zastavi), 1 = stale dokola.
+ *
+ */
+void wave_start(const uint32_t *words, uint16_t count, int loop) {
+  WAVE_refill = 0;
+  wave_run(words, count, loop ? DMA_CIRCULAR : DMA_IRQ); // Preruseni jen pro zastaveni na konci
+}
+
+/**
+ * @brief  Nepretrzity vystup s dvojitym bufferem.
+ *         Obe poloviny se nejdrive naplni, pak se po odeslani kazde poloviny
+ *         v preruseni DMA zavola @p refill pro jeji doplneni (druha polovina se
+ *         mezitim odesila).
+ *
+ * @param  buffer Buffer pro obe poloviny.
+ * @param  count  Velikost bufferu (sude cislo).
+ * @param  refill Funkce pro doplneni poloviny bufferu.
+ *
+ */
+void wave_stream(uint32_t *buffer, uint16_t count, wave_refill_t refill) {
+  const uint16_t half = count / 2;
+
+  WAVE_buffer = buffer;
+  WAVE_count  = half * 2;
+  WAVE_refill = refill;
+
+  refill(buffer, half);
+  refill(buffer + half, half);
+  wave_run(buffer, WAVE_count, DMA_CIRCULAR | DMA_IRQ);
+}
+
+/**
+ * @brief  Probiha vystup?
+ *
+ */
+INLINE_STM32 int wave_busy(void) {
+  return WAVE_running;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STM32_KIT_WAVE */
@@ -0,0 +1,260 @@
+/**
+ * @file       ws2812.h
+ * @brief      Ovladac adresovatelnych RGB LED WS2812/WS2812B (NeoPixel) - PWM casovace + DMA.
+ *
+ *             Kazdy bit barvy se vysila jako jedna perioda PWM 800 kHz (1.25 us),
+ *             log. 0 = kratky puls (0.4 us), log. 1 = dlouhy puls (0.8 us). Stridu
+ *             zapisuje DMA do registru CCRx pri kazdem preteceni casovace.
+ *
+ *             Snimek se uklada do bufferu barev (3 B na LED, poradi GRB). Pole strid
+ *             pro cely pasek by zabralo 48 B na LED (300 LED = 14 kB), proto DMA bezi
+ *             v kruhovem rezimu nad malym dvojitym bufferem a preruseni po odeslani
+ *             kazde poloviny zakoduje do ni dalsi LED. Po poslednich datech se vysle
+ *             nulova strida po dobu resetu (>= 280 us, WS2812B), potom se casovac zastavi.
+ *
+ *             Doba snimku: (WS2812_LEDS + WS2812_RESET_LEDS) * 30 us,
+ *             napr. 300 LED = 9.3 ms (~107 snimku za sekundu), viz WS2812_frame_us().
+ *
+ *             Smerovani (vystup PB6):
+ *               F4 - TIM4_CH1 (AF2), pozadavek DMA TIM4_UP,
+ *               G0 - TIM1_CH3 (AF1), pozadavek DMA TIM1_UP
+ *                    (TIM1 sdili s wave.h, nelze pouzit soucasne),
+ *               stream/kanal DMA prideli dma_alloc().
+ *
+ * @code
+ *     WS2812_setup();
+ *     WS2812_set(0, 255, 0, 0);              // Prvni LED cervene
+ *     WS2812_fill(0, 0, 32);                 // nebo vse modre
+ *     WS2812_show();                         // Odeslani bezi na pozadi
+ *     while (WS2812_busy()) {}
+ * @endcode
+ *
+ * @author     Petr Madecki (petr.madecki@spsehavirov.cz)
+ * @author     Tomas Michalek (tomas.michalek@spsehavirov.cz)
+ *
+ * @date       2026-10-19
+ * @copyright  Copyright SPSE Havirov (c) 2026
+ */
+#ifndef STM32_KIT_WS2812
+#define STM32_KIT_WS2812
+
+#include <string.h>
+
+#include "platform.h"
+#include "chrono.h"
+#include "gpio.h"
+#include "pin.h"
+#include "timers.h"
+#include "dma.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef WS2812_HALF_LEDS
+# define WS2812_HALF_LEDS   2   // Pocet LED v jedne polovine DMA bufferu (1 preruseni na 2 LED)
+#endif
+#define WS2812_RESET_LEDS  10   // Reset = 10 LED s nulovou stridou (300 us)
+#define WS2812_BITS        24
+#define WS2812_RATE_HZ     800000UL
+
+//#========================================================================
+//#=== Smerovani casovac -> DMA - ZACATEK
+#ifndef WS2812_TIM
+# if defined(STM32F4)
+#  define WS2812_PIN          PB6
+#  define WS2812_AF           PIN_AF2
+#  define WS2812_TIM          4   // TIM4
+#  define WS2812_CHANNEL      1
+#  define WS2812_REQ          DMA_REQ_TIM4_UP
+# elif defined(STM32G0)
+#  define WS2812_PIN          PB6
+#  define WS2812_AF           PIN_AF1
+#  define WS2812_TIM          1   // TIM1
+#  define WS2812_CHANNEL      3
+#  define WS2812_REQ          DMA_REQ_TIM1_UP
+# else
+#  error "WS2812 neni pro tuto radu implementovano (podporovano: F4, G0)."
+# endif
+#endif
+//#=== Smerovani casovac -> DMA - KONEC
+//#========================================================================
+
+#define WS2812_HALF_SLOTS  (WS2812_HALF_LEDS * WS2812_BITS)
+#define WS2812_CCR         (*TIM_ccr(WS2812_tim, WS2812_CHANNEL))
+
+static const dma_t *WS2812_dma;
+static const tim_t *WS2812_tim;
+
+static uint8_t           WS2812_frame[WS2812_LEDS * 3];        // Barvy v poradi GRB
+static uint16_t          WS2812_slots[2 * WS2812_HALF_SLOTS];  // Dvojity buffer strid pro DMA
+static uint16_t          WS2812_t0h, WS2812_t1h;               // Strida pro log. 0 a 1 (tiky casovace)
+static volatile uint16_t WS2812_next;                          // Dalsi kodovana LED (vcetne resetu)
+static volatile uint8_t  WS2812_draining;                      // Posledni data odesilana, pak stop
+static volatile uint8_t  WS2812_running;
+static volatile uint32_t WS2812_underruns; // Kodovani nestihlo odeslani (snimek poskozen)
+
+void WS2812_dma_event(void *ctx, uint32_t flags);
+
+/**
+ * @brief  Pocatecni inicializace pinu, casovace a DMA.
+ *         Hodiny casovace alespon 8 MHz (rozliseni strid).
+ *
+ * @return 1 = OK, 0 = neni volny kanal DMA.
+ */
+int WS2812_setup(void) {
+  if (!WS2812_dma) WS2812_dma = dma_alloc(WS2812_REQ);
+  if (!WS2812_dma) return 0;                  // Stream/kanal DMA obsazen jinym ovladacem
+  dma_callback(WS2812_dma, WS2812_dma_event, 0);
+
+  WS2812_tim = TIM_get(WS2812_TIM);
+
+  pin_setup_af(WS2812_PIN, PIN_MODE_AF, PIN_PULL_DEFAULT, PIN_SPEED_HIGH, PIN_TYPE_PUSHPULL, WS2812_AF);
+
+  TIM_enable(WS2812_tim);
+
+  TIM_set_rate(WS2812_tim, WS2812_RATE_HZ);
+  const uint32_t period = (WS2812_tim->tim->ARR + 1) * (WS2812_tim->tim->PSC + 1);
+  WS2812_t0h = (uint16_t)((period *  8 + 12) / 25);                 // 0.32 periody = 0.4 us
+  WS2812_t1h = (uint16_t)((period * 16 + 12) / 25);                 // 0.64 periody = 0.8 us
+
+  TIM_pwm_channel(WS2812_tim, WS2812_CHANNEL, 0);
+  WS2812_tim->tim->EGR = TIM_EGR_UG;                                // CCR = 0 do stinoveho registru
+  return 1;
+}
+
+/**
+ * @brief  Nastaveni barvy LED (projevi se po WS2812_show()).
+ *
+ * @param  index Poradi LED na pasku (od 0).
+ *
+ */
+INLINE_STM32 void WS2812_set(uint16_t index, uint8_t r, uint8_t g, uint8_t b) {
+  if (index >= WS2812_LEDS) return;
+  uint8_t *led = &WS2812_frame[3 * index];
+  led[0] = g;
+  led[1] = r;
+  led[2] = b;
+}
+
+/**
+ * @brief  Nastaveni barvy vsech LED.
+ *
+ */
+void WS2812_fill(uint8_t r, uint8_t g, uint8_t b) {
+  for (uint16_t i = 0; i < WS2812_LEDS; i++) {
+    WS2812_set(i, r, g, b);
+  }
+}
+
+/**
+ * @brief  Zakodovani dalsich LED (nebo resetu) do poloviny bufferu strid.
+ *
+ */
+INLINE_STM32 void WS2812_encode(uint16_t *slot) {
+  for (int n = 0; n < WS2812_HALF_LEDS; n++, WS2812_next++) {
+    if (WS2812_next >= WS2812_LEDS) {
+      memset(slot, 0, WS2812_BITS * sizeof(*slot));   // Reset: vystup v log. 0
+      slot += WS2812_BITS;
+      continue;
+    }
+
+    const uint8_t *led = &WS2812_frame[3 * WS2812_next];
+    const uint32_t grb = (uint32_t)led[0] << 16 | (uint32_t)led[1] << 8 | led[2];
+    for (uint32_t bit = 1UL << (WS2812_BITS - 1); bit; bit >>= 1) {
+      *slot++ = (grb & bit) ? WS2812_t1h : WS2812_t0h;
+    }
+  }
+}
+
+/**
+ * @brief  Zastaveni vysilani (vystup zustane v log. 0).
+ *
+ */
+void WS2812_stop(void) {
+  if (!WS2812_dma) return;                    // WS2812_setup() neuspel
+
+  WS2812_tim->tim->DIER &= ~TIM_DIER_UDE;
+  dma_stop(WS2812_dma);
+  WS2812_CCR = 0;
+  WS2812_tim->tim->EGR = TIM_EGR_UG;
+  TIM_stop(WS2812_tim);
+  WS2812_running = 0;
+}
+
+/**
+ * @brief  Probiha odesilani snimku?
+ *
+ */
+INLINE_STM32 int WS2812_busy(void) {
+  return WS2812_running;
+}
+
+/**
+ * @brief  Odeslani bufferu barev na pasek (na pozadi, ceka na dokonceni predchoziho snimku).
+ *         Buffer barev lze po navratu menit, LED jeste neodeslane vsak mohou zmenu prevzit.
+ *
+ */
+void WS2812_show(void) {
+  if (!WS2812_dma) return;                    // WS2812_setup() neuspel
+
+  while (WS2812_running) {
+    CHRONO_IDLE();
+  }
+
+  WS2812_next = 0;
+  WS2812_draining = 0;
+  WS2812_encode(WS2812_slots);
+  WS2812_encode(WS2812_slots + WS2812_HALF_SLOTS);
+
+  WS2812_running = 1;
+  dma_start(WS2812_dma, &WS2812_CCR, WS2812_slots, 2 * WS2812_HALF_SLOTS,
+            DMA_MEM_TO_PERIPH | DMA_SIZE_16 | DMA_CIRCULAR | DMA_IRQ);
+
+  WS2812_tim->tim->SR    = 0;
+  WS2812_tim->tim->DIER |= TIM_DIER_UDE;      // Pri preteceni: CCR z preloadu, DMA zapise dalsi stridu
+  TIM_start(WS2812_tim);
+}
+
+/**
+ * @brief  Teoreticka doba odeslani snimku v us (data + reset).
+ *         Omezuje maximalni snimkovou frekvenci: 1000000 / WS2812_frame_us().
+ *
+ */
+INLINE_STM32 CONSTEXPR uint32_t WS2812_frame_us(void) {
+  return ((uint32_t)(WS2812_LEDS + WS2812_RESET_LEDS) * WS2812_BITS * 1000000UL) / WS2812_RATE_HZ;
+}
+
+/**
+ * @brief  Udalost DMA (z preruseni DMA) - kodovani dalsi poloviny bufferu.
+ *
+ */
+void WS2812_dma_event(void *ctx, uint32_t flags) {
+  (void)ctx;
+
+  if (flags & DMA_FLAG_ERROR) {
+    WS2812_stop();
+    return;
+  }
+
+  if ((flags & DMA_FLAG_HALF) && (flags & DMA_FLAG_COMPLETE)) WS2812_underruns++;
+
+  for (int half = 0; half < 2; half++) {
+    if (!(flags & (half ? DMA_FLAG_COMPLETE : DMA_FLAG_HALF))) continue;
+
+    if (WS2812_next >= WS2812_LEDS + WS2812_RESET_LEDS) {
+      if (WS2812_draining) {                  // Posledni polovina resetu odeslana
+        WS2812_stop();
+        return;
+      }
+      WS2812_draining = 1;
+    }
+    WS2812_encode(WS2812_slots + half * WS2812_HALF_SLOTS);
+  }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STM32_KIT_WS2812 */
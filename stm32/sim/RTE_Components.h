@@ -0,0 +1,16 @@
+/*
+ * Run-Time-Environment Configuration File pro simulaci na PC (Linux)
+ *
+ * Nahrazuje RTE_Components.h generovany Keilem, pokud je adresar stm32/sim
+ * v include path pred projektem desky.
+ */
+
+#ifndef RTE_COMPONENTS_H
+#define RTE_COMPONENTS_H
+
+/*
+ * Define the Device Header File:
+ */
+#define CMSIS_device_header "sim_device.h"
+
+#endif /* RTE_COMPONENTS_H */
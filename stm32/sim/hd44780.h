@@ -0,0 +1,408 @@
+/**
+ * @file       hd44780.h
+ * @brief      Behavioralni model radice LCD HD44780 pro simulaci na PC.
+ *
+ *             Model se pripoji k pinum RS, RW, EN a DB4 - DB7 (sim_gpio_listen())
+ *             a pri kazde zmene pinu:
+ *               - kontroluje casovani sbernice proti virtualnimu casu (tcycE, PWEH,
+ *                 tAS, tAH, tDSW, tH dle datasheetu HD44780U),
+ *               - sklada nibbly (4bit rezim po Function Set s DL = 0) a provadi prikazy,
+ *               - hlida dobu vykonani prikazu (zapis behem "busy" se zahodi),
+ *               - udrzuje DDRAM, CGRAM, kurzor a posun displeje.
+ *
+ *             Viditelny obsah displeje lze vykreslit jako text (hd44780_print()),
+ *             souhrn poruseni casovani vypise hd44780_report().
+ *
+ * @code
+ *     static hd44780_t lcd;
+ *     hd44780_attach(&lcd, LCD_RS, LCD_RW, LCD_EN, LCD_DB4, LCD_DB5, LCD_DB6, LCD_DB7, LCD_COLS, LCD_ROWS);
+ *     LCD_setup();
+ *     LCD_print("Hello");
+ *     hd44780_print(&lcd, stdout);
+ * @endcode
+ *
+ * @author     Petr Madecki (petr.madecki@spsehavirov.cz)
+ * @author     Tomas Michalek (tomas.michalek@spsehavirov.cz)
+ *
+ * @date       2026-10-19
+ * @copyright  Copyright SPSE Havirov (c) 2026
+ */
+#ifndef STM32_KIT_SIM_HD44780
+#define STM32_KIT_SIM_HD44780
+
+#include <stdio.h>
+#include <string.h>
+
+#include "sim_device.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Druhy poruseni casovani.
+ */
+typedef enum {
+  HD44780_TCYCE,        // Perioda EN (enable cycle time)
+  HD44780_PWEH,         // Sirka pulzu EN
+  HD44780_TAS,          // Predstih RS/RW pred nabeznou hranou EN (i zmena RS/RW pri EN = 1)
+  HD44780_TAH,          // Drzeni RS/RW po sestupne hrane EN
+  HD44780_TDSW,         // Predstih dat pred sestupnou hranou EN
+  HD44780_TH,           // Drzeni dat po sestupne hrane EN
+  HD44780_BUSY,         // Zapis behem vykonavani predchoziho prikazu
+  HD44780_VIOLATIONS
+} hd44780_violation_t;
+
+static const char *const hd44780_violation_name[HD44780_VIOLATIONS] = {
+  "tcycE", "PWEH", "tAS", "tAH", "tDSW", "tH", "busy"
+};
+
+/**
+ * @brief Casove limity sbernice v ns.
+ */
+typedef struct {
+  uint32_t tcyce_ns;
+  uint32_t pweh_ns;
+  uint32_t tas_ns;
+  uint32_t tah_ns;
+  uint32_t tdsw_ns;
+  uint32_t th_ns;
+} hd44780_timing_t;
+
+static const hd44780_timing_t HD44780_TIMING_5V = { 500, 230, 40, 10, 80, 10 };   // VCC 4.5 - 5.5V
+static const hd44780_timing_t HD44780_TIMING_3V = { 1000, 450, 60, 20, 195, 10 }; // VCC 2.7 - 4.5V
+
+#define HD44780_EXEC_NS       37000ULL    // Bezny prikaz a zapis dat
+#define HD44780_EXEC_LONG_NS  1520000ULL  // Clear display, Return home
+
+typedef struct {
+  // Pripojeni a nastaveni modelu
+  int pin_rs, pin_rw, pin_en, pin_db[4];
+  int cols, rows;
+  hd44780_timing_t timing;
+  int verbose;                  // Vypis kazdeho poruseni na stderr
+
+  // Stav sbernice
+  int rs, rw, en, db;           // db = uroven DB4 - DB7 jako nibble
+  uint64_t t_rs, t_db, t_en_rise, t_en_fall;
+  int en_pulses;                // Pocet pulzu EN (kontrola tcycE a drzeni az po prvnim)
+
+  // Stav radice
+  uint8_t ddram[0x80];
+  uint8_t cgram[0x40];
+  uint8_t ac;                   // Address counter
+  uint8_t cgram_mode;           // AC adresuje CGRAM
+  uint8_t increment;            // I/D
+  uint8_t shift_on_write;       // S
+  uint8_t display_on, cursor_on, blink_on;
+  uint8_t two_lines;            // N
+  uint8_t four_bit;             // DL = 0
+  uint8_t nibble_pending;       // Ceka se na dolni nibble
+  uint8_t nibble_hi;
+  uint8_t nibble_dropped;       // Horni nibble prisel behem busy
+  int shift;                    // Posun displeje (0 - 39)
+  uint64_t busy_until;
+
+  // Statistika
+  uint32_t violations[HD44780_VIOLATIONS];
+  uint32_t commands, data, ignored, reads;
+  uint64_t first_violation_ns;
+  char first_violation[96];
+} hd44780_t;
+
+/**
+ * @brief  Zaznam poruseni casovani.
+ */
+static inline void hd44780_violation(hd44780_t *lcd, hd44780_violation_t type, uint64_t measured, uint64_t required) {
+  char msg[96];
+
+  snprintf(msg, sizeof(msg), "%s: %llu ns < %llu ns", hd44780_violation_name[type],
+           (unsigned long long)measured, (unsigned long long)required);
+  if (!lcd->first_violation[0]) {
+    lcd->first_violation_ns = sim_now_ns();
+    strcpy(lcd->first_violation, msg);
+  }
+  lcd->violations[type]++;
+
+  if (lcd->verbose) {
+    fprintf(stderr, "hd44780 [%10llu ns] %s\n", (unsigned long long)sim_now_ns(), msg);
+  }
+}
+
+/**
+ * @brief  Posun adresy DDRAM stejne jako radic (konec radku -> dalsi radek).
+ */
+static inline uint8_t hd44780_ddram_step(const hd44780_t *lcd, uint8_t ac, int dir) {
+  if (lcd->two_lines) {
+    if (dir > 0) return (ac == 0x27) ? 0x40 : (ac == 0x67) ? 0x00 : ac + 1;
+    return (ac == 0x40) ? 0x27 : (ac == 0x00) ? 0x67 : ac - 1;
+  }
+  if (dir > 0) return (ac >= 0x4F) ? 0x00 : ac + 1;
+  return (ac == 0x00) ? 0x4F : ac - 1;
+}
+
+/**
+ * @brief  Posun displeje o 1 znak (dir > 0 = obsah doleva).
+ */
+static inline void hd44780_shift(hd44780_t *lcd, int dir) {
+  const int len = lcd->two_lines ? 40 : 80;
+  lcd->shift = (lcd->shift + dir + len) % len;
+}
+
+/**
+ * @brief  Provedeni prikazu (RS = 0).
+ *
+ * @return Doba vykonani v ns.
+ */
+static inline uint64_t hd44780_command(hd44780_t *lcd, uint8_t cmd) {
+  lcd->commands++;
+
+  if (cmd & 0x80) {                       // Set DDRAM address
+    lcd->ac = cmd & 0x7F;
+    lcd->cgram_mode = 0;
+  } else if (cmd & 0x40) {                // Set CGRAM address
+    lcd->ac = cmd & 0x3F;
+    lcd->cgram_mode = 1;
+  } else if (cmd & 0x20) {                // Function set
+    lcd->four_bit = !(cmd & 0x10);
+    lcd->two_lines = !!(cmd & 0x08);
+    lcd->nibble_pending = 0;
+  } else if (cmd & 0x10) {                // Cursor/display shift
+    const int dir = (cmd & 0x04) ? 1 : -1;
+    if (cmd & 0x08) hd44780_shift(lcd, -dir); // S/C = 1: posun displeje (LCD_SL = obsah doleva)
+    else lcd->ac = hd44780_ddram_step(lcd, lcd->ac, dir);
+  } else if (cmd & 0x08) {                // Display on/off control
+    lcd->display_on = !!(cmd & 0x04);
+    lcd->cursor_on = !!(cmd & 0x02);
+    lcd->blink_on = !!(cmd & 0x01);
+  } else if (cmd & 0x04) {                // Entry mode set
+    lcd->increment = !!(cmd & 0x02);
+    lcd->shift_on_write = !!(cmd & 0x01);
+  } else if (cmd & 0x02) {                // Return home
+    lcd->ac = 0;
+    lcd->cgram_mode = 0;
+    lcd->shift = 0;
+    return HD44780_EXEC_LONG_NS;
+  } else if (cmd & 0x01) {                // Clear display
+    memset(lcd->ddram, ' ', sizeof(lcd->ddram));
+    lcd->ac = 0;
+    lcd->cgram_mode = 0;
+    lcd->shift = 0;
+    lcd->increment = 1;
+    return HD44780_EXEC_LONG_NS;
+  }
+
+  return HD44780_EXEC_NS;
+}
+
+/**
+ * @brief  Zapis dat do DDRAM/CGRAM (RS = 1).
+ */
+static inline uint64_t hd44780_data(hd44780_t *lcd, uint8_t data) {
+  const int dir = lcd->increment ? 1 : -1;
+  lcd->data++;
+
+  if (lcd->cgram_mode) {
+    lcd->cgram[lcd->ac & 0x3F] = data & 0x1F;
+    lcd->ac = (lcd->ac + dir) & 0x3F;
+  } else {
+    lcd->ddram[lcd->ac & 0x7F] = data;
+    lcd->ac = hd44780_ddram_step(lcd, lcd->ac, dir);
+    if (lcd->shift_on_write) hd44780_shift(lcd, dir);
+  }
+
+  return HD44780_EXEC_NS;
+}
+
+/**
+ * @brief  Zpracovani zapsaneho bajtu (prikaz nebo data).
+ */
+static inline void hd44780_execute(hd44780_t *lcd, uint8_t value, int dropped) {
+  if (dropped) {
+    lcd->ignored++;
+    return;
+  }
+
+  const uint64_t exec = lcd->rs ? hd44780_data(lcd, value) : hd44780_command(lcd, value);
+  lcd->busy_until = sim_now_ns() + exec;
+}
+
+/**
+ * @brief  Sestupna hrana EN - zapis nibble (4bit) nebo bajtu (8bit, DB0 - DB3 = 0).
+ */
+static inline void hd44780_latch(hd44780_t *lcd) {
+  const uint64_t now = sim_now_ns();
+  const int busy = now < lcd->busy_until;
+
+  if (lcd->rw) {                          // Cteni (busy flag / data) se nemodeluje
+    lcd->reads++;
+    return;
+  }
+  if (busy) hd44780_violation(lcd, HD44780_BUSY, lcd->busy_until - now, 0);
+
+  if (!lcd->four_bit) {
+    hd44780_execute(lcd, (uint8_t)(lcd->db << 4), busy);
+  } else if (!lcd->nibble_pending) {
+    lcd->nibble_hi = (uint8_t)lcd->db;
+    lcd->nibble_dropped = (uint8_t)busy;
+    lcd->nibble_pending = 1;
+  } else {
+    lcd->nibble_pending = 0;
+    hd44780_execute(lcd, (uint8_t)((lcd->nibble_hi << 4) | lcd->db), busy || lcd->nibble_dropped);
+  }
+}
+
+/**
+ * @brief  Posluchac zmen pinu (registruje hd44780_attach()).
+ */
+static inline void hd44780_on_pin(void *ctx, int pin, int level) {
+  hd44780_t *lcd = (hd44780_t *)ctx;
+  const uint64_t now = sim_now_ns();
+  const hd44780_timing_t *t = &lcd->timing;
+
+  if (pin == lcd->pin_en) {
+    if (level && !lcd->en) {              // Nabezna hrana
+      if (lcd->en_pulses && now - lcd->t_en_rise < t->tcyce_ns) {
+        hd44780_violation(lcd, HD44780_TCYCE, now - lcd->t_en_rise, t->tcyce_ns);
+      }
+      if (now - lcd->t_rs < t->tas_ns) {
+        hd44780_violation(lcd, HD44780_TAS, now - lcd->t_rs, t->tas_ns);
+      }
+      lcd->t_en_rise = now;
+    } else if (!level && lcd->en) {       // Sestupna hrana
+      if (now - lcd->t_en_rise < t->pweh_ns) {
+        hd44780_violation(lcd, HD44780_PWEH, now - lcd->t_en_rise, t->pweh_ns);
+      }
+      if (now - lcd->t_db < t->tdsw_ns) {
+        hd44780_violation(lcd, HD44780_TDSW, now - lcd->t_db, t->tdsw_ns);
+      }
+      lcd->t_en_fall = now;
+      lcd->en_pulses++;
+      lcd->en = 0;
+      hd44780_latch(lcd);
+    }
+    lcd->en = level;
+    return;
+  }
+
+  if (pin == lcd->pin_rs || pin == lcd->pin_rw) {
+    if (lcd->en) {
+      hd44780_violation(lcd, HD44780_TAS, 0, t->tas_ns); // Zmena adresy behem EN = 1
+    } else if (lcd->en_pulses && now - lcd->t_en_fall < t->tah_ns) {
+      hd44780_violation(lcd, HD44780_TAH, now - lcd->t_en_fall, t->tah_ns);
+    }
+    if (pin == lcd->pin_rs) lcd->rs = level;
+    else lcd->rw = level;
+    lcd->t_rs = now;
+    return;
+  }
+
+  for (int i = 0; i < 4; i++) {
+    if (pin != lcd->pin_db[i]) continue;
+
+    if (!lcd->en && lcd->en_pulses && now - lcd->t_en_fall < t->th_ns) {
+      hd44780_violation(lcd, HD44780_TH, now - lcd->t_en_fall, t->th_ns);
+    }
+    lcd->db = (lcd->db & ~(1 << i)) | (level << i);
+    lcd->t_db = now;
+    return;
+  }
+}
+
+/**
+ * @brief  Pripojeni modelu k pinum (stav po vnitrnim resetu: 8bit, 1 radek, displej vypnut).
+ *
+ * @param  lcd  Model.
+ * @param  rs, rw, en, db4, db5, db6, db7 Piny (enum pin).
+ * @param  cols Pocet znaku na radek displeje.
+ * @param  rows Pocet radku displeje (1, 2 nebo 4).
+ */
+static inline void hd44780_attach(hd44780_t *lcd, int rs, int rw, int en, int db4, int db5, int db6, int db7,
+                                  int cols, int rows) {
+  memset(lcd, 0, sizeof(*lcd));
+  lcd->pin_rs = rs;
+  lcd->pin_rw = rw;
+  lcd->pin_en = en;
+  lcd->pin_db[0] = db4;
+  lcd->pin_db[1] = db5;
+  lcd->pin_db[2] = db6;
+  lcd->pin_db[3] = db7;
+  lcd->cols = cols;
+  lcd->rows = rows;
+  lcd->timing = HD44780_TIMING_5V;
+  lcd->increment = 1;
+  memset(lcd->ddram, ' ', sizeof(lcd->ddram));
+
+  sim_gpio_listen(hd44780_on_pin, lcd);
+}
+
+/**
+ * @brief  Znak na viditelne pozici displeje.
+ *
+ * @param  x Sloupec (od 0).
+ * @param  y Radek (od 0).
+ */
+static inline uint8_t hd44780_char_at(const hd44780_t *lcd, int x, int y) {
+  uint8_t addr;
+
+  if (lcd->two_lines) {
+    const int offset = ((y >> 1) * lcd->cols + x + lcd->shift) % 40;
+    addr = (uint8_t)((y & 1) * 0x40 + offset);
+  } else {
+    addr = (uint8_t)((y * lcd->cols + x + lcd->shift) % 80);
+  }
+  return lcd->ddram[addr];
+}
+
+/**
+ * @brief  Vykresleni viditelneho obsahu displeje jako text.
+ *         Uzivatelske znaky (CGRAM) se zobrazi jako '#', vypnuty displej jako prazdny.
+ */
+static inline void hd44780_print(const hd44780_t *lcd, FILE *out) {
+  fputc('+', out);
+  for (int x = 0; x < lcd->cols; x++) fputc('-', out);
+  fputs("+\n", out);
+
+  for (int y = 0; y < lcd->rows; y++) {
+    fputc('|', out);
+    for (int x = 0; x < lcd->cols; x++) {
+      const uint8_t c = hd44780_char_at(lcd, x, y);
+      fputc(!lcd->display_on ? ' ' : (c < 0x10) ? '#' : (c < 0x20 || c > 0x7E) ? '?' : c, out);
+    }
+    fputs("|\n", out);
+  }
+
+  fputc('+', out);
+  for (int x = 0; x < lcd->cols; x++) fputc('-', out);
+  fputs("+\n", out);
+}
+
+/**
+ * @brief  Souhrn provozu a poruseni casovani.
+ *
+ * @return Celkovy pocet poruseni.
+ */
+static inline uint32_t hd44780_report(const hd44780_t *lcd, FILE *out) {
+  uint32_t total = 0;
+
+  fprintf(out, "hd44780: %u prikazu, %u dat, %u zahozeno, cas %.3f ms\n",
+          lcd->commands, lcd->data, lcd->ignored, sim_now_ns() / 1e6);
+
+  for (int i = 0; i < HD44780_VIOLATIONS; i++) {
+    total += lcd->violations[i];
+    if (lcd->violations[i]) {
+      fprintf(out, "  %-6s %u poruseni\n", hd44780_violation_name[i], lcd->violations[i]);
+    }
+  }
+  if (total) {
+    fprintf(out, "  prvni: [%llu ns] %s\n", (unsigned long long)lcd->first_violation_ns, lcd->first_violation);
+  }
+
+  return total;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STM32_KIT_SIM_HD44780 */
@@ -0,0 +1,121 @@
+/**
+ * @file       quadrature.h
+ * @brief      Model inkrementalniho (kvadraturniho) enkoderu a casovace v rezimu enkoderu.
+ *
+ *             Model budi vstupy A a B (sim_gpio_input()) Grayovym kodem a zaroven
+ *             pocita hrany v pripojenem casovaci tak, jako hardware v rezimu enkoderu
+ *             (SMCR SMS = 001/010/011, CC1P obraci kanal A): CNT nahoru/dolu v rozsahu
+ *             0 - ARR, smer v CR1 DIR, pri preteceni/podteceni UIF a pri UIE obsluha
+ *             preruseni.
+ *
+ *             Kladny krok = A predbiha B (citac nahoru).
+ *
+ * @code
+ *     static sim_quadrature_t enc;
+ *     sim_quadrature_attach(&enc, TIM3, TIM3_IRQHandler, ENC_PIN_A, ENC_PIN_B);
+ *     ENC_setup();
+ *     sim_quadrature_step(&enc, -100, 10000);  // 100 hran dolu, hrana kazdych 10 us
+ * @endcode
+ *
+ * @author     Petr Madecki (petr.madecki@spsehavirov.cz)
+ * @author     Tomas Michalek (tomas.michalek@spsehavirov.cz)
+ *
+ * @date       2026-10-19
+ * @copyright  Copyright SPSE Havirov (c) 2026
+ */
+#ifndef STM32_KIT_SIM_QUADRATURE
+#define STM32_KIT_SIM_QUADRATURE
+
+#include "sim_device.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  TIM_TypeDef *tim;
+  void (*handler)(void);        // Obsluha preruseni casovace
+  int pin_a, pin_b;
+  uint8_t phase;                // Faze 0 - 3 (AB = 00, 10, 11, 01)
+  uint32_t edges;               // Celkovy pocet vygenerovanych hran
+} sim_quadrature_t;
+
+static const uint8_t sim_quadrature_ab[4] = { 0x0, 0x2, 0x3, 0x1 }; // Bit 1 = A, bit 0 = B
+
+/**
+ * @brief  Pripojeni modelu k casovaci a pinum, vstupy v log. 0.
+ */
+static inline void sim_quadrature_attach(sim_quadrature_t *q, TIM_TypeDef *tim, void (*handler)(void), int pin_a, int pin_b) {
+  q->tim = tim;
+  q->handler = handler;
+  q->pin_a = pin_a;
+  q->pin_b = pin_b;
+  q->phase = 0;
+  q->edges = 0;
+  sim_gpio_input(pin_a, 0);
+  sim_gpio_input(pin_b, 0);
+}
+
+/**
+ * @brief  Zpracovani jedne hrany casovacem v rezimu enkoderu.
+ *
+ * @param  changed_a Hrana na kanalu A (jinak na B).
+ * @param  a, b      Uroven kanalu po hrane (A uz obraceny dle CC1P).
+ */
+static inline void sim_quadrature_count(sim_quadrature_t *q, int changed_a, int a, int b) {
+  TIM_TypeDef *tim = q->tim;
+  const uint32_t sms = tim->SMCR & 7UL;
+
+  if (!(tim->CR1 & TIM_CR1_CEN) || sms < 1 || sms > 3) return;
+  if ((sms == 1 && !changed_a) || (sms == 2 && changed_a)) return; // x2: jen hrany jednoho kanalu
+
+  // Tabulka z referencni prirucky: hrana A nahoru pri A != B, hrana B nahoru pri A == B
+  const int up = changed_a ? (a != b) : (a == b);
+  int wrap;
+
+  if (up) {
+    wrap = tim->CNT >= tim->ARR;
+    tim->CNT = wrap ? 0 : tim->CNT + 1;
+    tim->CR1 &= ~TIM_CR1_DIR;
+  } else {
+    wrap = tim->CNT == 0;
+    tim->CNT = wrap ? tim->ARR : tim->CNT - 1;
+    tim->CR1 |= TIM_CR1_DIR;
+  }
+  if (!wrap) return;
+
+  tim->SR |= TIM_SR_UIF;
+  if ((tim->DIER & TIM_DIER_UIE) && q->handler && !sim_in_irq) {
+    sim_in_irq = 1;
+    q->handler();
+    sim_in_irq = 0;
+  }
+}
+
+/**
+ * @brief  Otoceni enkoderu o @p edges hran (zaporne = opacny smer).
+ *
+ * @param  edge_ns Virtualni cas mezi hranami.
+ */
+static inline void sim_quadrature_step(sim_quadrature_t *q, int32_t edges, uint64_t edge_ns) {
+  const int dir = (edges < 0) ? -1 : 1;
+
+  for (int32_t i = 0; i != edges; i += dir) {
+    const uint8_t old = sim_quadrature_ab[q->phase];
+    q->phase = (uint8_t)((q->phase + dir) & 3);
+    const uint8_t ab = sim_quadrature_ab[q->phase];
+    const int invert = (q->tim->CCER & (1UL << 1)) != 0;      // CC1P
+
+    sim_advance_ns(edge_ns);
+    sim_gpio_input(q->pin_a, (ab >> 1) & 1);
+    sim_gpio_input(q->pin_b, ab & 1);
+    q->edges++;
+    sim_quadrature_count(q, ((old ^ ab) & 2) != 0, ((ab >> 1) & 1) ^ invert, ab & 1);
+  }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STM32_KIT_SIM_QUADRATURE */
@@ -0,0 +1,542 @@
+/**
+ * @file       sim_device.h
+ * @brief      Nahrada CMSIS device headeru pro preklad kitu na PC (Linux).
+ *
+ *             Simuluje skolni pripravek STM32F407 (STM32_TYPE 407, piny z disc/f407.h):
+ *               - periferie lezi na skutecnych adresach (pamet se pri startu namapuje
+ *                 na 0x40000000), takze io_port(), pin_setup() apod. funguji beze zmeny,
+ *               - virtualni cas (sim_now_ns()), SysTick a zakladni casovace TIM6/TIM7,
+ *                 ktere volaji sve obsluhy preruseni (SysTick_Handler(), TIM7_IRQHandler(), ...),
+ *               - zapis do GPIOx->BSRR (WRITE_REG, tedy io_set()) zmeni ODR a oznami
+ *                 zmenu pinu pripojenym modelum (napr. hd44780.h),
+ *               - kazdy zapis pres WRITE_REG stoji sim_io_cycles taktu jadra,
+ *               - DMA prenasi z registru periferie do pameti na pozadavek modelu
+ *                 (sim_dma_request()), priznaky a preruseni DMA se nesimuluji.
+ *
+ *             Ostatni periferie (USART, ADC, ...) se nesimuluji, cekani na jejich
+ *             priznaky na PC skonci nekonecnou smyckou.
+ *
+ * @author     Petr Madecki (petr.madecki@spsehavirov.cz)
+ * @author     Tomas Michalek (tomas.michalek@spsehavirov.cz)
+ *
+ * @date       2026-10-19
+ * @copyright  Copyright SPSE Havirov (c) 2026
+ */
+#ifndef STM32_KIT_SIM_DEVICE
+#define STM32_KIT_SIM_DEVICE
+
+#define STM32_KIT_SIM
+#define STM32F4
+#define STM32F407xx
+#define __CORTEX_M (4U)
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define __IO volatile
+#define __I  volatile const
+#define __O  volatile
+
+//#============================================================================
+//#=== Pristup k registrum (jako stm32f4xx.h) - ZACATEK
+#define SET_BIT(REG, BIT)     ((REG) |= (BIT))
+#define CLEAR_BIT(REG, BIT)   ((REG) &= ~(BIT))
+#define READ_BIT(REG, BIT)    ((REG) & (BIT))
+#define CLEAR_REG(REG)        ((REG) = (0x0))
+#define WRITE_REG(REG, VAL)   sim_write_reg(&(REG), (VAL))
+#define READ_REG(REG)         ((REG))
+#define MODIFY_REG(REG, CLEARMASK, SETMASK)  ((REG) = (((READ_REG(REG)) & (~(CLEARMASK))) | (SETMASK)))
+//#=== Pristup k registrum (jako stm32f4xx.h) - KONEC
+//#============================================================================
+
+//#============================================================================
+//#=== Preruseni - ZACATEK
+typedef enum {
+  SysTick_IRQn        = -1,
+  DMA1_Stream0_IRQn   = 11,
+  DMA1_Stream1_IRQn   = 12,
+  DMA1_Stream2_IRQn   = 13,
+  DMA1_Stream3_IRQn   = 14,
+  DMA1_Stream4_IRQn   = 15,
+  DMA1_Stream5_IRQn   = 16,
+  DMA1_Stream6_IRQn   = 17,
+  TIM1_BRK_TIM9_IRQn  = 24,
+  TIM1_UP_TIM10_IRQn  = 25,
+  TIM1_TRG_COM_TIM11_IRQn = 26,
+  TIM1_CC_IRQn        = 27,
+  TIM2_IRQn           = 28,
+  TIM3_IRQn           = 29,
+  TIM4_IRQn           = 30,
+  USART2_IRQn         = 38,
+  DMA1_Stream7_IRQn   = 47,
+  TIM5_IRQn           = 50,
+  TIM6_DAC_IRQn       = 54,
+  TIM7_IRQn           = 55,
+  DMA2_Stream0_IRQn   = 56,
+  DMA2_Stream1_IRQn   = 57,
+  DMA2_Stream2_IRQn   = 58,
+  DMA2_Stream3_IRQn   = 59,
+  DMA2_Stream4_IRQn   = 60,
+  DMA2_Stream5_IRQn   = 68,
+  DMA2_Stream6_IRQn   = 69,
+  DMA2_Stream7_IRQn   = 70,
+} IRQn_Type;
+//#=== Preruseni - KONEC
+//#============================================================================
+
+//#============================================================================
+//#=== Registry periferii - ZACATEK
+typedef struct {
+  __IO uint32_t MODER, OTYPER, OSPEEDR, PUPDR, IDR, ODR, BSRR, LCKR, AFR[2];
+} GPIO_TypeDef;
+
+typedef struct {
+  __IO uint32_t CR, PLLCFGR, CFGR, CIR, AHB1RSTR, AHB2RSTR, AHB3RSTR;
+  uint32_t      RESERVED0;
+  __IO uint32_t APB1RSTR, APB2RSTR;
+  uint32_t      RESERVED1[2];
+  __IO uint32_t AHB1ENR, AHB2ENR, AHB3ENR;
+  uint32_t      RESERVED2;
+  __IO uint32_t APB1ENR, APB2ENR;
+} RCC_TypeDef;
+
+typedef struct {
+  __IO uint32_t CR1, CR2, SMCR, DIER, SR, EGR, CCMR1, CCMR2, CCER, CNT, PSC, ARR, RCR,
+                CCR1, CCR2, CCR3, CCR4, BDTR, DCR, DMAR, OR;
+} TIM_TypeDef;
+
+typedef struct {
+  __IO uint32_t SR, DR, BRR, CR1, CR2, CR3, GTPR;
+} USART_TypeDef;
+
+typedef struct {
+  __IO uint32_t SR, CR1, CR2, SMPR1, SMPR2, JOFR1, JOFR2, JOFR3, JOFR4, HTR, LTR,
+                SQR1, SQR2, SQR3, JSQR, JDR1, JDR2, JDR3, JDR4, DR;
+} ADC_TypeDef;
+
+typedef struct {
+  __IO uint32_t LISR, HISR, LIFCR, HIFCR;
+} DMA_TypeDef;
+
+typedef struct {
+  __IO uint32_t CR, NDTR, PAR, M0AR, M1AR, FCR;
+} DMA_Stream_TypeDef;
+
+#define PERIPH_BASE       0x40000000UL
+#define APB1PERIPH_BASE   PERIPH_BASE
+#define APB2PERIPH_BASE   (PERIPH_BASE + 0x00010000UL)
+#define AHB1PERIPH_BASE   (PERIPH_BASE + 0x00020000UL)
+
+#define TIM2_BASE         (APB1PERIPH_BASE + 0x0000UL)
+#define TIM3_BASE         (APB1PERIPH_BASE + 0x0400UL)
+#define TIM4_BASE         (APB1PERIPH_BASE + 0x0800UL)
+#define TIM5_BASE         (APB1PERIPH_BASE + 0x0C00UL)
+#define TIM6_BASE         (APB1PERIPH_BASE + 0x1000UL)
+#define TIM7_BASE         (APB1PERIPH_BASE + 0x1400UL)
+#define USART2_BASE       (APB1PERIPH_BASE + 0x4400UL)
+#define TIM1_BASE         (APB2PERIPH_BASE + 0x0000UL)
+#define ADC1_BASE         (APB2PERIPH_BASE + 0x2000UL)
+#define GPIOA_BASE        (AHB1PERIPH_BASE + 0x0000UL)
+#define GPIOB_BASE        (AHB1PERIPH_BASE + 0x0400UL)
+#define GPIOC_BASE        (AHB1PERIPH_BASE + 0x0800UL)
+#define GPIOD_BASE        (AHB1PERIPH_BASE + 0x0C00UL)
+#define GPIOE_BASE        (AHB1PERIPH_BASE + 0x1000UL)
+#define RCC_BASE          (AHB1PERIPH_BASE + 0x3800UL)
+#define DMA1_BASE         (AHB1PERIPH_BASE + 0x6000UL)
+#define DMA2_BASE         (AHB1PERIPH_BASE + 0x6400UL)
+
+#define TIM1              ((TIM_TypeDef *) TIM1_BASE)
+#define TIM2              ((TIM_TypeDef *) TIM2_BASE)
+#define TIM3              ((TIM_TypeDef *) TIM3_BASE)
+#define TIM4              ((TIM_TypeDef *) TIM4_BASE)
+#define TIM5              ((TIM_TypeDef *) TIM5_BASE)
+#define TIM6              ((TIM_TypeDef *) TIM6_BASE)
+#define TIM7              ((TIM_TypeDef *) TIM7_BASE)
+#define USART2            ((USART_TypeDef *) USART2_BASE)
+#define ADC1              ((ADC_TypeDef *) ADC1_BASE)
+#define GPIOA             ((GPIO_TypeDef *) GPIOA_BASE)
+#define GPIOB             ((GPIO_TypeDef *) GPIOB_BASE)
+#define GPIOC             ((GPIO_TypeDef *) GPIOC_BASE)
+#define GPIOD             ((GPIO_TypeDef *) GPIOD_BASE)
+#define GPIOE             ((GPIO_TypeDef *) GPIOE_BASE)
+#define RCC               ((RCC_TypeDef *) RCC_BASE)
+#define DMA1              ((DMA_TypeDef *) DMA1_BASE)
+#define DMA2              ((DMA_TypeDef *) DMA2_BASE)
+
+#define SIM_DMA_STREAM(base, s) ((DMA_Stream_TypeDef *) ((base) + 0x10UL + 0x18UL * (s)))
+#define DMA1_Stream0      SIM_DMA_STREAM(DMA1_BASE, 0)
+#define DMA1_Stream1      SIM_DMA_STREAM(DMA1_BASE, 1)
+#define DMA1_Stream2      SIM_DMA_STREAM(DMA1_BASE, 2)
+#define DMA1_Stream3      SIM_DMA_STREAM(DMA1_BASE, 3)
+#define DMA1_Stream4      SIM_DMA_STREAM(DMA1_BASE, 4)
+#define DMA1_Stream5      SIM_DMA_STREAM(DMA1_BASE, 5)
+#define DMA1_Stream6      SIM_DMA_STREAM(DMA1_BASE, 6)
+#define DMA1_Stream7      SIM_DMA_STREAM(DMA1_BASE, 7)
+#define DMA2_Stream0      SIM_DMA_STREAM(DMA2_BASE, 0)
+#define DMA2_Stream1      SIM_DMA_STREAM(DMA2_BASE, 1)
+#define DMA2_Stream2      SIM_DMA_STREAM(DMA2_BASE, 2)
+#define DMA2_Stream3      SIM_DMA_STREAM(DMA2_BASE, 3)
+#define DMA2_Stream4      SIM_DMA_STREAM(DMA2_BASE, 4)
+#define DMA2_Stream5      SIM_DMA_STREAM(DMA2_BASE, 5)
+#define DMA2_Stream6      SIM_DMA_STREAM(DMA2_BASE, 6)
+#define DMA2_Stream7      SIM_DMA_STREAM(DMA2_BASE, 7)
+
+#define SIM_PERIPH_BASE   PERIPH_BASE    // Mapovana oblast: APB1, APB2 a AHB1
+#define SIM_PERIPH_SIZE   0x00080000UL
+#define SIM_GPIO_PORTS    9              // GPIOA - GPIOI
+//#=== Registry periferii - KONEC
+//#============================================================================
+
+//#============================================================================
+//#=== Bitove definice (podmnozina stm32f407xx.h) - ZACATEK
+#define RCC_APB1RSTR_TIM6RST  (1UL << 4)
+#define RCC_APB1RSTR_TIM7RST  (1UL << 5)
+#define RCC_APB1ENR_TIM2EN    (1UL << 0)
+#define RCC_APB1ENR_TIM3EN    (1UL << 1)
+#define RCC_APB1ENR_TIM4EN    (1UL << 2)
+#define RCC_APB1ENR_TIM5EN    (1UL << 3)
+#define RCC_APB1ENR_TIM6EN    (1UL << 4)
+#define RCC_APB1ENR_TIM7EN    (1UL << 5)
+#define RCC_APB2ENR_TIM1EN    (1UL << 0)
+#define RCC_CFGR_PPRE1_Pos    10
+#define RCC_CFGR_PPRE1        (7UL << RCC_CFGR_PPRE1_Pos)
+#define RCC_CFGR_PPRE2_Pos    13
+#define RCC_CFGR_PPRE2        (7UL << RCC_CFGR_PPRE2_Pos)
+#define RCC_APB1ENR_USART2EN  (1UL << 17)
+#define RCC_AHB1ENR_DMA1EN_Pos 21
+#define RCC_AHB1ENR_DMA2EN_Pos 22
+
+#define TIM_CR1_CEN           (1UL << 0)
+#define TIM_CR1_URS           (1UL << 2)
+#define TIM_CR1_OPM           (1UL << 3)
+#define TIM_CR1_DIR           (1UL << 4)
+#define TIM_CR1_ARPE          (1UL << 7)
+#define TIM_CR2_MMS           (7UL << 4)
+#define TIM_CR2_MMS_1         (2UL << 4)
+#define TIM_DIER_UIE          (1UL << 0)
+#define TIM_DIER_CC1DE        (1UL << 9)
+#define TIM_DIER_CC2DE        (1UL << 10)
+#define TIM_SR_UIF            (1UL << 0)
+#define TIM_SR_CC1IF          (1UL << 1)
+#define TIM_SR_CC2IF          (1UL << 2)
+#define TIM_EGR_UG            (1UL << 0)
+#define TIM_BDTR_MOE          (1UL << 15)
+
+#define USART_SR_RXNE         (1UL << 5)
+#define USART_SR_TC           (1UL << 6)
+#define USART_SR_TXE          (1UL << 7)
+#define USART_CR1_RE          (1UL << 2)
+#define USART_CR1_TE          (1UL << 3)
+#define USART_CR1_UE          (1UL << 13)
+
+#define ADC_SR_EOC            (1UL << 1)
+#define ADC_CR2_SWSTART       (1UL << 30)
+
+#define DMA_SxCR_EN           (1UL << 0)
+#define DMA_SxCR_TEIE         (1UL << 2)
+#define DMA_SxCR_HTIE         (1UL << 3)
+#define DMA_SxCR_TCIE         (1UL << 4)
+#define DMA_SxCR_DIR_0        (1UL << 6)
+#define DMA_SxCR_DIR_1        (1UL << 7)
+#define DMA_SxCR_CIRC         (1UL << 8)
+#define DMA_SxCR_PINC         (1UL << 9)
+#define DMA_SxCR_MINC         (1UL << 10)
+#define DMA_SxCR_PSIZE_Pos    11
+#define DMA_SxCR_MSIZE_Pos    13
+#define DMA_SxCR_PL_1         (1UL << 17)
+#define DMA_SxCR_DBM          (1UL << 18)
+#define DMA_SxCR_CT           (1UL << 19)
+#define DMA_SxCR_CHSEL_Pos    25
+#define DMA_SxFCR_DMDIS       (1UL << 2)
+//#=== Bitove definice (podmnozina stm32f407xx.h) - KONEC
+//#============================================================================
+
+//#============================================================================
+//#=== Virtualni cas, SysTick a zakladni casovace - ZACATEK
+uint32_t SystemCoreClock = 16000000UL;     // HSI po resetu
+
+static uint64_t sim_time_ns;               // Virtualni cas od startu
+static uint64_t sim_systick_period_ns;     // 0 = SysTick nebezi
+static uint64_t sim_systick_next_ns;
+static uint32_t sim_io_cycles = 3;         // Cena jednoho zapisu WRITE_REG v taktech jadra
+static int      sim_in_irq;                // Behem obsluhy preruseni se dalsi preruseni nevolaji
+
+void SysTick_Handler(void);
+void TIM6_DAC_IRQHandler(void) __attribute__((weak)); // Obsluhy definuje aplikace/kit (nemusi existovat)
+void TIM7_IRQHandler(void) __attribute__((weak));
+
+/**
+ * @brief Zakladni casovac (TIM6, TIM7): preteceni nastavi UIF a pri UIE vola obsluhu.
+ */
+static struct {
+  TIM_TypeDef *tim;
+  void (*handler)(void);
+  int running;
+  uint64_t next_ns;
+} sim_timers[] = {
+  { TIM6, TIM6_DAC_IRQHandler, 0, 0 },
+  { TIM7, TIM7_IRQHandler,     0, 0 },
+};
+#define SIM_TIMERS (sizeof(sim_timers) / sizeof(sim_timers[0]))
+
+/**
+ * @brief  Aktualni virtualni cas v ns.
+ */
+static inline uint64_t sim_now_ns(void) {
+  return sim_time_ns;
+}
+
+/**
+ * @brief  Prevod taktu jadra na ns.
+ */
+static inline uint64_t sim_cycles_ns(uint64_t cycles) {
+  return cycles * 1000000000ULL / SystemCoreClock;
+}
+
+/**
+ * @brief  Zjisteni spusteni/zastaveni casovacu (CEN) a cas jejich pristi udalosti.
+ *
+ * @return Cas nejblizsi udalosti (SysTick nebo preteceni casovace), UINT64_MAX pokud neni zadna.
+ */
+static inline uint64_t sim_next_event_ns(void) {
+  uint64_t next = sim_systick_period_ns ? sim_systick_next_ns : UINT64_MAX;
+
+  for (unsigned i = 0; i < SIM_TIMERS; i++) {
+    TIM_TypeDef *tim = sim_timers[i].tim;
+    const int enabled = (tim->CR1 & TIM_CR1_CEN) != 0;
+
+    if (enabled && !sim_timers[i].running) {
+      sim_timers[i].next_ns = sim_time_ns + sim_cycles_ns((uint64_t)(tim->PSC + 1) * (tim->ARR + 1));
+    }
+    sim_timers[i].running = enabled;
+    if (enabled && sim_timers[i].next_ns < next) next = sim_timers[i].next_ns;
+  }
+  return next;
+}
+
+/**
+ * @brief  Posun virtualniho casu, behem ktereho se volaji preruseni (SysTick, TIM6, TIM7).
+ */
+static inline void sim_advance_ns(uint64_t ns) {
+  const uint64_t target = sim_time_ns + ns;
+
+  while (!sim_in_irq) {
+    const uint64_t next = sim_next_event_ns();
+    if (next > target) break;
+
+    if (next > sim_time_ns) sim_time_ns = next;
+    sim_in_irq = 1;
+    if (sim_systick_period_ns && sim_systick_next_ns == next) {
+      sim_systick_next_ns += sim_systick_period_ns;
+      SysTick_Handler();
+    }
+    for (unsigned i = 0; i < SIM_TIMERS; i++) {
+      TIM_TypeDef *tim = sim_timers[i].tim;
+      if (!sim_timers[i].running || sim_timers[i].next_ns != next) continue;
+
+      sim_timers[i].next_ns += sim_cycles_ns((uint64_t)(tim->PSC + 1) * (tim->ARR + 1));
+      tim->SR |= TIM_SR_UIF;
+      if (tim->CR1 & TIM_CR1_OPM) tim->CR1 &= ~TIM_CR1_CEN; // Jednorazovy rezim zastavi casovac
+      if ((tim->DIER & TIM_DIER_UIE) && sim_timers[i].handler) sim_timers[i].handler();
+    }
+    sim_in_irq = 0;
+  }
+  if (target > sim_time_ns) sim_time_ns = target;
+}
+
+/**
+ * @brief  Aktivni cekani - posun casu na dalsi udalost (preruseni).
+ */
+static inline void sim_idle(void) {
+  const uint64_t next = sim_next_event_ns();
+
+  if (sim_in_irq) {
+    fprintf(stderr, "sim: aktivni cekani v obsluze preruseni\n");
+    exit(2);
+  }
+  if (next == UINT64_MAX) {
+    fprintf(stderr, "sim: aktivni cekani, ale nebezi SysTick ani casovac\n");
+    exit(2);
+  }
+  sim_advance_ns(next > sim_time_ns ? next - sim_time_ns : 0);
+}
+
+static inline uint32_t SysTick_Config(uint32_t ticks) {
+  sim_systick_period_ns = sim_cycles_ns(ticks);
+  sim_systick_next_ns = sim_time_ns + sim_systick_period_ns;
+  return 0;
+}
+
+static inline void SystemCoreClockUpdate(void) { /* HSI 16MHz, PLL se nesimuluje */ }
+static inline void __NOP(void) { sim_advance_ns(sim_cycles_ns(1)); }
+static inline void __DSB(void) {}
+static inline void __ISB(void) {}
+static inline void __disable_irq(void) {}
+static inline void __enable_irq(void) {}
+static inline uint32_t __get_PRIMASK(void) { return 0; }
+static inline void __set_PRIMASK(uint32_t mask) { (void)mask; }
+static inline void NVIC_EnableIRQ(IRQn_Type irq) { (void)irq; }
+static inline void NVIC_DisableIRQ(IRQn_Type irq) { (void)irq; }
+static inline void NVIC_ClearPendingIRQ(IRQn_Type irq) { (void)irq; }
+static inline void NVIC_SetPriority(IRQn_Type irq, uint32_t prio) { (void)irq; (void)prio; }
+
+// Aktivni cekani v chrono.h posouva virtualni cas
+#define CHRONO_IDLE() sim_idle()
+//#=== Virtualni cas, SysTick a zakladni casovace - KONEC
+//#============================================================================
+
+//#============================================================================
+//#=== GPIO - ZACATEK
+
+/**
+ * @brief Posluchac zmen vystupnich pinu (pin ve stejnem kodovani jako enum pin).
+ */
+typedef void (*sim_pin_listener_t)(void *ctx, int pin, int level);
+
+#define SIM_LISTENERS 8
+
+static struct {
+  sim_pin_listener_t fn;
+  void *ctx;
+} sim_listeners[SIM_LISTENERS];
+
+static uint16_t sim_gpio_inputs[SIM_GPIO_PORTS]; // Uroven vstupu buzenych zvenku (sim_gpio_input)
+
+/**
+ * @brief  Registrace posluchace zmen vystupnich pinu.
+ *
+ * @return 0 pri uspechu, -1 pokud neni misto.
+ */
+static inline int sim_gpio_listen(sim_pin_listener_t fn, void *ctx) {
+  for (int i = 0; i < SIM_LISTENERS; i++) {
+    if (!sim_listeners[i].fn) {
+      sim_listeners[i].fn = fn;
+      sim_listeners[i].ctx = ctx;
+      return 0;
+    }
+  }
+  return -1;
+}
+
+/**
+ * @brief  Prepocet IDR: vystupni piny ctou ODR, ostatni uroven buzenou zvenku.
+ */
+static inline void sim_gpio_sync(int port) {
+  GPIO_TypeDef *gpio = (GPIO_TypeDef *)(GPIOA_BASE + port * (GPIOB_BASE - GPIOA_BASE));
+  uint32_t outputs = 0;
+
+  for (int i = 0; i < 16; i++) {
+    if (((gpio->MODER >> (2 * i)) & 3UL) == 1UL) outputs |= 1UL << i;
+  }
+  gpio->IDR = (gpio->ODR & outputs) | (sim_gpio_inputs[port] & ~outputs);
+}
+
+/**
+ * @brief  Nastaveni urovne vstupniho pinu zvenku (tlacitko, klavesnice, ...).
+ */
+static inline void sim_gpio_input(int pin, int level) {
+  const int port = (pin >> 4) & 0x0F;
+
+  if (level) sim_gpio_inputs[port] |=  (1U << (pin & 0x0F));
+  else       sim_gpio_inputs[port] &= ~(1U << (pin & 0x0F));
+  sim_gpio_sync(port);
+}
+
+/**
+ * @brief  Zapis registru s vedlejsimi ucinky (BSRR -> ODR a oznameni posluchacum).
+ */
+static inline void sim_write_reg(volatile uint32_t *reg, uint32_t value) {
+  const uintptr_t addr = (uintptr_t)reg;
+
+  sim_advance_ns(sim_cycles_ns(sim_io_cycles));
+  *reg = value;
+
+  if (addr < GPIOA_BASE || addr >= GPIOA_BASE + SIM_GPIO_PORTS * (GPIOB_BASE - GPIOA_BASE)) return;
+  if ((addr & 0x3FFUL) != 0x18UL) return; // Pouze BSRR
+
+  const int port = (int)((addr - GPIOA_BASE) / (GPIOB_BASE - GPIOA_BASE));
+  GPIO_TypeDef *gpio = (GPIO_TypeDef *)(addr - 0x18UL);
+  const uint32_t old = gpio->ODR;
+  const uint32_t odr = ((old & ~(value >> 16)) | value) & 0xFFFFUL; // SET ma prednost pred RESET
+
+  gpio->ODR = odr;
+  gpio->BSRR = 0;                         // BSRR je pouze pro zapis
+  sim_gpio_sync(port);
+
+  for (int i = 0; i < 16; i++) {
+    if (!((old ^ odr) & (1UL << i))) continue;
+    for (int l = 0; l < SIM_LISTENERS && sim_listeners[l].fn; l++) {
+      sim_listeners[l].fn(sim_listeners[l].ctx, (port << 4) | i, (odr >> i) & 1);
+    }
+  }
+}
+//#=== GPIO - KONEC
+//#============================================================================
+
+//#============================================================================
+//#=== DMA - ZACATEK
+static struct {
+  uint32_t count;                         // Naprogramovana delka prenosu (obnova v kruhovem rezimu)
+  uint32_t left;                          // NDTR po poslednim prenosu modelu
+} sim_dma_state[16];
+
+/**
+ * @brief  Pozadavek periferie na DMA: zapnuty stream s PAR = @p reg a smerem periferie -> pamet
+ *         prenese jeden prvek (MSIZE) do pameti, v kruhovem rezimu pokracuje od zacatku.
+ *         Adresy v pameti jsou 32bit (M0AR), program musi byt prelozen s -no-pie.
+ *
+ * @return 1 = prenos probehl, 0 = zadny stream neceka na pozadavek.
+ */
+static inline int sim_dma_request(volatile uint32_t *reg) {
+  for (int i = 0; i < 16; i++) {
+    DMA_Stream_TypeDef *s = SIM_DMA_STREAM((i < 8) ? DMA1_BASE : DMA2_BASE, i & 7);
+    if (!(s->CR & DMA_SxCR_EN) || (s->CR & (DMA_SxCR_DIR_0 | DMA_SxCR_DIR_1))) continue;
+    if (s->PAR != (uint32_t)(uintptr_t)reg || !s->NDTR) continue;
+
+    if (s->NDTR != sim_dma_state[i].left) sim_dma_state[i].count = s->NDTR; // Stream znovu naprogramovan
+    const uint32_t size = 1UL << ((s->CR >> DMA_SxCR_MSIZE_Pos) & 3UL);
+    const uint32_t index = (s->CR & DMA_SxCR_MINC) ? sim_dma_state[i].count - s->NDTR : 0;
+    uint8_t *mem = (uint8_t *)(uintptr_t)s->M0AR + index * size;
+    const uint32_t value = *reg;
+
+    for (uint32_t b = 0; b < size; b++) mem[b] = (uint8_t)(value >> (8 * b)); // Little endian jako MCU
+    if (--s->NDTR == 0) {
+      if (s->CR & DMA_SxCR_CIRC) s->NDTR = sim_dma_state[i].count;
+      else s->CR &= ~DMA_SxCR_EN;
+    }
+    sim_dma_state[i].left = s->NDTR;
+    return 1;
+  }
+  return 0;
+}
+//#=== DMA - KONEC
+//#============================================================================
+
+/**
+ * @brief  Namapovani pameti periferii na jejich skutecne adrese (pred BOARD_SETUP).
+ */
+__attribute__((constructor(101))) static void sim_init(void) {
+#ifdef MAP_FIXED_NOREPLACE
+  const int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE;
+#else
+  const int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED;
+#endif
+  void *mem = mmap((void *)SIM_PERIPH_BASE, SIM_PERIPH_SIZE, PROT_READ | PROT_WRITE, flags, -1, 0);
+
+  if (mem != (void *)SIM_PERIPH_BASE) {
+    perror("sim: nelze namapovat periferie na 0x40000000");
+    exit(2);
+  }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STM32_KIT_SIM_DEVICE */
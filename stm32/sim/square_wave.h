@@ -0,0 +1,171 @@
+/**
+ * @file       square_wave.h
+ * @brief      Model obdelnikoveho signalu na vstupu casovace v rezimu input capture.
+ *
+ *             Model budi vstupni pin (sim_gpio_input()) a zaroven pocita citac
+ *             casovace podle virtualniho casu (PSC + 1 taktu SystemCoreClock na tik,
+ *             citac bezi od nuly od spusteni CEN). Hrana na vstupu TI1 zachyti CNT
+ *             do CCR1/CCR2 (CCxS = TI1, polarita CCxP), nastavi CCxIF a pri CCxDE
+ *             posle pozadavek DMA (sim_dma_request()). Preteceni nastavi UIF a pri UIE
+ *             vola obsluhu preruseni.
+ *
+ *             Citac se aktualizuje jen v sim_square_run() a sim_square_wait().
+ *
+ * @code
+ *     static sim_square_t wave;
+ *     sim_square_attach(&wave, TIM2, TIM2_IRQHandler, CAP_PIN);
+ *     CAP_start();
+ *     sim_square_run(&wave, 1000000, 250000, 10); // 10 period 1 kHz, strida 25 %
+ * @endcode
+ *
+ * @author     Petr Madecki (petr.madecki@spsehavirov.cz)
+ * @author     Tomas Michalek (tomas.michalek@spsehavirov.cz)
+ *
+ * @date       2026-10-19
+ * @copyright  Copyright SPSE Havirov (c) 2026
+ */
+#ifndef STM32_KIT_SIM_SQUARE_WAVE
+#define STM32_KIT_SIM_SQUARE_WAVE
+
+#include "sim_device.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  TIM_TypeDef *tim;
+  void (*handler)(void);        // Obsluha preruseni casovace
+  int pin;
+  int level;                    // Uroven vstupu
+  int running;                  // Citac bezi (CEN)
+  uint64_t origin_ns;           // Virtualni cas spusteni citace (CNT = 0)
+  uint64_t updates;             // Preteceni od spusteni (oznamena obsluze)
+  uint64_t rise_ticks;          // Cas posledni nabezne hrany v tikach citace od spusteni
+  uint32_t edges;               // Celkovy pocet hran
+} sim_square_t;
+
+/**
+ * @brief  Pripojeni modelu k casovaci a vstupnimu pinu, vstup v log. 0.
+ */
+static inline void sim_square_attach(sim_square_t *w, TIM_TypeDef *tim, void (*handler)(void), int pin) {
+  w->tim = tim;
+  w->handler = handler;
+  w->pin = pin;
+  w->level = 0;
+  w->running = 0;
+  w->updates = 0;
+  w->rise_ticks = 0;
+  w->edges = 0;
+  sim_gpio_input(pin, 0);
+}
+
+/**
+ * @brief  Virtualni cas, kdy citac dosahne @p ticks tiku od spusteni.
+ */
+static inline uint64_t sim_square_time_ns(const sim_square_t *w, uint64_t ticks) {
+  const unsigned __int128 cycles = (unsigned __int128)ticks * (w->tim->PSC + 1);
+  return w->origin_ns + (uint64_t)((cycles * 1000000000ULL + SystemCoreClock - 1) / SystemCoreClock);
+}
+
+/**
+ * @brief  Pocet tiku citace od spusteni do aktualniho virtualniho casu.
+ */
+static inline uint64_t sim_square_ticks(const sim_square_t *w) {
+  const unsigned __int128 ns = sim_now_ns() - w->origin_ns;
+  return (uint64_t)(ns * SystemCoreClock / 1000000000ULL / (w->tim->PSC + 1));
+}
+
+/**
+ * @brief  Aktualizace citace: spusteni/zastaveni (CEN), CNT a preteceni (UIF, obsluha).
+ */
+static inline void sim_square_sync(sim_square_t *w) {
+  TIM_TypeDef *tim = w->tim;
+
+  if (!(tim->CR1 & TIM_CR1_CEN)) {
+    w->running = 0;
+    return;
+  }
+  if (!w->running) {
+    w->running = 1;
+    w->origin_ns = sim_now_ns();
+    w->updates = 0;
+  }
+
+  const uint64_t ticks = sim_square_ticks(w);
+  const uint64_t period = (uint64_t)tim->ARR + 1;
+  while (w->updates < ticks / period) {
+    w->updates++;
+    tim->SR |= TIM_SR_UIF;
+    if ((tim->DIER & TIM_DIER_UIE) && w->handler && !sim_in_irq) {
+      sim_in_irq = 1;
+      w->handler();
+      sim_in_irq = 0;
+    }
+  }
+  tim->CNT = (uint32_t)(ticks % period);
+}
+
+/**
+ * @brief  Posun virtualniho casu o @p ns, preteceni citace se obsluhuji v case, kdy nastanou.
+ */
+static inline void sim_square_wait(sim_square_t *w, uint64_t ns) {
+  const uint64_t target = sim_now_ns() + ns;
+
+  sim_square_sync(w);
+  while (w->running) {
+    const uint64_t next = sim_square_time_ns(w, (w->updates + 1) * ((uint64_t)w->tim->ARR + 1));
+    if (next > target) break;
+    if (next > sim_now_ns()) sim_advance_ns(next - sim_now_ns());
+    sim_square_sync(w);
+  }
+  if (target > sim_now_ns()) sim_advance_ns(target - sim_now_ns());
+  sim_square_sync(w);
+}
+
+/**
+ * @brief  Zmena urovne vstupu: zachyceni CNT do kanalu 1 a 2 (vstup TI1) podle polarity.
+ */
+static inline void sim_square_edge(sim_square_t *w, int level) {
+  TIM_TypeDef *tim = w->tim;
+
+  sim_square_sync(w);
+  sim_gpio_input(w->pin, level);
+  w->level = level;
+  w->edges++;
+  if (level && w->running) w->rise_ticks = sim_square_ticks(w);
+  if (!w->running) return;
+
+  for (int ch = 0; ch < 2; ch++) {
+    const uint32_t ccs = (tim->CCMR1 >> (8 * ch)) & 3UL;        // CC1S = 01 / CC2S = 10: vstup TI1
+    const uint32_t ccer = tim->CCER >> (4 * ch);
+    if (ccs != (ch ? 2UL : 1UL) || !(ccer & 1UL)) continue;     // Kanal neni capture z TI1 nebo je vypnuty
+    if (((ccer >> 1) & 1UL) == (uint32_t)level) continue;       // CCxP = 1: sestupna hrana
+
+    volatile uint32_t *ccr = ch ? &tim->CCR2 : &tim->CCR1;
+    *ccr = tim->CNT;
+    tim->SR |= ch ? TIM_SR_CC2IF : TIM_SR_CC1IF;
+    if (tim->DIER & (ch ? TIM_DIER_CC2DE : TIM_DIER_CC1DE)) sim_dma_request(ccr);
+  }
+}
+
+/**
+ * @brief  Generovani @p count period signalu (nabezna hrana, po @p high_ns sestupna).
+ *
+ * @param  period_ns Perioda signalu.
+ * @param  high_ns   Doba v log. 1 (0 < high_ns < period_ns).
+ */
+static inline void sim_square_run(sim_square_t *w, uint64_t period_ns, uint64_t high_ns, uint32_t count) {
+  for (uint32_t i = 0; i < count; i++) {
+    sim_square_edge(w, 1);
+    sim_square_wait(w, high_ns);
+    sim_square_edge(w, 0);
+    sim_square_wait(w, period_ns - high_ns);
+  }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STM32_KIT_SIM_SQUARE_WAVE */
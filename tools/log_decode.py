@@ -0,0 +1,245 @@
+#!/usr/bin/env python3
+"""Dekoder binarniho logu (stm32/include/stm32_kit/log.h).
+
+Cte ramce packet.h (COBS + CRC-32) ze seriove linky nebo ze souboru, zaznamy
+[adresa retezce][pocet argumentu << 28 | Ticks][argumenty...] sklada do textu
+podle formatovacich retezcu nactenych ze sekce .logfmt v ELF (.axf/.elf).
+ELF musi byt ten, ktery bezi v MCU - jinak adresy retezcu nesedi.
+
+  python3 tools/log_decode.py build/app.axf --port COM3 --baud 115200
+  python3 tools/log_decode.py build/app.axf zaznam.bin
+  python3 tools/log_decode.py build/app.axf --list
+
+Seriova linka vyzaduje pyserial (pip install pyserial), jinak jen standardni knihovna.
+"""
+import argparse
+import re
+import struct
+import sys
+import zlib
+
+SHF_ALLOC = 0x2
+SHT_NOBITS = 8
+TIME_BITS = 28
+
+SPEC = re.compile(r"%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d*))?(hh|h|ll|l|j|z|t|L)?([diouxXeEfFgGaAcspn%])")
+
+
+class Elf:
+    """Sekce ELF (32 i 64 bit, little endian) - jen to, co je potreba pro retezce."""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            data = f.read()
+        if data[:4] != b"\x7fELF" or data[5] != 1:
+            raise ValueError(f"{path}: neni ELF little endian")
+
+        if data[4] == 1:
+            shoff, = struct.unpack_from("<I", data, 0x20)
+            shentsize, shnum, shstrndx = struct.unpack_from("<HHH", data, 0x2E)
+            fmt = "<IIIIIIIIII"
+        else:
+            shoff, = struct.unpack_from("<Q", data, 0x28)
+            shentsize, shnum, shstrndx = struct.unpack_from("<HHH", data, 0x3A)
+            fmt = "<IIQQQQIIQQ"
+
+        headers = [struct.unpack_from(fmt, data, shoff + i * shentsize) for i in range(shnum)]
+        names = headers[shstrndx]
+
+        self.sections = {}
+        for name, kind, flags, addr, offset, size, *_ in headers:
+            end = data.index(b"\0", names[4] + name)
+            title = data[names[4] + name:end].decode("ascii", "replace")
+            content = b"" if kind == SHT_NOBITS else data[offset:offset + size]
+            self.sections[title] = (addr, content, flags)
+
+    def string(self, addr, section=None):
+        """Retezec ukonceny nulou na adrese, None = adresa mimo data v ELF."""
+        for title, (start, content, flags) in self.sections.items():
+            if section and title != section:
+                continue
+            if not flags & SHF_ALLOC or not start <= addr < start + len(content):
+                continue
+            pos = addr - start
+            end = content.find(b"\0", pos)
+            return content[pos:end if end >= 0 else len(content)].decode("utf-8", "replace")
+        return None
+
+    def formats(self):
+        """Vsechny formatovaci retezce (adresa, text) ze sekce .logfmt."""
+        start, content, _ = self.sections.get(".logfmt", (0, b"", 0))
+        pos = 0
+        while pos < len(content):
+            end = content.find(b"\0", pos)
+            end = len(content) if end < 0 else end
+            if end > pos:
+                yield start + pos, content[pos:end].decode("utf-8", "replace")
+            pos = end + 1
+
+
+def cobs_decode(frame):
+    out = bytearray()
+    pos = 0
+    while pos < len(frame):
+        code = frame[pos]
+        if not code or pos + code > len(frame):
+            return None
+        out += frame[pos + 1:pos + code]
+        pos += code
+        if code < 0xFF and pos < len(frame):
+            out.append(0)
+    return bytes(out)
+
+
+def render(fmt, args, elf):
+    """printf na PC: 32bit argumenty podle konverzi ve formatu."""
+    args = list(args)
+
+    def take():
+        return args.pop(0) if args else None
+
+    def convert(m):
+        flags, width, prec, _, conv = m.groups()
+        if conv == "%":
+            return "%"
+        if width == "*":
+            width = str(struct.unpack("<i", struct.pack("<I", take() or 0))[0])
+        if prec == "*":
+            prec = str(take() or 0)
+        value = take()
+        if value is None:
+            return "<?>"
+        if conv == "n":
+            return ""
+
+        if conv in "di":
+            value = struct.unpack("<i", struct.pack("<I", value))[0]
+            conv = "d"
+        elif conv in "eEfFgGaA":
+            value = struct.unpack("<f", struct.pack("<I", value))[0]
+            conv = {"a": "g", "A": "G"}.get(conv, conv)
+        elif conv == "c":
+            value = chr(value & 0xFF)
+        elif conv == "s":
+            text = elf.string(value)
+            value = text if text is not None else f"<0x{value:08X}>"
+        elif conv == "p":
+            value, conv, flags, prec = f"0x{value:08X}", "s", flags.replace("#", ""), None
+
+        spec = "%" + flags + (width or "") + ("." + prec if prec is not None else "") + conv
+        return spec % value
+
+    text = SPEC.sub(convert, fmt)
+    if args:
+        text += " [+" + " ".join(f"0x{a:08X}" for a in args) + "]"
+    return text
+
+
+class Decoder:
+    def __init__(self, elf, tick_hz):
+        self.elf = elf
+        self.tick_hz = tick_hz
+        self.formats = dict(elf.formats())
+        self.time = None                    # Cas posledniho zaznamu v tickach (s pretecenim)
+        self.frames = self.errors = 0
+
+    def timestamp(self, ticks):
+        """Cas v s. Rozdil proti predchozimu zaznamu se bere se znamenkem (28 bitu):
+        zaznamy nemusi jit casove po sobe (zaznam o zahozeni, preruseni uvnitr LOG()),
+        preteceni Ticks je skok dopredu."""
+        if self.time is None:
+            self.time = ticks
+        else:
+            delta = (ticks - self.time) & ((1 << TIME_BITS) - 1)
+            if delta >= 1 << (TIME_BITS - 1):
+                delta -= 1 << TIME_BITS
+            self.time += delta
+        return self.time / self.tick_hz
+
+    def records(self, payload):
+        words = struct.unpack(f"<{len(payload) // 4}I", payload[:len(payload) // 4 * 4])
+        pos = 0
+        while pos + 2 <= len(words):
+            fmt_id, meta = words[pos], words[pos + 1]
+            nargs = meta >> TIME_BITS
+            args = words[pos + 2:pos + 2 + nargs]
+            pos += 2 + nargs
+            if len(args) != nargs:
+                self.errors += 1
+                break
+
+            fmt = self.formats.get(fmt_id)
+            if fmt is None:
+                fmt = self.elf.string(fmt_id)
+            if fmt is None:
+                text = f"<neznamy format 0x{fmt_id:08X}> " + " ".join(f"0x{a:08X}" for a in args)
+            else:
+                text = render(fmt, args, self.elf)
+            yield self.timestamp(meta & ((1 << TIME_BITS) - 1)), text
+
+    def frame(self, raw):
+        """Jeden ramec bez oddelovace, vraci seznam (cas [s], text)."""
+        if not raw:
+            return []
+        data = cobs_decode(raw)
+        if data is None or len(data) < 4 or zlib.crc32(data[:-4]) != int.from_bytes(data[-4:], "little"):
+            self.errors += 1
+            return []
+        self.frames += 1
+        return list(self.records(data[:-4]))
+
+
+def chunks(args):
+    if args.port:
+        try:
+            import serial
+        except ImportError:
+            sys.exit("Pro --port je potreba pyserial: pip install pyserial")
+        with serial.Serial(args.port, args.baud, timeout=0.1) as port:
+            while True:
+                yield port.read(port.in_waiting or 1)
+    else:
+        stream = sys.stdin.buffer if args.input in (None, "-") else open(args.input, "rb")
+        with stream:
+            while True:
+                data = stream.read(4096)
+                if not data:
+                    return
+                yield data
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Dekoder binarniho logu stm32_kit/log.h")
+    parser.add_argument("elf", help="ELF programu v MCU (.axf/.elf)")
+    parser.add_argument("input", nargs="?", help="zaznam prenosu (- = stdin)")
+    parser.add_argument("--port", help="seriovy port (COM3, /dev/ttyACM0)")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--tick-hz", type=float, default=10000, help="frekvence Ticks (SysTick 0.1 ms = 10000)")
+    parser.add_argument("--list", action="store_true", help="jen vypsat formatovaci retezce z ELF")
+    args = parser.parse_args()
+
+    elf = Elf(args.elf)
+    decoder = Decoder(elf, args.tick_hz)
+    if args.list:
+        for addr, fmt in sorted(decoder.formats.items()):
+            print(f"0x{addr:08X}  {fmt}")
+        return 0
+    if not decoder.formats:
+        print("varovani: ELF nema sekci .logfmt", file=sys.stderr)
+
+    pending = b""
+    try:
+        for data in chunks(args):
+            *frames, pending = (pending + data).split(b"\0")
+            for raw in frames:
+                for when, text in decoder.frame(raw):
+                    print(f"{when:12.4f}  {text}", flush=True)
+    except KeyboardInterrupt:
+        pass
+
+    print(f"ramcu: {decoder.frames}, chyb: {decoder.errors}", file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())